@@ -201,10 +201,12 @@ end translateModel;
     <%if Flags.getConfigBool(Flags.PARMODAUTO) then "#include \"ParModelica/auto/om_pm_interface.hpp\""%>
 
     <%if stringEq(getConfigString(HPCOM_CODE),"pthreads_spin") then "#include \"util/omc_spinlock.h\""%>
+    <%if stringEq(getConfigString(HPCOM_CODE),"pool") then "#include \"util/omc_thread_pool.h\""%>
 
     <%if Flags.isSet(HPCOM) then "#define HPCOM"%>
+    <%if stringEq(getConfigString(HPCOM_CODE),"pool") then "#define HPCOM_POOL"%>
 
-    #if defined(HPCOM) && !defined(_OPENMP)
+    #if defined(HPCOM) && !defined(HPCOM_POOL) && !defined(_OPENMP)
       #error "HPCOM requires OpenMP or the results are wrong"
     #endif
     #if defined(_OPENMP)
@@ -723,6 +725,18 @@ end simulationFile_evt;
 
 template simulationFile_inz(SimCode simCode)
 "Initialization"
+::=
+  simulationFile_inz2(simCode, false)
+end simulationFile_inz;
+
+template simulationFile_inz_glue(SimCode simCode)
+"Initialization without the _part files, those are generated by simulationFile_part"
+::=
+  simulationFile_inz2(simCode, true)
+end simulationFile_inz_glue;
+
+template simulationFile_inz2(SimCode simCode, Boolean separateParts)
+"Initialization"
 ::=
   match simCode
     case simCode as SIMCODE(modelInfo=MODELINFO(varInfo=varInfo as VARINFO(__))) then
@@ -736,7 +750,7 @@ template simulationFile_inz(SimCode simCode)
     #endif
 
     <%functionInitialEquations(initialEquations, listLength(initialEquations), simCode.fileNamePrefix, simCode.fullPathPrefix, modelNamePrefix(simCode),
-      /* initial: only to be treated as first system if there is no lambda_0 system */ intEq(listLength(initialEquations_lambda0), 0))%>
+      /* initial: only to be treated as first system if there is no lambda_0 system */ intEq(listLength(initialEquations_lambda0), 0), separateParts)%>
     <%functionInitialEquations_lambda0(initialEquations_lambda0, modelNamePrefix(simCode))%>
     <%functionRemovedInitialEquations(removedInitialEquations, modelNamePrefix(simCode))%>
 
@@ -749,7 +763,7 @@ template simulationFile_inz(SimCode simCode)
     >>
     /* adrpo: leave a newline at the end of file to get rid of the warning */
   end match
-end simulationFile_inz;
+end simulationFile_inz2;
 
 template simulationFile_dly(SimCode simCode)
 "Delay"
@@ -801,6 +815,18 @@ end simulationFile_spd;
 
 template simulationFile_bnd(SimCode simCode)
 "update bound parameters and variable attributes (start, nominal, min, max)"
+::=
+  simulationFile_bnd2(simCode, false)
+end simulationFile_bnd;
+
+template simulationFile_bnd_glue(SimCode simCode)
+"update bound parameters and variable attributes without the _part files, those are generated by simulationFile_part"
+::=
+  simulationFile_bnd2(simCode, true)
+end simulationFile_bnd_glue;
+
+template simulationFile_bnd2(SimCode simCode, Boolean separateParts)
+"update bound parameters and variable attributes (start, nominal, min, max)"
 ::=
   match simCode
     case simCode as SIMCODE(__) then
@@ -813,7 +839,7 @@ template simulationFile_bnd(SimCode simCode)
 
     <%functionUpdateBoundVariableAttributes(simCode, startValueEquations, nominalValueEquations, minValueEquations, maxValueEquations, modelNamePrefix(simCode))%>
 
-    <%functionUpdateBoundParameters(selectScalarLiteralAssignments(parameterEquations), filterScalarLiteralAssignments(parameterEquations), simCode.fileNamePrefix, simCode.fullPathPrefix, modelNamePrefix(simCode), simCode)%>
+    <%functionUpdateBoundParameters(selectScalarLiteralAssignments(parameterEquations), filterScalarLiteralAssignments(parameterEquations), simCode.fileNamePrefix, simCode.fullPathPrefix, modelNamePrefix(simCode), simCode, separateParts)%>
 
     #if defined(__cplusplus)
     }
@@ -822,7 +848,7 @@ template simulationFile_bnd(SimCode simCode)
     >>
     /* adrpo: leave a newline at the end of file to get rid of the warning */
   end match
-end simulationFile_bnd;
+end simulationFile_bnd2;
 
 template simulationFile_alg(SimCode simCode)
 "Algebraic"
@@ -906,6 +932,42 @@ template simulationFile_jac(SimCode simCode)
   end match
 end simulationFile_jac;
 
+template simulationFile_jac_glue(SimCode simCode)
+"Jacobians, only the file header if the matrices are generated by simulationFile_jac_part"
+::=
+  match simCode
+    case simCode as SIMCODE(__) then
+    if intGt(listLength(SimCodeUtil.jacobianPartition(jacobianMatrixes, Flags.getConfigInt(Flags.EQUATIONS_PER_FILE))), 1) then
+      <<
+      /* Jacobians <%listLength(jacobianMatrixes)%>, see <%fileNamePrefix%>_12jac_part*.c */
+      <%simulationFileHeader(simCode.fileNamePrefix)%>
+      <%\n%>
+      >>
+    else
+      simulationFile_jac(simCode)
+  end match
+end simulationFile_jac_glue;
+
+template simulationFile_jac_part(SimCode simCode, list<JacobianMatrix> partMatrixes, Integer part)
+"The jacobians of one partition of SimCodeUtil.jacobianPartition, generated as a codegen unit of its own.
+ SimCodeMain writes it directly to <fileNamePrefix>_12jac_part<part>.c."
+::=
+  match simCode
+    case simCode as SIMCODE(__) then
+    let () = SimCodeUtil.addFunctionFile('<%fileNamePrefix%>_12jac_part<%part%>.c')
+    <<
+    /* Jacobians <%listLength(partMatrixes)%> */
+    <%simulationFileHeader(simCode.fileNamePrefix)%>
+    #include "<%fileNamePrefix%>_12jac.h"
+    #include "util/jacobian_util.h"
+    <%functionAnalyticJacobians(partMatrixes, modelNamePrefix(simCode))%>
+
+    <%\n%>
+    >>
+    /* adrpo: leave a newline at the end of file to get rid of the warning */
+  end match
+end simulationFile_jac_part;
+
 template simulationFile_jac_header(SimCode simCode)
 "Jacobians"
 ::=
@@ -3318,7 +3380,7 @@ let &sub = buffer ""
   >>
 end functionUpdateBoundVariableAttributes;
 
-template functionUpdateBoundParameters(list<SimEqSystem> simpleParameterEquations, list<SimEqSystem> parameterEquations, String fileNamePrefix, String fullPathPrefix, String modelNamePrefix, SimCode simCode)
+template functionUpdateBoundParameters(list<SimEqSystem> simpleParameterEquations, list<SimEqSystem> parameterEquations, String fileNamePrefix, String fullPathPrefix, String modelNamePrefix, SimCode simCode, Boolean separateParts)
   "Generates function in simulation file."
 ::=
   let &sub = buffer ""
@@ -3326,7 +3388,7 @@ template functionUpdateBoundParameters(list<SimEqSystem> simpleParameterEquation
   let &auxFunction = buffer ""
   let fncalls = functionEquationsMultiFiles(parameterEquations, listLength(parameterEquations),
     Flags.getConfigInt(Flags.EQUATIONS_PER_FILE), fileNamePrefix, fullPathPrefix, modelNamePrefix,
-    "updateBoundParameters", "08bnd", &eqFuncs, /* Static? */ true, true /* No optimization */, /* initial? */ false)
+    "updateBoundParameters", "08bnd", &eqFuncs, /* Static? */ true, true /* No optimization */, /* initial? */ false, separateParts)
   <<
   <%eqFuncs%>
   OMC_DISABLE_OPT
@@ -3350,45 +3412,29 @@ template functionUpdateBoundParameters(list<SimEqSystem> simpleParameterEquation
   >>
 end functionUpdateBoundParameters;
 
-template functionEquationsMultiFiles(list<SimEqSystem> inEqs, Integer numEqs, Integer equationsPerFile, String fileNamePrefix, String fullPathPrefix, String modelNamePrefix, String funcName, String partName, Text &eqFuncs, Boolean static, Boolean noOpt, Boolean init)
+template functionEquationsMultiFiles(list<SimEqSystem> inEqs, Integer numEqs, Integer equationsPerFile, String fileNamePrefix, String fullPathPrefix, String modelNamePrefix, String funcName, String partName, Text &eqFuncs, Boolean static, Boolean noOpt, Boolean init, Boolean separateParts)
+"If separateParts is set, the _part files are not written here but by simulationFile_part,
+ one codegen unit per bucket."
 ::=
   let () = System.tmpTickReset(0)
   let &file = buffer ""
   let multiFile = if intGt(numEqs, equationsPerFile) then "x"
-  let fncalls = (List.balancedPartition(inEqs, equationsPerFile) |> eqs hasindex i0 =>
-                  let name = symbolName(modelNamePrefix,'<%funcName%>_<%i0%>')
+  // Buckets by equation index range keep the file names and contents of the parts before an edited equation stable
+  let fncalls = (SimCodeUtil.stableEqSystemPartition(inEqs, equationsPerFile) |> eqs =>
+                  let bucket = SimCodeUtil.eqSystemBucket(eqs, equationsPerFile)
+                  let name = symbolName(modelNamePrefix,'<%funcName%>_<%bucket%>')
                   let &eqFuncs += 'void <%name%>(DATA *data, threadData_t *threadData);<%\n%>'
 
                   // To file
-                  let &file += ((if multiFile then
-                    (let fileName = addFunctionIndex('<%fileNamePrefix%>_<%partName%>_part', ".c")
-                    redirectToFile(fullPathPrefix + fileName) +
-                  <<
-                  <%simulationFileHeader(fileNamePrefix)%>
-                  #if defined(__cplusplus)
-                  extern "C" {
-                  #endif<%\n%>
-                  >>)) +
-                  (eqs |> eq => equation_impl_options(-1, -1, eq, contextSimulationDiscrete, modelNamePrefix, static, noOpt, init) ; separator="\n") +
-                  <<
-                  <%\n%>
-                  OMC_DISABLE_OPT
-                  void <%name%>(DATA *data, threadData_t *threadData)
-                  {
-                    TRACE_PUSH
-                    <%eqs |> eq => equation_call(eq, modelNamePrefix) %>
-                    TRACE_POP
-                  }
-                  >>
-                  +
-                  (if multiFile then
-                  (<<
-
-                  #if defined(__cplusplus)
-                  }
-                  #endif
-                  >> +
-                  closeFile())))
+                  let &file += (if multiFile then
+                    (let fileName = '<%fileNamePrefix%>_<%partName%>_part<%bucket%>.c'
+                    let () = SimCodeUtil.addFunctionFile(fileName)
+                    if not separateParts then
+                      (redirectToFile(fullPathPrefix + fileName) +
+                      equationsPartFile(eqs, fileNamePrefix, modelNamePrefix, name, static, noOpt, init) +
+                      closeFile()))
+                  else
+                    equationsPart(eqs, modelNamePrefix, name, static, noOpt, init))
 
                    // fncalls
                   '<%name%>(data, threadData);<%\n%>'
@@ -3399,14 +3445,60 @@ template functionEquationsMultiFiles(list<SimEqSystem> inEqs, Integer numEqs, In
   fncalls
 end functionEquationsMultiFiles;
 
-template functionInitialEquations(list<SimEqSystem> initalEquations, Integer numInitialEquations, String fileNamePrefix, String fullPathPrefix, String modelNamePrefix, Boolean init)
+template equationsPartFile(list<SimEqSystem> eqs, String fileNamePrefix, String modelNamePrefix, String name, Boolean static, Boolean noOpt, Boolean init)
+"Contents of a _part file of functionEquationsMultiFiles."
+::=
+  <<
+  <%simulationFileHeader(fileNamePrefix)%>
+  #if defined(__cplusplus)
+  extern "C" {
+  #endif
+  <%equationsPart(eqs, modelNamePrefix, name, static, noOpt, init)%>
+
+  #if defined(__cplusplus)
+  }
+  #endif
+  >>
+end equationsPartFile;
+
+template equationsPart(list<SimEqSystem> eqs, String modelNamePrefix, String name, Boolean static, Boolean noOpt, Boolean init)
+"The equations of one bucket of functionEquationsMultiFiles and the function calling them."
+::=
+  <<
+  <%eqs |> eq => equation_impl_options(-1, -1, eq, contextSimulationDiscrete, modelNamePrefix, static, noOpt, init) ; separator="\n"%>
+
+  OMC_DISABLE_OPT
+  void <%name%>(DATA *data, threadData_t *threadData)
+  {
+    TRACE_PUSH
+    <%eqs |> eq => equation_call(eq, modelNamePrefix) %>
+    TRACE_POP
+  }
+  >>
+end equationsPart;
+
+template simulationFile_part(SimCode simCode, list<SimEqSystem> eqs, Integer bucket, String funcName, Boolean static, Boolean noOpt, Boolean init)
+"One _part file of functionEquationsMultiFiles, generated as a codegen unit of its own.
+ SimCodeMain writes it directly to <fileNamePrefix>_<partName>_part<bucket>.c."
+::=
+  match simCode
+    case simCode as SIMCODE(__) then
+    let () = System.tmpTickReset(0)
+    <<
+    <%equationsPartFile(eqs, simCode.fileNamePrefix, modelNamePrefix(simCode), symbolName(modelNamePrefix(simCode),'<%funcName%>_<%bucket%>'), static, noOpt, init)%>
+    <%\n%>
+    >>
+  end match
+end simulationFile_part;
+
+template functionInitialEquations(list<SimEqSystem> initalEquations, Integer numInitialEquations, String fileNamePrefix, String fullPathPrefix, String modelNamePrefix, Boolean init, Boolean separateParts)
   "Generates function in simulation file."
 ::=
   let () = System.tmpTickReset(0)
   let &eqfuncs = buffer ""
   let fncalls = functionEquationsMultiFiles(initalEquations, numInitialEquations, Flags.getConfigInt(Flags.EQUATIONS_PER_FILE),
                   fileNamePrefix, fullPathPrefix, modelNamePrefix, "functionInitialEquations", "06inz", &eqfuncs, /* not static */ false,
-                  /* do optimize */ false, /* initial */ init)
+                  /* do optimize */ false, /* initial */ init, separateParts)
 
   <<
   <%eqfuncs%>
@@ -3677,6 +3769,10 @@ template functionXXX_system_HPCOM(list<SimEqSystem> derivativEquations, String n
       }
       >>
     case SOME((hpcOmSchedule as LEVELSCHEDULE(__),_,_)) then
+      match type
+      case ("pool") then
+        functionXXX_system_HPCOM_PoolLevels(derivativEquations,name,n,hpcOmSchedule.tasksOfLevels,modelNamePrefixStr)
+      else
       let odeEqs = hpcOmSchedule.tasksOfLevels |> tasks => functionXXX_system0_HPCOM_Level(derivativEquations,name,tasks,type,modelNamePrefixStr); separator="\n"
       <<
       void terminateHpcOmThreads()
@@ -3704,6 +3800,8 @@ template functionXXX_system_HPCOM(list<SimEqSystem> derivativEquations, String n
       let initlocks = hpcOmSchedule.outgoingDepTasks |> task => function_HPCOM_initializeLockByDepTask(task, "lock", type); separator="\n"
       let assignLocks = hpcOmSchedule.outgoingDepTasks |> task => function_HPCOM_assignLockByDepTask(task, "lock", type); separator="\n"
       match type
+        case ("pool") then
+          functionXXX_system_HPCOM_PoolThreads(derivativEquations,name,n,hpcOmSchedule.threadTasks,modelNamePrefixStr)
         case ("openmp") then
           let taskEqs = functionXXX_system0_HPCOM_Thread(derivativEquations,name,hpcOmSchedule.threadTasks, type, modelNamePrefixStr); separator="\n"
           <<
@@ -3859,6 +3957,224 @@ template functionXXX_system_HPCOM(list<SimEqSystem> derivativEquations, String n
 
 end functionXXX_system_HPCOM;
 
+template functionXXX_system_HPCOM_PoolLevels(list<SimEqSystem> derivativEquations, String name, Integer n, list<TaskList> tasksOfLevels, String modelNamePrefixStr)
+ "Level schedule executed by the persistent thread pool of the runtime (--hpcomCode=pool).
+  The tasks of a level are distributed over the pool threads, serial levels run on the calling thread."
+::=
+  let taskIds = tasksOfLevels |> level => function_HPCOM_PoolLevel(level, "ids", derivativEquations, name, modelNamePrefixStr) ; separator=", "
+  if taskIds then
+  let levelSizes = tasksOfLevels |> level => function_HPCOM_PoolLevel(level, "size", derivativEquations, name, modelNamePrefixStr) ; separator=", "
+  let levelSerial = tasksOfLevels |> level => (match level case SERIALTASKLIST(__) then "1" else "0") ; separator=", "
+  let cases = tasksOfLevels |> level => function_HPCOM_PoolLevel(level, "cases", derivativEquations, name, modelNamePrefixStr) ; separator="\n"
+  let nLevels = listLength(tasksOfLevels)
+  <<
+  /* using type: pool */
+  static OMC_THREAD_POOL *hpcom_pool<%n%> = NULL;
+  static const int hpcom_levelSizes<%n%>[<%nLevels%>] = {<%levelSizes%>};
+  static const char hpcom_levelSerial<%n%>[<%nLevels%>] = {<%levelSerial%>};
+  static const int hpcom_levelTasks<%n%>[] = {<%taskIds%>};
+  static int hpcom_levelPtrs<%n%>[<%nLevels%>+1];
+
+  <%function_HPCOM_PoolTasks(name, n, cases)%>
+
+  <%function_HPCOM_PoolTerminate(name, n, modelNamePrefixStr)%>
+
+  void function<%name%>_system<%n%>(DATA *data, threadData_t *threadData)
+  {
+    int i;
+    if (!hpcom_pool<%n%>) {
+      for (i = 0; i < <%nLevels%>; i++) {
+        hpcom_levelPtrs<%n%>[i+1] = hpcom_levelPtrs<%n%>[i] + hpcom_levelSizes<%n%>[i];
+      }
+      hpcom_pool<%n%> = function<%name%>_system<%n%>_newPool(<%Config.noProc()%>);
+      if (!hpcom_pool<%n%>) {
+        throwStreamPrint(threadData, "Failed to create the HpcOm thread pool.");
+      }
+    }
+    hpcom_callerThreadData<%n%> = threadData;
+    if (omc_thread_pool_run_levels(hpcom_pool<%n%>, <%nLevels%>, hpcom_levelPtrs<%n%>, hpcom_levelTasks<%n%>, hpcom_levelSerial<%n%>, function<%name%>_system<%n%>_task, data)) {
+      MMC_THROW_INTERNAL()
+    }
+  }
+  >>
+  else
+  <<
+  void terminateHpcOmThreads()
+  {
+  }
+
+  <%functionXXX_system(derivativEquations,name,n,modelNamePrefixStr)%>
+  >>
+end functionXXX_system_HPCOM_PoolLevels;
+
+template functionXXX_system_HPCOM_PoolThreads(list<SimEqSystem> derivativEquations, String name, Integer n, array<list<Task>> threadTasks, String modelNamePrefixStr)
+ "Thread schedule executed by the persistent thread pool of the runtime (--hpcomCode=pool).
+  Every pool thread runs its task list, incoming dependencies are waited for by spinning on the
+  completion stamp of the source task instead of blocking on the mutexes of the pthreads code."
+::=
+  let ops = arrayList(threadTasks) |> tt => (tt |> task => function_HPCOM_PoolThreadOp(task) ; separator=", ") ; separator=", "
+  if ops then
+  let threadSizes = arrayList(threadTasks) |> tt => listLength(tt) ; separator=", "
+  let cases = arrayList(threadTasks) |> tt => (tt |> task => function_HPCOM_PoolTaskCase(derivativEquations, name, task, modelNamePrefixStr) ; separator="\n") ; separator="\n"
+  let nThreads = arrayLength(threadTasks)
+  <<
+  /* using type: pool */
+  static OMC_THREAD_POOL *hpcom_pool<%n%> = NULL;
+  static const int hpcom_threadSizes<%n%>[<%nThreads%>] = {<%threadSizes%>};
+  static const int hpcom_threadOps<%n%>[] = {<%ops%>};
+  static int hpcom_threadPtrs<%n%>[<%nThreads%>+1];
+  static int hpcom_nTasks<%n%> = 0;
+
+  <%function_HPCOM_PoolTasks(name, n, cases)%>
+
+  <%function_HPCOM_PoolTerminate(name, n, modelNamePrefixStr)%>
+
+  void function<%name%>_system<%n%>(DATA *data, threadData_t *threadData)
+  {
+    int i;
+    if (!hpcom_pool<%n%>) {
+      for (i = 0; i < <%nThreads%>; i++) {
+        hpcom_threadPtrs<%n%>[i+1] = hpcom_threadPtrs<%n%>[i] + hpcom_threadSizes<%n%>[i];
+      }
+      for (i = 0; i < hpcom_threadPtrs<%n%>[<%nThreads%>]; i++) {
+        if (hpcom_threadOps<%n%>[i] >= hpcom_nTasks<%n%>) {
+          hpcom_nTasks<%n%> = hpcom_threadOps<%n%>[i] + 1;
+        }
+      }
+      hpcom_pool<%n%> = function<%name%>_system<%n%>_newPool(<%nThreads%>);
+      if (!hpcom_pool<%n%>) {
+        throwStreamPrint(threadData, "Failed to create the HpcOm thread pool.");
+      }
+    }
+    hpcom_callerThreadData<%n%> = threadData;
+    if (omc_thread_pool_run_lists(hpcom_pool<%n%>, <%nThreads%>, hpcom_threadPtrs<%n%>, hpcom_threadOps<%n%>, hpcom_nTasks<%n%>, function<%name%>_system<%n%>_task, data)) {
+      MMC_THROW_INTERNAL()
+    }
+  }
+  >>
+  else
+  <<
+  void terminateHpcOmThreads()
+  {
+  }
+
+  <%functionXXX_system(derivativEquations,name,n,modelNamePrefixStr)%>
+  >>
+end functionXXX_system_HPCOM_PoolThreads;
+
+template function_HPCOM_PoolLevel(TaskList level, String what, list<SimEqSystem> derivativEquations, String name, String modelNamePrefixStr)
+ "The task numbers, the number of tasks or the task cases of a level of the level schedule."
+::=
+  match level
+    case PARALLELTASKLIST(__)
+    case SERIALTASKLIST(__) then
+      match what
+        case ("ids") then (tasks |> task => function_HPCOM_PoolTaskId(task) ; separator=", ")
+        case ("size") then listLength(tasks)
+        else (tasks |> task => function_HPCOM_PoolTaskCase(derivativEquations, name, task, modelNamePrefixStr) ; separator="\n")
+end function_HPCOM_PoolLevel;
+
+template function_HPCOM_PoolTaskCase(list<SimEqSystem> derivativEquations, String name, Task task, String modelNamePrefixStr)
+::=
+  match task
+    case CALCTASK(__)
+    case CALCTASK_LEVEL(__) then
+      <<
+      case <%function_HPCOM_PoolTaskId(task)%>:
+        <%function_HPCOM_Task(derivativEquations,name,task,"pool",modelNamePrefixStr)%>
+        break;
+      >>
+end function_HPCOM_PoolTaskCase;
+
+template function_HPCOM_PoolTasks(String name, Integer n, Text cases)
+ "The task callback of the thread pool. Every pool thread gets its own threadData when the pool is
+  started, thread 0 is the calling thread and uses the threadData of the caller. A task only sets up
+  its jump buffer."
+::=
+  <<
+  static threadData_t *hpcom_threadData<%n%> = NULL;
+  static threadData_t *hpcom_callerThreadData<%n%> = NULL;
+
+  static void function<%name%>_system<%n%>_init(void *arg, int thread)
+  {
+    threadData_t *threadData = &hpcom_threadData<%n%>[thread];
+    pthread_setspecific(mmc_thread_data_key, threadData);
+    pthread_mutex_init(&threadData->parentMutex, NULL);
+    mmc_init_stackoverflow(threadData);
+  }
+
+  static int function<%name%>_system<%n%>_task(void *arg, int thread, int task)
+  {
+    DATA *data = (DATA*) arg;
+    threadData_t *threadData = thread ? &hpcom_threadData<%n%>[thread] : hpcom_callerThreadData<%n%>;
+    int fail = 1;
+    MMC_TRY_INTERNAL(mmc_jumper)
+    if (thread) {
+      threadData->mmc_stack_overflow_jumper = threadData->mmc_jumper;
+    }
+    switch (task) {
+      <%cases%>
+    }
+    fail = 0;
+    MMC_CATCH_INTERNAL(mmc_jumper)
+    return fail;
+  }
+
+  static OMC_THREAD_POOL* function<%name%>_system<%n%>_newPool(int nThreads)
+  {
+    OMC_THREAD_POOL *pool;
+    hpcom_threadData<%n%> = (threadData_t*) GC_malloc_uncollectable(nThreads * sizeof(threadData_t));
+    if (!hpcom_threadData<%n%>) {
+      return NULL;
+    }
+    memset(hpcom_threadData<%n%>, 0, nThreads * sizeof(threadData_t));
+    pool = omc_thread_pool_new(nThreads, function<%name%>_system<%n%>_init, NULL);
+    if (!pool) {
+      GC_free(hpcom_threadData<%n%>);
+      hpcom_threadData<%n%> = NULL;
+    }
+    return pool;
+  }
+  >>
+end function_HPCOM_PoolTasks;
+
+template function_HPCOM_PoolTerminate(String name, Integer n, String modelNamePrefixStr)
+::=
+  <<
+  void terminateHpcOmThreads()
+  {
+    if (!hpcom_pool<%n%>) {
+      return;
+    }
+    if (measure_time_flag && omc_thread_pool_write_timings(hpcom_pool<%n%>, "<%modelNamePrefixStr%>_hpcom_<%name%>.csv")) {
+      warningStreamPrint(LOG_STDOUT, 0, "Failed to write the HpcOm thread timings to <%modelNamePrefixStr%>_hpcom_<%name%>.csv.");
+    }
+    omc_thread_pool_free(hpcom_pool<%n%>);
+    hpcom_pool<%n%> = NULL;
+    GC_free(hpcom_threadData<%n%>);
+    hpcom_threadData<%n%> = NULL;
+  }
+  >>
+end function_HPCOM_PoolTerminate;
+
+template function_HPCOM_PoolTaskId(Task task)
+ "The task number in the pool schedule: the task index for thread schedules, the first node of the task for level schedules."
+::=
+  match task
+    case CALCTASK(__) then index
+    case CALCTASK_LEVEL(__) then listHead(nodeIdc)
+end function_HPCOM_PoolTaskId;
+
+template function_HPCOM_PoolThreadOp(Task task)
+ "An operation of a pool thread list: run a calculation task or wait for the source task of an incoming dependency.
+  The release of an outgoing dependency is implicit, it is encoded as waiting for its own (finished) source task."
+::=
+  match task
+    case CALCTASK(__) then index
+    case DEPTASK(sourceTask=CALCTASK(index=sourceIdx)) then intNeg(intAdd(sourceIdx, 1))
+    else error(sourceInfo(), 'Unsupported task in the HpcOm thread schedule.')
+end function_HPCOM_PoolThreadOp;
+
 template functionXXX_system0_HPCOM_Level(list<SimEqSystem> derivativEquations, String name, TaskList tasksOfLevel, String iType, String modelNamePrefixStr)
 ::=
   match(tasksOfLevel)
@@ -6521,7 +6837,7 @@ case SIMCODE(modelInfo=MODELINFO(varInfo=varInfo as VARINFO(__)), delayedExps=DE
 
   OFILES=$(CFILES:.c=.o)
   GENERATEDFILES=$(MAINFILE) <%fileNamePrefix%>.makefile <%fileNamePrefix%>_literals.h <%fileNamePrefix%>_functions.h $(CFILES)
-
+  <%objectCacheRule(makefileParams.platform)%>
   .PHONY: omc_main_target clean bundle
 
   # This is to make sure that <%fileNamePrefix%>_*.c are always compiled.
@@ -6543,6 +6859,43 @@ else
   error(sourceInfo(), 'Target <%target%> is not handled!')
 end simulationMakefile;
 
+template objectCacheRule(String platform)
+ "Generates a pattern rule that looks up the objects of the generated files in a
+  cache keyed on a hash of the preprocessed source, the compiler flags and the
+  compiler version. The equations are split into files by equation index range,
+  so the files before the first equation an edit adds or removes are unchanged
+  and taken from the cache; the files after it are compiled again."
+::=
+  if boolOr(boolOr(stringEq(platform, "win32"), stringEq(platform, "win64")), stringEq(Config.simCodeTarget(), "JavaScript")) then ""
+  else
+  <<
+
+  # Object cache for the generated files; define OMC_OBJECT_CACHE env variable to an empty value to disable it
+  # The cache is also disabled if neither sha1sum nor md5sum is found; a 32-bit checksum is too weak as key
+  # The key includes the compiler version, objects of an older compiler are not reused after an upgrade
+  # At most OMC_OBJECT_CACHE_MAX_ENTRIES objects are kept, the least recently used ones are removed
+  OMC_OBJECT_CACHE ?= <%if Testsuite.isRunning() then "" else "$(HOME)/.openmodelica/cache/objects"%>
+  OMC_OBJECT_CACHE_HASH ?= $(firstword $(shell which sha1sum md5sum 2>/dev/null))
+  OMC_OBJECT_CACHE_MAX_ENTRIES ?= 5000
+  ifneq ($(and $(OMC_OBJECT_CACHE),$(OMC_OBJECT_CACHE_HASH)),)
+  %.o: %.c
+  <%\t%>@key=`{ printf '%s\n' $(CC) $(CFLAGS) $(CPPFLAGS); $(CC) --version; $(CC) $(CFLAGS) $(CPPFLAGS) -E -P $< ; } | $(OMC_OBJECT_CACHE_HASH) | tr -dc '0-9a-f'`; \
+  <%\t%>if test -n "$$key" && cp "$(OMC_OBJECT_CACHE)/$$key.o" $@ 2>/dev/null; then \
+  <%\t%>  touch "$(OMC_OBJECT_CACHE)/$$key.o" 2>/dev/null; \
+  <%\t%>  echo "$@ is up to date in $(OMC_OBJECT_CACHE)"; \
+  <%\t%>else \
+  <%\t%>  echo $(CC) $(CFLAGS) $(CPPFLAGS) -c -o $@ $<; \
+  <%\t%>  $(CC) $(CFLAGS) $(CPPFLAGS) -c -o $@ $< || exit 1; \
+  <%\t%>  if test -n "$$key" && mkdir -p "$(OMC_OBJECT_CACHE)" 2>/dev/null; then \
+  <%\t%>    cp $@ "$(OMC_OBJECT_CACHE)/$$key.o.$$$$" && mv -f "$(OMC_OBJECT_CACHE)/$$key.o.$$$$" "$(OMC_OBJECT_CACHE)/$$key.o"; \
+  <%\t%>    (cd "$(OMC_OBJECT_CACHE)" && ls -t | grep '^[0-9a-f]*\.o$$' | sed -e '1,$(OMC_OBJECT_CACHE_MAX_ENTRIES)d' | xargs rm -f) 2>/dev/null; \
+  <%\t%>  fi; \
+  <%\t%>fi
+  endif
+
+  >>
+end objectCacheRule;
+
 template crefM(ComponentRef cr)
  "Generates Modelica equivalent name for component reference."
 ::=
@@ -3881,7 +3881,10 @@ template crefOMSI(ComponentRef cref, Context context)
 ::=
   match cref
   case CREF_IDENT(ident = "time") then
-    "this_function->function_vars->time_value"
+    match context
+    case OMSI_BATCH_CONTEXT(__) then "batch_vars->time_value"
+    else "this_function->function_vars->time_value"
+    end match
   else
     match context
     // cref in default omsi context
@@ -3889,12 +3892,30 @@ template crefOMSI(ComponentRef cref, Context context)
         '<%crefToOMSICStr(cref, hashTable)%>'
     case jacobianContext as JACOBIAN_CONTEXT(jacHT=SOME(hashTable)) then
         '<%crefToOMSICStr(cref, hashTable)%>'
+    // cref in batch of model instances
+    case OMSI_BATCH_CONTEXT(__) then
+        '<%crefToOMSICBatchStr(cref)%>'
     // error case
     else "ERROR in crefOMSI: No valid SimCodeFunction.Context"
     end match
 end crefOMSI;
 
 
+template crefToOMSICBatchStr(ComponentRef cref)
+"Helper function for crefOMSI to generate code for variable access in a
+ structure-of-arrays block, value of instance k is at [vr*n_instances+k]"
+::=
+  match cref2simvar(cref, getSimCode())
+  case v as SIMVAR(__) then
+    let c_comment = '/* <%CodegenUtil.escapeCComments(CodegenUtil.crefStrNoUnderscore(v.name))%> <%CodegenUtil.variabilityString(v.varKind)%> */'
+    let index = getValueReference(v, getSimCode(), false)
+    <<
+    batch_vars-><%crefTypeOMSIC(name)%>[<%index%>*n_instances+k] <%c_comment%>
+    >>
+  end match
+end crefToOMSICBatchStr;
+
+
 template crefToOMSICStr(ComponentRef cref, HashTableCrefSimVar.HashTable hashTable)
 "Helper function for crefOMSI to generate code for variable access"
 ::=
@@ -4447,7 +4468,8 @@ template assertCommonVar(Text condVar, Text msgVar, Context context, Text &varDe
       omc_assert(threadData, info, <%msgVar%>);
     }
     >>
-  case OMSI_CONTEXT(__) then
+  case OMSI_CONTEXT(__)
+  case OMSI_BATCH_CONTEXT(__) then
     <<
     if(!(<%condVar%>))
     {
@@ -4496,7 +4518,8 @@ template contextCref(ComponentRef cr, Context context, Text &preExp, Text &varDe
            /*deactivated case "omsicpp" then crefOMSI(cr, context)*/
           else jacCrefs(cr, context, 0))
 
-  case OMSI_CONTEXT(__) then crefOMSI(cr, context)
+  case OMSI_CONTEXT(__)
+  case OMSI_BATCH_CONTEXT(__) then crefOMSI(cr, context)
   else cref(cr, &sub)
 end contextCref;
 
@@ -5890,7 +5913,8 @@ template daeExpRelationSim(Exp exp, Context context, Text &preExp,
 match exp
 case rel as RELATION(__) then
   match context
-  case OMSI_CONTEXT(__) then
+  case OMSI_CONTEXT(__)
+  case OMSI_BATCH_CONTEXT(__) then
       let e1 = daeExp(rel.exp1, context, &preExp, &varDecls, &auxFunction)
       let e2 = daeExp(rel.exp2, context, &preExp, &varDecls, &auxFunction)
       let res = tempDecl("omsi_bool", &varDecls)
@@ -7757,7 +7781,8 @@ template typeCastContext(Context context, Type ty)
 "Generates code for type cast to basic data types, depending on context."
 ::=
   match context
-    case OMSI_CONTEXT(__) then
+    case OMSI_CONTEXT(__)
+    case OMSI_BATCH_CONTEXT(__) then
       match ty
         case T_INTEGER(__)
         case T_ENUMERATION(__) then "(omsi_int)"
@@ -7778,7 +7803,8 @@ template typeCastContextInt(Context context, Type ty)
 "Generates code for type cast to basic data types, depending on context."
 ::=
   match context
-    case OMSI_CONTEXT(__) then
+    case OMSI_CONTEXT(__)
+    case OMSI_BATCH_CONTEXT(__) then
       match ty
         case T_INTEGER(__)
         case T_ENUMERATION(__) then "(omsi_int)"
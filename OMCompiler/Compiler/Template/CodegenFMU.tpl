@@ -283,6 +283,7 @@ case SIMCODE(__) then
   fmi2ValueReference mapOutputReference2RealOutputDerivatives(const fmi2ValueReference vr);
   fmi2ValueReference mapInitialUnknownsdependentIndex(const fmi2ValueReference vr);
   fmi2ValueReference mapInitialUnknownsIndependentIndex(const fmi2ValueReference vr);
+  fmi2Boolean markOutputsDependingOnInput(ModelInstance* comp, const fmi2ValueReference vr);
   >>
   else
   <<
@@ -335,6 +336,7 @@ case SIMCODE(__) then
   <%mapRealOutputDerivatives(simCode, FMUType)%>
   <%mapInitialUnknownsdependentCrefs(simCode)%>
   <%mapInitialUnknownsIndependentCrefs(simCode)%>
+  <%markOutputsDependingOnInput(simCode)%>
   >>
   else
   <<
@@ -374,6 +376,7 @@ let numberOfRealInputs = varInfo.numRealInputVars
   #define NUMBER_OF_EVENT_INDICATORS <%varInfo.numZeroCrossings%>
   #define NUMBER_OF_REALS <%numberOfReals%>
   #define NUMBER_OF_REAL_INPUTS <%numberOfRealInputs%>
+  #define NUMBER_OF_OUTPUTS <%listLength(vars.outputVars)%>
   #define NUMBER_OF_INTEGERS <%numberOfIntegers%>
   #define NUMBER_OF_STRINGS <%numberOfStrings%>
   #define NUMBER_OF_BOOLEANS <%numberOfBooleans%>
@@ -1243,6 +1246,27 @@ case SIMCODE(modelStructure=SOME(FMIMODELSTRUCTURE(fmiInitialUnknowns=FMIINITIAL
 end match
 end mapInitialUnknownsIndependentCrefs;
 
+template markOutputsDependingOnInput(SimCode simCode)
+ "Generates the function that marks the outputs depending on a Real input as dirty,
+  using the dependencies of ModelStructure/Outputs."
+::=
+  <<
+  /* function marks the outputs depending on the Real input vr as dirty, returns fmi2False if vr is no Real input */
+  fmi2Boolean markOutputsDependingOnInput(ModelInstance* comp, const fmi2ValueReference vr) {
+      switch (vr) {
+        <%getFmiInputOutputDependencies(simCode) |> (name, outputs) =>
+        <<
+        case <%lookupVR(name, simCode)%>:
+          <%outputs |> outputIndex => 'comp->_outputs_dirty[<%outputIndex%>] = fmi2True;' ;separator="\n"%>
+          return fmi2True;
+        >> ;separator="\n"%>
+        default:
+          return fmi2False;
+      }
+  }
+  >>
+end markOutputsDependingOnInput;
+
 template getPlatformString2(String modelNamePrefix, String platform, String fileNamePrefix, String fmuTargetName, String dirExtra, String libsPos1, String libsPos2, String omhome, String FMUVersion)
  "returns compilation commands for the platform. "
 ::=
@@ -1548,6 +1572,7 @@ case SIMCODE(modelInfo=MODELINFO(__), makefileParams=MAKEFILE_PARAMS(__), simula
     ; Experimetnal function for FMI for ModelExchange
     ;****************************************************
     <%fileNamePrefix%>_fmiGetSpecificDerivatives @45
+    <%fileNamePrefix%>_fmiGetPartialJacobian @46
     >> %>
   >>
   else
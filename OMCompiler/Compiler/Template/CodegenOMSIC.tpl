@@ -72,6 +72,10 @@ template generateOMSIC(SimCode simCode)
 
     // generate content of C file
     let functionInitSampleCode = CodegenOMSI_common.functionInitSample(timeEvents, modelNamePrefixStr)
+    let batchFunction = (match omsiData
+      case SOME(OMSI_DATA(simulation=simulation)) then
+        if SimCodeUtil.isOMSIBatchFunction(simulation) then '<%modelNamePrefixStr%>_sim_eqns_batch' else "NULL"
+      else "NULL")
 
     <<
     <%CodegenOMSI_common.insertCopyrightOpenModelica()%>
@@ -88,6 +92,7 @@ template generateOMSIC(SimCode simCode)
       callback->initialize_simulation_problem = <%modelNamePrefixStr%>_sim_eqns_instantiate_allEqns_OMSIFunc;
 
       callback->initialize_samples = <%modelNamePrefixStr%>_instantiate_samples;
+      callback->evaluate_simulation_batch = <%batchFunction%>;
 
       callback->isSet = omsi_true;
     }
@@ -140,6 +140,25 @@ template equationCStr(SimEqSystem eq, Text &varDecls, Text &auxFunction, Context
 end equationCStr;
 
 
+template equationBatchLoop(SimEqSystem eq, Context context)
+ "Generates a loop over all instances of a batch for an equation that is just
+  a simple assignment. Local variables are declared per iteration."
+::=
+  let ix = CodegenUtilSimulation.equationIndex(eq)
+  let &varDecls = buffer ""
+  let &auxFunction = buffer ""
+  let equationCode = equationCStr(eq, &varDecls, &auxFunction, context)
+  <<
+  /* equation index: <%ix%> */
+  for (k = 0; k < n_instances; k++) {
+    <%varDecls%>
+    <%auxFunction%>
+    <%equationCode%>
+  }
+  >>
+end equationBatchLoop;
+
+
 template equationCall(SimEqSystem eq, String modelNamePrefixStr,String modelFunctionnamePrefixStr, String input, String omsiName)
  "Generates call function for evaluating functions."
 ::=
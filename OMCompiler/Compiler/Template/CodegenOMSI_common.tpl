@@ -100,6 +100,7 @@ template generateOmsiFunctionCode(OMSIFunction omsiFunction, String FileNamePref
 
   let initializationCode = generateInitalizationOMSIFunction(omsiFunction, "allEqns", FileNamePrefix,modelFunctionnamePrefixStr, &functionPrototypes, &includes, false, omsiName)
   let _ = generateOmsiFunctionCode_inner(omsiFunction, FileNamePrefix, modelFunctionnamePrefixStr,omsiName, &includes, &evaluationCode, &functionCall, "", &functionPrototypes, omsiName)
+  let batchCode = if stringEq(omsiName, "sim_eqns") then generateOmsiBatchFunction(omsiFunction, FileNamePrefix, omsiName, &functionPrototypes)
 
   // generate header file
   let &functionPrototypes +='omsi_status <%FileNamePrefix%>_<%omsiName%>_allEqns(omsi_function_t* simulation, omsi_values* model_vars_and_params, void* data);<%\n%>'
@@ -145,6 +146,8 @@ template generateOmsiFunctionCode(OMSIFunction omsiFunction, String FileNamePref
       return status;
     }
 
+    <%batchCode%>
+
     #if defined(__cplusplus)
     }
     #endif
@@ -154,6 +157,32 @@ template generateOmsiFunctionCode(OMSIFunction omsiFunction, String FileNamePref
 end generateOmsiFunctionCode;
 
 
+template generateOmsiBatchFunction(OMSIFunction omsiFunction, String FileNamePrefix, String omsiName, Text &functionPrototypes)
+"Generates a function evaluating all equations of omsiFunction for a structure-of-arrays
+ block of model instances, with the loop over instances innermost in every equation.
+ Only generated if SimCodeUtil.isOMSIBatchFunction holds, otherwise the model has no
+ batch function and evaluate_simulation_batch is NULL."
+::=
+  match omsiFunction
+  case OMSI_FUNCTION(__) then
+    if SimCodeUtil.isOMSIBatchFunction(omsiFunction) then
+      let &functionPrototypes += 'omsi_status <%FileNamePrefix%>_<%omsiName%>_batch(omsi_values* batch_vars, omsi_unsigned_int n_instances);<%\n%>'
+      let equationLoops = (equations |> eq => CodegenOMSIC_Equations.equationBatchLoop(eq, contextOMSIBatch) ;separator="\n")
+      <<
+      /* Equations evaluation for a batch of instances */
+      omsi_status <%FileNamePrefix%>_<%omsiName%>_batch(omsi_values* batch_vars, omsi_unsigned_int n_instances){
+
+        /* Variables */
+        omsi_unsigned_int k;
+
+        <%equationLoops%>
+
+        return omsi_ok;
+      }
+      >>
+end generateOmsiBatchFunction;
+
+
 template lastIdentOfPath(Path modelName)
 "Helper function. Returns last ident of given path."
 ::=
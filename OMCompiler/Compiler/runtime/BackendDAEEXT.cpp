@@ -53,8 +53,6 @@ static std::set<int> e_mark;
 static std::set<int> differentiated_mark;
 static std::set<int> v_mark;
 
-static std::vector<int> number;
-static std::vector<int> lowlink;
 static std::vector<int> v;
 static std::vector<int> f;
 
@@ -138,48 +136,6 @@ void* BackendDAEEXTImpl__getMarkedVariables()
   return res;
 }
 
-void BackendDAEEXTImpl__initLowLink(int nvars)
-{
-  //cout << "init lowlink n= " << nvars << endl;
-  lowlink.reserve(nvars);
-
-  while (lowlink.size() < (unsigned int)nvars)
-    lowlink.push_back(0);
-  for (int i =0; i < nvars; i++)
-    lowlink[i]=0;
-}
-
-void BackendDAEEXTImpl__initNumber(int nvars)
-{
-  //cout << "init number n= " << nvars << endl;
-  number.reserve(nvars);
-
-  while (number.size() < (unsigned int)nvars)
-    number.push_back(0);
-  for (int i =0; i < nvars; i++)
-    number[i]=0;
-}
-
-void BackendDAEEXTImpl__setLowLink(int i, int val)
-{
-  lowlink[i-1]=val;
-}
-
-void BackendDAEEXTImpl__setNumber(int i, int val)
-{
-  number[i-1]=val;
-}
-
-int BackendDAEEXTImpl__getNumber(int i)
-{
-  return number[i-1];
-}
-
-int BackendDAEEXTImpl__getLowLink(int i)
-{
-  return lowlink[i-1];
-}
-
 void BackendDAEEXTImpl__dumpMarkedEquations(int nvars)
 {
   cout << "marked equations" << endl << "================" << endl;
@@ -44,6 +44,8 @@
 #include "BackendDAEEXT.cpp"
 #include <stdlib.h>
 #include "errorext.h"
+#include "sparsity.h"
+#include "tarjan.h"
 
 extern "C" {
 
@@ -67,42 +69,18 @@ extern void* BackendDAEEXT_getDifferentiatedEqns()
 {
   return BackendDAEEXTImpl__getDifferentiatedEqns();
 }
-extern int BackendDAEEXT_getLowLink(int _inInteger)
-{
-  return BackendDAEEXTImpl__getLowLink(_inInteger);
-}
 extern void* BackendDAEEXT_getMarkedVariables()
 {
   return BackendDAEEXTImpl__getMarkedVariables();
 }
-extern int BackendDAEEXT_getNumber(int _inInteger)
-{
-  return BackendDAEEXTImpl__getNumber(_inInteger);
-}
-extern void BackendDAEEXT_setNumber(int _inInteger1, int _inInteger2)
-{
-  BackendDAEEXTImpl__setNumber(_inInteger1, _inInteger2);
-}
 extern void BackendDAEEXT_initMarks(int _inInteger1, int _inInteger2)
 {
   BackendDAEEXTImpl__initMarks(_inInteger1, _inInteger2);
 }
-extern void BackendDAEEXT_initLowLink(int _inInteger)
-{
-  BackendDAEEXTImpl__initLowLink(_inInteger);
-}
 extern void BackendDAEEXT_markDifferentiated(int _inInteger)
 {
   BackendDAEEXTImpl__markDifferentiated(_inInteger);
 }
-extern void BackendDAEEXT_initNumber(int _inInteger)
-{
-  BackendDAEEXTImpl__initNumber(_inInteger);
-}
-extern void BackendDAEEXT_setLowLink(int _inInteger1, int _inInteger2)
-{
-  BackendDAEEXTImpl__setLowLink(_inInteger1, _inInteger2);
-}
 extern void BackendDAEEXT_vMark(int _inInteger)
 {
   BackendDAEEXTImpl__vMark(_inInteger);
@@ -220,4 +198,264 @@ extern int BackendDAEEXT_setAssignment(int lenass1, int lenass2, modelica_metaty
   return 1;
 }
 
+
+/* Converts a list<list<Integer>> (or array<list<Integer>>) with one-based
+ * indices into zero-based CSR arrays. Non-positive entries are skipped.
+ * Returns the number of rows or -1 if out of memory, then nothing is
+ * allocated. */
+static int listsToCSR(modelica_metatype lsts, int isArray, int **ptrs, int **ids)
+{
+  int n = 0, nnz = 0, i = 0, j = 0;
+  modelica_metatype lst, l;
+
+  if (isArray) {
+    n = MMC_HDRSLOTS(MMC_GETHDR(lsts));
+    for (i = 0; i < n; i++) {
+      for (l = MMC_STRUCTDATA(lsts)[i]; !listEmpty(l); l = MMC_CDR(l)) nnz++;
+    }
+  } else {
+    for (lst = lsts; !listEmpty(lst); lst = MMC_CDR(lst), n++) {
+      for (l = MMC_CAR(lst); !listEmpty(l); l = MMC_CDR(l)) nnz++;
+    }
+  }
+  *ptrs = (int*) malloc((n+1) * sizeof(int));
+  *ids = (int*) malloc((nnz+1) * sizeof(int));
+  if (!*ptrs || !*ids) {
+    free(*ptrs); free(*ids);
+    *ptrs = *ids = NULL;
+    return -1;
+  }
+  lst = lsts;
+  for (i = 0; i < n; i++) {
+    (*ptrs)[i] = j;
+    if (isArray) {
+      l = MMC_STRUCTDATA(lsts)[i];
+    } else {
+      l = MMC_CAR(lst);
+      lst = MMC_CDR(lst);
+    }
+    for (; !listEmpty(l); l = MMC_CDR(l)) {
+      mmc_sint_t v = MMC_UNTAGFIXNUM(MMC_CAR(l));
+      if (v > 0) {
+        (*ids)[j++] = (int)v-1;
+      }
+    }
+  }
+  (*ptrs)[n] = j;
+  return n;
+}
+
+extern modelica_metatype BackendDAEEXT_sparsityPattern(modelica_metatype adjacency, modelica_integer nVars, modelica_metatype compEqns, modelica_metatype compVars, modelica_integer offset, modelica_metatype rows)
+{
+  int *adj_ptrs, *adj_ids, *comp_eqn_ptrs, *comp_eqns, *comp_var_ptrs, *comp_vars;
+  int *pattern_ptrs, *pattern_ids, *row_ids;
+  int nEqns, nComps, nVarComps, nRows = 0, nnz, i, j;
+  modelica_metatype res, l;
+
+  nEqns = listsToCSR(adjacency, 1, &adj_ptrs, &adj_ids);
+  nComps = listsToCSR(compEqns, 0, &comp_eqn_ptrs, &comp_eqns);
+  nVarComps = listsToCSR(compVars, 0, &comp_var_ptrs, &comp_vars);
+  for (l = rows; !listEmpty(l); l = MMC_CDR(l)) nRows++;
+  row_ids = (int*) malloc((nRows+1) * sizeof(int));
+  if (row_ids) {
+    for (i = 0, l = rows; !listEmpty(l); l = MMC_CDR(l), i++) {
+      row_ids[i] = (int)MMC_UNTAGFIXNUM(MMC_CAR(l))-1;
+    }
+  }
+
+  if (nEqns < 0 || nComps < 0 || nVarComps < 0 || !row_ids) {
+    nnz = -1;
+  } else {
+    nnz = sparsity_pattern(nEqns, nVars, adj_ptrs, adj_ids, nComps, comp_eqn_ptrs, comp_eqns,
+                           comp_var_ptrs, comp_vars, offset, nRows, row_ids, &pattern_ptrs, &pattern_ids);
+  }
+  free(adj_ptrs); free(adj_ids);
+  free(comp_eqn_ptrs); free(comp_eqns);
+  free(comp_var_ptrs); free(comp_vars);
+  free(row_ids);
+  if (nnz < 0) {
+    c_add_message(NULL,-1,ErrorType_symbolic,ErrorLevel_internal,"BackendDAEEXT.sparsityPattern failed: out of memory",NULL,0);
+    MMC_THROW();
+  }
+
+  res = arrayCreate(nRows, mmc_mk_nil());
+  for (i = 0; i < nRows; i++) {
+    l = mmc_mk_nil();
+    for (j = pattern_ptrs[i+1]-1; j >= pattern_ptrs[i]; j--) {
+      l = mmc_mk_cons(mmc_mk_icon(pattern_ids[j]+1), l);
+    }
+    MMC_STRUCTDATA(res)[i] = l;
+  }
+  free(pattern_ptrs);
+  free(pattern_ids);
+  return res;
+}
+
+extern modelica_metatype BackendDAEEXT_sparsityColoring(modelica_metatype sparsePattern, modelica_integer nCols, modelica_integer ordering)
+{
+  int *row_ptrs, *row_ids, *col_ptrs, *col_ids, *colors;
+  int nRows, nColors, i, j, k;
+  modelica_metatype res;
+
+  nRows = listsToCSR(sparsePattern, 1, &row_ptrs, &row_ids);
+  col_ptrs = (int*) calloc(nCols+2, sizeof(int));
+  col_ids = (int*) malloc(((nRows < 0 ? 0 : row_ptrs[nRows])+1) * sizeof(int));
+  colors = (int*) malloc((nCols+1) * sizeof(int));
+
+  if (nRows < 0 || !col_ptrs || !col_ids || !colors) {
+    nColors = -1;
+  } else {
+    /* transpose */
+    for (k = 0; k < row_ptrs[nRows]; k++) col_ptrs[row_ids[k]+2]++;
+    for (j = 0; j < nCols; j++) col_ptrs[j+2] += col_ptrs[j+1];
+    for (i = 0; i < nRows; i++) {
+      for (k = row_ptrs[i]; k < row_ptrs[i+1]; k++) {
+        col_ids[col_ptrs[row_ids[k]+1]++] = i;
+      }
+    }
+    nColors = sparsity_color_d2(nCols, row_ptrs, row_ids, col_ptrs, col_ids, ordering, colors);
+  }
+  free(row_ptrs); free(row_ids);
+  free(col_ptrs); free(col_ids);
+  if (nColors < 0) {
+    free(colors);
+    c_add_message(NULL,-1,ErrorType_symbolic,ErrorLevel_internal,"BackendDAEEXT.sparsityColoring failed: out of memory",NULL,0);
+    MMC_THROW();
+  }
+
+  /* columns of each color in descending order, as the lists are built by prepending */
+  res = arrayCreate(nColors, mmc_mk_nil());
+  for (j = 0; j < nCols; j++) {
+    MMC_STRUCTDATA(res)[colors[j]-1] = mmc_mk_cons(mmc_mk_icon(j+1), MMC_STRUCTDATA(res)[colors[j]-1]);
+  }
+  free(colors);
+  return res;
+}
+
+/* Runs tarjan_scc and converts the components to list<list<Integer>> with
+ * one-based indices. The components are returned in the order they are
+ * completed or, with reverse set, in the opposite order. */
+static modelica_metatype tarjanComponents(int n, int *succ_ptrs, int *succ_ids, int nRoots, int *roots, int reverse)
+{
+  int *comp_ptrs, *comp_nodes;
+  int nComps, c, k;
+  modelica_metatype res = mmc_mk_nil(), comp;
+
+  comp_ptrs = (int*) malloc((n+1) * sizeof(int));
+  comp_nodes = (int*) malloc((n+1) * sizeof(int));
+  nComps = (comp_ptrs && comp_nodes) ? tarjan_scc(n, succ_ptrs, succ_ids, nRoots, roots, comp_ptrs, comp_nodes) : -1;
+  free(succ_ptrs); free(succ_ids); free(roots);
+  if (nComps < 0) {
+    free(comp_ptrs); free(comp_nodes);
+    c_add_message(NULL,-1,ErrorType_symbolic,ErrorLevel_internal,"BackendDAEEXT.tarjan failed: out of memory",NULL,0);
+    MMC_THROW();
+  }
+
+  for (c = reverse ? 0 : nComps-1; reverse ? c < nComps : c >= 0; c += reverse ? 1 : -1) {
+    comp = mmc_mk_nil();
+    for (k = comp_ptrs[c+1]-1; k >= comp_ptrs[c]; k--) {
+      comp = mmc_mk_cons(mmc_mk_icon(comp_nodes[k]+1), comp);
+    }
+    res = mmc_mk_cons(comp, res);
+  }
+  free(comp_ptrs); free(comp_nodes);
+  return res;
+}
+
+static void tarjanIndexError(int *succ_ptrs, int *succ_ids, int *roots)
+{
+  free(succ_ptrs); free(succ_ids); free(roots);
+  c_add_message(NULL,-1,ErrorType_symbolic,ErrorLevel_internal,"BackendDAEEXT.tarjan failed: adjacency matrix and matching do not fit",NULL,0);
+  MMC_THROW();
+}
+
+extern modelica_metatype BackendDAEEXT_tarjan(modelica_metatype m, modelica_metatype ass1)
+{
+  int n = MMC_HDRSLOTS(MMC_GETHDR(m)), nVars = MMC_HDRSLOTS(MMC_GETHDR(ass1));
+  int *succ_ptrs, *succ_ids, *roots;
+  int i, nnz = 0, nRoots = 0;
+  mmc_sint_t var, eqn;
+  modelica_metatype l;
+
+  for (i = 0; i < n; i++) {
+    for (l = MMC_STRUCTDATA(m)[i]; !listEmpty(l); l = MMC_CDR(l)) nnz++;
+  }
+  succ_ptrs = (int*) malloc((n+1) * sizeof(int));
+  succ_ids = (int*) malloc((nnz+1) * sizeof(int));
+  roots = (int*) malloc((nVars+1) * sizeof(int));
+  if (!succ_ptrs || !succ_ids || !roots) {
+    free(succ_ptrs); free(succ_ids); free(roots);
+    c_add_message(NULL,-1,ErrorType_symbolic,ErrorLevel_internal,"BackendDAEEXT.tarjan failed: out of memory",NULL,0);
+    MMC_THROW();
+  }
+
+  /* equation i depends on the equations solving the variables it contains */
+  nnz = 0;
+  for (i = 0; i < n; i++) {
+    succ_ptrs[i] = nnz;
+    for (l = MMC_STRUCTDATA(m)[i]; !listEmpty(l); l = MMC_CDR(l)) {
+      var = MMC_UNTAGFIXNUM(MMC_CAR(l));
+      if (var <= 0) continue;
+      if (var > nVars) tarjanIndexError(succ_ptrs, succ_ids, roots);
+      eqn = MMC_UNTAGFIXNUM(MMC_STRUCTDATA(ass1)[var-1]);
+      if (eqn > n) tarjanIndexError(succ_ptrs, succ_ids, roots);
+      if (eqn > 0 && eqn != i+1) succ_ids[nnz++] = (int)eqn-1;
+    }
+  }
+  succ_ptrs[n] = nnz;
+
+  for (i = 0; i < nVars; i++) {
+    eqn = MMC_UNTAGFIXNUM(MMC_STRUCTDATA(ass1)[i]);
+    if (eqn > n) tarjanIndexError(succ_ptrs, succ_ids, roots);
+    if (eqn > 0) roots[nRoots++] = (int)eqn-1;
+  }
+
+  return tarjanComponents(n, succ_ptrs, succ_ids, nRoots, roots, 0);
+}
+
+extern modelica_metatype BackendDAEEXT_tarjanTransposed(modelica_metatype mT, modelica_metatype ass2)
+{
+  int n = MMC_HDRSLOTS(MMC_GETHDR(ass2)), nVars = MMC_HDRSLOTS(MMC_GETHDR(mT));
+  int *succ_ptrs, *succ_ids, *roots;
+  int i, nnz = 0, nRoots = 0;
+  mmc_sint_t var, eqn;
+  modelica_metatype l;
+
+  for (i = 0; i < n; i++) {
+    var = MMC_UNTAGFIXNUM(MMC_STRUCTDATA(ass2)[i]);
+    if (var > nVars) {
+      c_add_message(NULL,-1,ErrorType_symbolic,ErrorLevel_internal,"BackendDAEEXT.tarjanTransposed failed: adjacency matrix and matching do not fit",NULL,0);
+      MMC_THROW();
+    }
+    if (var > 0) {
+      for (l = MMC_STRUCTDATA(mT)[var-1]; !listEmpty(l); l = MMC_CDR(l)) nnz++;
+    }
+  }
+  succ_ptrs = (int*) malloc((n+1) * sizeof(int));
+  succ_ids = (int*) malloc((nnz+1) * sizeof(int));
+  roots = (int*) malloc((n+1) * sizeof(int));
+  if (!succ_ptrs || !succ_ids || !roots) {
+    free(succ_ptrs); free(succ_ids); free(roots);
+    c_add_message(NULL,-1,ErrorType_symbolic,ErrorLevel_internal,"BackendDAEEXT.tarjanTransposed failed: out of memory",NULL,0);
+    MMC_THROW();
+  }
+
+  /* the equations containing the variable solved by equation i depend on i */
+  nnz = 0;
+  for (i = 0; i < n; i++) {
+    succ_ptrs[i] = nnz;
+    var = MMC_UNTAGFIXNUM(MMC_STRUCTDATA(ass2)[i]);
+    if (var <= 0) continue;
+    roots[nRoots++] = i;
+    for (l = MMC_STRUCTDATA(mT)[var-1]; !listEmpty(l); l = MMC_CDR(l)) {
+      eqn = MMC_UNTAGFIXNUM(MMC_CAR(l));
+      if (eqn > n) tarjanIndexError(succ_ptrs, succ_ids, roots);
+      if (eqn > 0 && eqn != i+1) succ_ids[nnz++] = (int)eqn-1;
+    }
+  }
+  succ_ptrs[n] = nnz;
+
+  return tarjanComponents(n, succ_ptrs, succ_ids, nRoots, roots, 1);
+}
+
 }
@@ -34,7 +34,10 @@ typedef struct {
   time_t mtime;
   ModelicaMatReader matReader;
   FILE *pltReader;
-  struct csv_data *csvReader;
+  struct csv_stream *csvReader; /* only the header; datasets are read with a column projection */
+  int csvSize;
+  struct csv_data *csvData;     /* columns read so far */
+  int csvAllColumns;            /* csvData holds all columns of the file */
 } SimulationResult_Globals;
 
 static SimulationResult_Globals simresglob = {
@@ -47,7 +50,12 @@ static void SimulationResultsImpl__close(SimulationResult_Globals* simresglob)
   switch (simresglob->curFormat) {
   case MATLAB4: omc_free_matlab4_reader(&simresglob->matReader); break;
   case PLT: fclose(simresglob->pltReader); break;
-  case CSV: omc_free_csv_reader(simresglob->csvReader); simresglob->csvReader=NULL; break;
+  case CSV:
+    read_csv_stream_close(simresglob->csvReader);
+    simresglob->csvReader=NULL;
+    if (simresglob->csvData) omc_free_csv_reader(simresglob->csvData);
+    simresglob->csvData=NULL;
+    break;
   default: break;
   }
   simresglob->curFormat = UNKNOWN_PLOT;
@@ -97,7 +105,10 @@ static PlotFormat SimulationResultsImpl__openFile(const char *filename, Simulati
     }
     break;
   case CSV:
-    simresglob->csvReader = read_csv(filename);
+    simresglob->csvReader = read_csv_stream_open(filename);
+    simresglob->csvSize = -1;
+    simresglob->csvData = NULL;
+    simresglob->csvAllColumns = 0;
     if (simresglob->csvReader==NULL) {
       msg[1] = filename;
       c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("Failed to open simulation result %s: %s"), msg, 2);
@@ -212,7 +223,11 @@ static int SimulationResultsImpl__readSimulationResultSize(const char *filename,
     return size;
   }
   case CSV: {
-    size = simresglob->csvReader ? simresglob->csvReader->numsteps : -1;
+    if (simresglob->csvSize == -1 && simresglob->csvReader) {
+      /* nothing is selected, so this only counts the rows */
+      simresglob->csvSize = read_csv_stream_read(simresglob->csvReader, 1);
+    }
+    size = simresglob->csvSize;
     msg[0] = filename;
     if (size == -1) c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("Failed to read readSimulationResultSize from file: %s\n"), msg, 1);
     return size;
@@ -309,6 +324,61 @@ static void* SimulationResultsImpl__readVarsFilterAliases(const char *filename,
   }
 }
 
+/* Makes sure the columns vars of a csv file are in simresglob->csvData.
+ * The first call only reads the requested columns, unless readAll is set.
+ * If a later call needs other columns, all columns are read in one pass, so
+ * that reading the variables one by one does not parse the file once per
+ * variable. Returns 0 if the file could not be read.
+ */
+static int SimulationResultsImpl__readCsvColumns(const char *filename, void *vars, int readAll, SimulationResult_Globals* simresglob)
+{
+  struct csv_data *csvData;
+  const char **columns;
+  int i, ncolumns;
+  void *lst;
+
+  if (simresglob->csvData) {
+    if (simresglob->csvAllColumns) {
+      return 1;
+    }
+    for (lst = vars; MMC_NILHDR != MMC_GETHDR(lst); lst = MMC_CDR(lst)) {
+      if (!read_csv_dataset(simresglob->csvData, MMC_STRINGDATA(MMC_CAR(lst)))) {
+        break;
+      }
+    }
+    if (MMC_NILHDR == MMC_GETHDR(lst)) {
+      return 1;
+    }
+    readAll = 1;
+  }
+
+  if (readAll) {
+    /* the header of the cached reader has all column names */
+    ncolumns = simresglob->csvReader->numvars;
+    columns = (const char**) simresglob->csvReader->variables;
+    csvData = read_csv_columns(filename, columns, ncolumns);
+  } else {
+    ncolumns = listLength(vars);
+    columns = (const char**) malloc(sizeof(char*)*(ncolumns ? ncolumns : 1));
+    lst = vars;
+    for (i=0; i<ncolumns; i++) {
+      columns[i] = MMC_STRINGDATA(MMC_CAR(lst));
+      lst = MMC_CDR(lst);
+    }
+    csvData = read_csv_columns(filename, columns, ncolumns);
+    free(columns);
+  }
+  if (!csvData) {
+    return 0;
+  }
+  if (simresglob->csvData) {
+    omc_free_csv_reader(simresglob->csvData);
+  }
+  simresglob->csvData = csvData;
+  simresglob->csvAllColumns = readAll;
+  return 1;
+}
+
 static void* SimulationResultsImpl__readDataset(const char *filename, void *vars, int dimsize, int suggestReadAllVars, SimulationResult_Globals* simresglob, int runningTestsuite)
 {
   const char *msg[2] = {"",""};
@@ -359,10 +429,15 @@ static void* SimulationResultsImpl__readDataset(const char *filename, void *vars
     return read_ptolemy_dataset(filename,vars,dimsize);
   }
   case CSV: {
+    if (!SimulationResultsImpl__readCsvColumns(filename, vars, suggestReadAllVars, simresglob)) {
+      msg[0] = runningTestsuite ? SystemImpl__basename(filename) : filename;
+      c_add_message(NULL,-1, ErrorType_scripting, ErrorLevel_error, gettext("Failed to read simulation result %s."), msg, 1);
+      return NULL;
+    }
     while (MMC_NILHDR != MMC_GETHDR(vars)) {
       var = MMC_STRINGDATA(MMC_CAR(vars));
       vars = MMC_CDR(vars);
-      vals = simresglob->csvReader ? read_csv_dataset(simresglob->csvReader,var) : NULL;
+      vals = read_csv_dataset(simresglob->csvData,var);
       if (vals == NULL) {
         msg[0] = runningTestsuite ? SystemImpl__basename(filename) : filename;
         msg[1] = var;
@@ -140,6 +140,22 @@ extern int System_realtimeNtick(int ix)
   return rt_ncall(ix);
 }
 
+static rtclock_t System_realtimeStart;
+static pthread_once_t System_realtimeOnce = PTHREAD_ONCE_INIT;
+
+static void System_realtimeInit(void)
+{
+  rt_ext_tp_tick_realtime(&System_realtimeStart);
+}
+
+/* Wall-clock time since the first call; unlike the indexed clocks above it
+ * keeps no shared tick state and can be used from parallel tasks */
+extern double System_realtime(void)
+{
+  pthread_once(&System_realtimeOnce, System_realtimeInit);
+  return rt_ext_tp_tock_realtime(&System_realtimeStart);
+}
+
 extern const char* System_getCCompiler()
 {
   return cc;
@@ -855,6 +871,68 @@ extern int System_fileIsNewerThan(const char *file1, const char *file2)
   return res;
 }
 
+/* Two independent 64-bit FNV-1a hashes (different offset bases), giving a
+ * 128-bit content hash. Not cryptographic; used as cache key. */
+typedef struct {
+  unsigned long long h1;
+  unsigned long long h2;
+} content_hash;
+
+static void content_hash_init(content_hash *h)
+{
+  h->h1 = 14695981039346656037ULL;
+  h->h2 = 0x6c62272e07bb0142ULL;
+}
+
+static void content_hash_update(content_hash *h, const unsigned char *data, size_t len)
+{
+  unsigned long long h1 = h->h1, h2 = h->h2;
+  size_t i;
+  for (i = 0; i < len; i++) {
+    h1 = (h1 ^ data[i]) * 1099511628211ULL;
+    h2 = (h2 ^ data[i]) * 1099511628211ULL;
+    h2 ^= h2 >> 29;
+  }
+  h->h1 = h1;
+  h->h2 = h2;
+}
+
+static char* content_hash_string(content_hash *h)
+{
+  char buf[33];
+  snprintf(buf, 33, "%016llx%016llx", h->h1, h->h2);
+  return omc_alloc_interface.malloc_strdup(buf);
+}
+
+extern const char* System_stringContentHash(const char *str)
+{
+  content_hash h;
+  content_hash_init(&h);
+  content_hash_update(&h, (const unsigned char*) str, strlen(str));
+  return content_hash_string(&h);
+}
+
+extern const char* System_fileContentHash(const char *filename)
+{
+  unsigned char buf[65536];
+  size_t n;
+  content_hash h;
+  FILE *file = omc_fopen(filename, "rb");
+  if (file == NULL) {
+    MMC_THROW();
+  }
+  content_hash_init(&h);
+  while ((n = fread(buf, 1, sizeof(buf), file)) > 0) {
+    content_hash_update(&h, buf, n);
+  }
+  if (ferror(file)) {
+    fclose(file);
+    MMC_THROW();
+  }
+  fclose(file);
+  return content_hash_string(&h);
+}
+
 typedef void* voidp;
 
 /* Work in progress: Threading support in OMC */
@@ -900,7 +978,7 @@ static void* System_launchParallelTasksSerial(threadData_t *threadData, void *da
     result = mmc_mk_cons(fn(threadData, MMC_CAR(dataLst)),result);
     dataLst = MMC_CDR(dataLst);
   }
-  return listReverse(dataLst);
+  return listReverse(result);
 }
 
 extern void* System_launchParallelTasks(threadData_t *threadData, int numThreads, void *dataLst, modelica_metatype (*fn)(threadData_t *,modelica_metatype))
@@ -953,7 +1031,8 @@ extern void* System_launchParallelTasks(threadData_t *threadData, int numThreads
 
   if (len == 0) {
     return mmc_mk_nil();
-  } else if (numThreads == 1 || len == 1) {
+  } else if (numThreads == 1 || len == 1 || omc_region_is_active()) {
+    /* Worker threads would allocate outside of the region of this thread */
     return System_launchParallelTasksSerial(threadData,dataLst,fn);
   }
 
@@ -0,0 +1,387 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+
+/*
+ * file:        sparsity.c
+ * description: Sparsity pattern propagation and distance-2 coloring of Jacobians
+ *              on compressed (CSR) arrays, see sparsity.h.
+ *
+ *              The orderings for the coloring follow
+ *              "A. H. Gebremedhin, F. Manne and A. Pothen.
+ *              'What Color Is Your Jacobian? Graph Coloring for Computing Derivatives'
+ *              SIAM Review 47(4), 2005."
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "sparsity.h"
+
+static int compareInt(const void *a, const void *b)
+{
+  int x = *(const int*)a, y = *(const int*)b;
+  return (x > y) - (x < y);
+}
+
+int sparsity_pattern(int n_eqns, int n_vars, const int *adj_ptrs, const int *adj_ids,
+                     int n_comps, const int *comp_eqn_ptrs, const int *comp_eqns,
+                     const int *comp_var_ptrs, const int *comp_vars,
+                     int first_independent, int n_rows, const int *rows,
+                     int **pattern_ptrs, int **pattern_ids)
+{
+  int c, i, j, k, e, v, d, nnz;
+  int n_independent = n_vars > first_independent ? n_vars - first_independent : 0;
+  int *eqn_comp = (int*) malloc((n_eqns+1) * sizeof(int));
+  int *var_comp = (int*) malloc((n_vars+1) * sizeof(int));
+  int *mark = (int*) malloc((n_vars+1) * sizeof(int));
+  int *pat_ptrs = (int*) malloc((n_comps+1) * sizeof(int));
+  int pat_size = 0, pat_capacity = n_independent + 16;
+  int *pat = (int*) malloc(pat_capacity * sizeof(int));
+  int *out_ptrs = NULL, *out_ids = NULL;
+
+  if (!eqn_comp || !var_comp || !mark || !pat_ptrs || !pat) {
+    nnz = -1;
+    goto done;
+  }
+  for (i = 0; i < n_eqns; i++) eqn_comp[i] = -1;
+  for (i = 0; i < n_vars; i++) { var_comp[i] = -1; mark[i] = -1; }
+
+  /* pattern of each component: the union of the independent variables of its
+   * equations and of the patterns of the components solving their inputs */
+  pat_ptrs[0] = 0;
+  for (c = 0; c < n_comps; c++) {
+    /* a component depends at most on all independent variables */
+    if (pat_size + n_independent > pat_capacity) {
+      int *tmp;
+      pat_capacity = 2*pat_capacity + n_independent;
+      tmp = (int*) realloc(pat, pat_capacity * sizeof(int));
+      if (!tmp) {
+        nnz = -1;
+        goto done;
+      }
+      pat = tmp;
+    }
+    for (i = comp_var_ptrs[c]; i < comp_var_ptrs[c+1]; i++) {
+      v = comp_vars[i];
+      if (v >= 0 && v < n_vars) var_comp[v] = c;
+    }
+    for (i = comp_eqn_ptrs[c]; i < comp_eqn_ptrs[c+1]; i++) {
+      e = comp_eqns[i];
+      if (e < 0 || e >= n_eqns) continue;
+      eqn_comp[e] = c;
+      for (j = adj_ptrs[e]; j < adj_ptrs[e+1]; j++) {
+        v = adj_ids[j];
+        if (var_comp[v] == c) continue;
+        if (v >= first_independent && mark[v] != c) {
+          mark[v] = c;
+          pat[pat_size++] = v;
+        }
+        d = var_comp[v];
+        if (d >= 0) {
+          for (k = pat_ptrs[d]; k < pat_ptrs[d+1]; k++) {
+            if (mark[pat[k]] != c) {
+              mark[pat[k]] = c;
+              pat[pat_size++] = pat[k];
+            }
+          }
+        }
+      }
+    }
+    pat_ptrs[c+1] = pat_size;
+  }
+
+  /* extract the requested rows */
+  out_ptrs = (int*) malloc((n_rows+1) * sizeof(int));
+  if (!out_ptrs) {
+    nnz = -1;
+    goto done;
+  }
+  nnz = 0;
+  for (i = 0; i < n_rows; i++) {
+    e = rows[i];
+    c = (e >= 0 && e < n_eqns) ? eqn_comp[e] : -1;
+    out_ptrs[i] = nnz;
+    if (c >= 0) nnz += pat_ptrs[c+1] - pat_ptrs[c];
+  }
+  out_ptrs[n_rows] = nnz;
+  out_ids = (int*) malloc((nnz+1) * sizeof(int));
+  if (!out_ids) {
+    free(out_ptrs);
+    out_ptrs = NULL;
+    nnz = -1;
+    goto done;
+  }
+  for (i = 0; i < n_rows; i++) {
+    e = rows[i];
+    c = (e >= 0 && e < n_eqns) ? eqn_comp[e] : -1;
+    if (c < 0) continue;
+    for (j = out_ptrs[i], k = pat_ptrs[c]; k < pat_ptrs[c+1]; j++, k++) {
+      out_ids[j] = pat[k] - first_independent;
+    }
+    qsort(out_ids + out_ptrs[i], out_ptrs[i+1] - out_ptrs[i], sizeof(int), compareInt);
+  }
+
+done:
+  free(eqn_comp);
+  free(var_comp);
+  free(mark);
+  free(pat_ptrs);
+  free(pat);
+  *pattern_ptrs = out_ptrs;
+  *pattern_ids = out_ids;
+  return nnz;
+}
+
+/* Buckets of vertices with the same key as doubly linked lists. */
+typedef struct {
+  int *head;
+  int *next;
+  int *prev;
+  int *key;
+} Buckets;
+
+static void bucketInsert(Buckets *b, int j, int key)
+{
+  b->key[j] = key;
+  b->prev[j] = -1;
+  b->next[j] = b->head[key];
+  if (b->head[key] >= 0) b->prev[b->head[key]] = j;
+  b->head[key] = j;
+}
+
+static void bucketRemove(Buckets *b, int j)
+{
+  if (b->prev[j] >= 0) b->next[b->prev[j]] = b->next[j];
+  else b->head[b->key[j]] = b->next[j];
+  if (b->next[j] >= 0) b->prev[b->next[j]] = b->prev[j];
+}
+
+/* distance-2 degree of every column, i.e. the number of other columns sharing a row */
+static void d2Degrees(int n_cols, const int *row_ptrs, const int *row_ids,
+                      const int *col_ptrs, const int *col_ids, int *seen, int *degree)
+{
+  int j, i, k, l;
+  for (j = 0; j < n_cols; j++) seen[j] = -1;
+  for (j = 0; j < n_cols; j++) {
+    degree[j] = 0;
+    seen[j] = j;
+    for (i = col_ptrs[j]; i < col_ptrs[j+1]; i++) {
+      for (k = row_ptrs[col_ids[i]]; k < row_ptrs[col_ids[i]+1]; k++) {
+        l = row_ids[k];
+        if (seen[l] != j) {
+          seen[l] = j;
+          degree[j]++;
+        }
+      }
+    }
+  }
+}
+
+/* columns by decreasing distance-2 degree, ties in natural order */
+static void orderLargestFirst(int n_cols, const int *degree, int *count, int *order)
+{
+  int j, d, pos;
+  for (d = 0; d <= n_cols; d++) count[d] = 0;
+  for (j = 0; j < n_cols; j++) count[degree[j]]++;
+  for (d = n_cols, pos = 0; d >= 0; d--) {
+    int n = count[d];
+    count[d] = pos;
+    pos += n;
+  }
+  for (j = 0; j < n_cols; j++) order[count[degree[j]]++] = j;
+}
+
+/* repeatedly removes the column of smallest distance-2 degree in the remaining
+ * graph and colors the columns in reverse order of removal */
+static void orderSmallestLast(int n_cols, const int *row_ptrs, const int *row_ids,
+                              const int *col_ptrs, const int *col_ids,
+                              const int *degree, Buckets *b, int *seen, int *removed, int *order)
+{
+  int j, i, k, l, pos, min_key = n_cols;
+  for (j = 0; j <= n_cols; j++) b->head[j] = -1;
+  for (j = n_cols-1; j >= 0; j--) {
+    bucketInsert(b, j, degree[j]);
+    if (degree[j] < min_key) min_key = degree[j];
+    seen[j] = -1;
+    removed[j] = 0;
+  }
+  for (pos = n_cols-1; pos >= 0; pos--) {
+    while (b->head[min_key] < 0) min_key++;
+    j = b->head[min_key];
+    bucketRemove(b, j);
+    removed[j] = 1;
+    order[pos] = j;
+    seen[j] = j;
+    for (i = col_ptrs[j]; i < col_ptrs[j+1]; i++) {
+      for (k = row_ptrs[col_ids[i]]; k < row_ptrs[col_ids[i]+1]; k++) {
+        l = row_ids[k];
+        if (seen[l] != j && !removed[l]) {
+          seen[l] = j;
+          bucketRemove(b, l);
+          bucketInsert(b, l, b->key[l]-1);
+          if (b->key[l] < min_key) min_key = b->key[l];
+        }
+      }
+    }
+  }
+}
+
+/* next column is the one with most already ordered distance-2 neighbours,
+ * ties broken by largest distance-2 degree */
+static void orderIncidenceDegree(int n_cols, const int *row_ptrs, const int *row_ids,
+                                 const int *col_ptrs, const int *col_ids,
+                                 const int *lf_order, Buckets *b, int *seen, int *ordered, int *order)
+{
+  int j, i, k, l, pos, max_key = 0;
+  for (j = 0; j <= n_cols; j++) b->head[j] = -1;
+  for (pos = n_cols-1; pos >= 0; pos--) {
+    j = lf_order[pos];
+    bucketInsert(b, j, 0);
+    seen[j] = -1;
+    ordered[j] = 0;
+  }
+  for (pos = 0; pos < n_cols; pos++) {
+    while (b->head[max_key] < 0) max_key--;
+    j = b->head[max_key];
+    bucketRemove(b, j);
+    ordered[j] = 1;
+    order[pos] = j;
+    seen[j] = j;
+    for (i = col_ptrs[j]; i < col_ptrs[j+1]; i++) {
+      for (k = row_ptrs[col_ids[i]]; k < row_ptrs[col_ids[i]+1]; k++) {
+        l = row_ids[k];
+        if (seen[l] != j && !ordered[l]) {
+          seen[l] = j;
+          bucketRemove(b, l);
+          bucketInsert(b, l, b->key[l]+1);
+          if (b->key[l] > max_key) max_key = b->key[l];
+        }
+      }
+    }
+  }
+}
+
+static int greedyColor(int n_cols, const int *row_ptrs, const int *row_ids,
+                       const int *col_ptrs, const int *col_ids,
+                       const int *order, int *forbidden, int *colors)
+{
+  int pos, j, i, k, c, n_colors = 0;
+  for (j = 0; j < n_cols; j++) colors[j] = 0;
+  for (c = 0; c <= n_cols+1; c++) forbidden[c] = -1;
+  for (pos = 0; pos < n_cols; pos++) {
+    j = order[pos];
+    for (i = col_ptrs[j]; i < col_ptrs[j+1]; i++) {
+      for (k = row_ptrs[col_ids[i]]; k < row_ptrs[col_ids[i]+1]; k++) {
+        c = colors[row_ids[k]];
+        if (c > 0) forbidden[c] = j;
+      }
+    }
+    for (c = 1; forbidden[c] == j; c++);
+    colors[j] = c;
+    if (c > n_colors) n_colors = c;
+  }
+  return n_colors;
+}
+
+int sparsity_color_d2(int n_cols, const int *row_ptrs, const int *row_ids,
+                      const int *col_ptrs, const int *col_ids, int ordering, int *colors)
+{
+  int j, n, n_colors = -1;
+  int first, last;
+  Buckets b;
+  int *degree = (int*) malloc((n_cols+2) * sizeof(int));
+  int *seen = (int*) malloc((n_cols+2) * sizeof(int));
+  int *flags = (int*) malloc((n_cols+2) * sizeof(int));
+  int *lf_order = (int*) malloc((n_cols+2) * sizeof(int));
+  int *order = (int*) malloc((n_cols+2) * sizeof(int));
+  int *tmp_colors = (int*) malloc((n_cols+2) * sizeof(int));
+  b.head = (int*) malloc((n_cols+2) * sizeof(int));
+  b.next = (int*) malloc((n_cols+2) * sizeof(int));
+  b.prev = (int*) malloc((n_cols+2) * sizeof(int));
+  b.key = (int*) malloc((n_cols+2) * sizeof(int));
+
+  if (!degree || !seen || !flags || !lf_order || !order || !tmp_colors || !b.head || !b.next || !b.prev || !b.key) {
+    goto done;
+  }
+  if (n_cols == 0) {
+    n_colors = 0;
+    goto done;
+  }
+
+  if (ordering == SPARSITY_ORDER_NATURAL) {
+    first = last = SPARSITY_ORDER_NATURAL;
+  } else if (ordering == SPARSITY_ORDER_BEST) {
+    first = SPARSITY_ORDER_NATURAL;
+    last = SPARSITY_ORDER_INCIDENCE_DEGREE;
+  } else {
+    first = last = ordering;
+  }
+
+  if (last > SPARSITY_ORDER_NATURAL) {
+    d2Degrees(n_cols, row_ptrs, row_ids, col_ptrs, col_ids, seen, degree);
+    orderLargestFirst(n_cols, degree, flags, lf_order);
+  }
+
+  for (ordering = first; ordering <= last; ordering++) {
+    switch (ordering) {
+    case SPARSITY_ORDER_LARGEST_FIRST:
+      memcpy(order, lf_order, n_cols * sizeof(int));
+      break;
+    case SPARSITY_ORDER_SMALLEST_LAST:
+      orderSmallestLast(n_cols, row_ptrs, row_ids, col_ptrs, col_ids, degree, &b, seen, flags, order);
+      break;
+    case SPARSITY_ORDER_INCIDENCE_DEGREE:
+      orderIncidenceDegree(n_cols, row_ptrs, row_ids, col_ptrs, col_ids, lf_order, &b, seen, flags, order);
+      break;
+    default:
+      for (j = 0; j < n_cols; j++) order[j] = j;
+      break;
+    }
+    n = greedyColor(n_cols, row_ptrs, row_ids, col_ptrs, col_ids, order, seen, tmp_colors);
+    if (n_colors < 0 || n < n_colors) {
+      n_colors = n;
+      memcpy(colors, tmp_colors, n_cols * sizeof(int));
+    }
+  }
+
+done:
+  free(degree);
+  free(seen);
+  free(flags);
+  free(lf_order);
+  free(order);
+  free(tmp_colors);
+  free(b.head);
+  free(b.next);
+  free(b.prev);
+  free(b.key);
+  return n_colors;
+}
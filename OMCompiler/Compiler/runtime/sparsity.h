@@ -0,0 +1,86 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+
+/*
+ * file:        sparsity.h
+ * description: Sparsity pattern propagation and distance-2 coloring of Jacobians
+ *              working on compressed (CSR) arrays. Used by
+ *              SymbolicJacobian.generateSparsePattern through BackendDAEEXT.
+ *              All indices are zero-based.
+ */
+
+#ifndef SPARSITY_H_
+#define SPARSITY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SPARSITY_ORDER_NATURAL           1
+#define SPARSITY_ORDER_LARGEST_FIRST     2
+#define SPARSITY_ORDER_SMALLEST_LAST     3
+#define SPARSITY_ORDER_INCIDENCE_DEGREE  4
+#define SPARSITY_ORDER_BEST              5
+
+/*
+ * Propagates the dependencies on the independent variables through the strong
+ * components in the order of the BLT. Component c solves the variables
+ * comp_vars[comp_var_ptrs[c]..comp_var_ptrs[c+1]-1] with the equations
+ * comp_eqns[comp_eqn_ptrs[c]..comp_eqn_ptrs[c+1]-1]. Variables with index
+ * >= first_independent are the independent variables.
+ *
+ * Returns for each of the n_rows equations in rows the sorted independent
+ * variables it depends on, shifted by first_independent. The result is
+ * allocated with malloc and returned in pattern_ptrs (n_rows+1) and
+ * pattern_ids. Returns the number of non-zeros or -1 if out of memory.
+ */
+int sparsity_pattern(int n_eqns, int n_vars, const int *adj_ptrs, const int *adj_ids,
+                     int n_comps, const int *comp_eqn_ptrs, const int *comp_eqns,
+                     const int *comp_var_ptrs, const int *comp_vars,
+                     int first_independent, int n_rows, const int *rows,
+                     int **pattern_ptrs, int **pattern_ids);
+
+/*
+ * Partial distance-2 coloring of the n_cols columns of the pattern given by
+ * rows (row_ptrs, row_ids) and columns (col_ptrs, col_ids).
+ * Columns sharing a row get different colors. colors[j] is set to the color
+ * of column j, starting at 1. With SPARSITY_ORDER_BEST all orderings are
+ * tried and the one with the fewest colors is kept. Returns the number of
+ * colors or -1 if out of memory.
+ */
+int sparsity_color_d2(int n_cols, const int *row_ptrs, const int *row_ids,
+                      const int *col_ptrs, const int *col_ids, int ordering, int *colors);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPARSITY_H_ */
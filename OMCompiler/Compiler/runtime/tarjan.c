@@ -0,0 +1,117 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+
+
+/*
+ * file:        tarjan.c
+ * description: Iterative version of Tarjan's strong component algorithm,
+ *              see tarjan.h.
+ *              "R. E. Tarjan. 'Depth-first search and linear graph algorithms'
+ *              SIAM Journal on Computing 1(2), 1972."
+ */
+
+#include <stdlib.h>
+
+#include "tarjan.h"
+
+int tarjan_scc(int n_nodes, const int *succ_ptrs, const int *succ_ids,
+               int n_roots, const int *roots, int *comp_ptrs, int *comp_nodes)
+{
+  int *number, *lowlink, *stack, *path, *next;
+  char *onStack;
+  int index = 0, sp = 0, top, n_comps = 0, k = 0;
+  int r, v, w;
+
+  number = (int*) malloc((n_nodes+1) * sizeof(int));
+  lowlink = (int*) malloc((n_nodes+1) * sizeof(int));
+  stack = (int*) malloc((n_nodes+1) * sizeof(int));
+  path = (int*) malloc((n_nodes+1) * sizeof(int));
+  next = (int*) malloc((n_nodes+1) * sizeof(int));
+  onStack = (char*) calloc(n_nodes+1, sizeof(char));
+  if (!number || !lowlink || !stack || !path || !next || !onStack) {
+    free(number); free(lowlink); free(stack); free(path); free(next); free(onStack);
+    return -1;
+  }
+  for (v = 0; v < n_nodes; v++) {
+    number[v] = -1;
+  }
+
+  comp_ptrs[0] = 0;
+  for (r = 0; r < n_roots; r++) {
+    if (number[roots[r]] != -1) {
+      continue;
+    }
+    /* path[0..top-1] is the current depth-first path, next[i] the next
+     * successor of path[i] to consider */
+    v = roots[r];
+    number[v] = lowlink[v] = index++;
+    stack[sp++] = v;
+    onStack[v] = 1;
+    path[0] = v;
+    next[0] = succ_ptrs[v];
+    top = 1;
+
+    while (top > 0) {
+      v = path[top-1];
+      if (next[top-1] < succ_ptrs[v+1]) {
+        w = succ_ids[next[top-1]++];
+        if (number[w] == -1) {
+          number[w] = lowlink[w] = index++;
+          stack[sp++] = w;
+          onStack[w] = 1;
+          path[top] = w;
+          next[top] = succ_ptrs[w];
+          top++;
+        } else if (onStack[w] && number[w] < lowlink[v]) {
+          lowlink[v] = number[w];
+        }
+        continue;
+      }
+
+      /* all successors of v are done; if v is a root, pop its component */
+      if (lowlink[v] == number[v]) {
+        do {
+          w = stack[--sp];
+          onStack[w] = 0;
+          comp_nodes[k++] = w;
+        } while (w != v);
+        comp_ptrs[++n_comps] = k;
+      }
+      top--;
+      if (top > 0 && lowlink[v] < lowlink[path[top-1]]) {
+        lowlink[path[top-1]] = lowlink[v];
+      }
+    }
+  }
+
+  free(number); free(lowlink); free(stack); free(path); free(next); free(onStack);
+  return n_comps;
+}
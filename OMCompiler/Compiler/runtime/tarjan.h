@@ -0,0 +1,72 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+
+
+/*
+ * file:        tarjan.h
+ * description: Strong components and their topological order on compressed
+ *              (CSR) graphs. Used by Sorting.mo and NBSorting.mo through
+ *              BackendDAEEXT. All indices are zero-based.
+ *
+ *              The functions keep no global state and can be called
+ *              concurrently for different graphs.
+ */
+
+#ifndef TARJAN_H_
+#define TARJAN_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Tarjan's algorithm on the graph with the successors
+ * succ_ids[succ_ptrs[i]..succ_ptrs[i+1]-1] of node i. The depth-first searches
+ * are started from the n_roots nodes in roots, in the given order, and visit
+ * the successors in the given order, i.e., the result is the same as for the
+ * recursive formulation.
+ *
+ * Component c consists of comp_nodes[comp_ptrs[c]..comp_ptrs[c+1]-1], the
+ * root of the component last. The components are stored in the order they
+ * are completed, i.e., every component comes after all components reachable
+ * from it. Only nodes reachable from the roots are stored. comp_ptrs must
+ * hold n_nodes+1 and comp_nodes n_nodes entries.
+ *
+ * Returns the number of components or -1 if out of memory.
+ */
+int tarjan_scc(int n_nodes, const int *succ_ptrs, const int *succ_ids,
+               int n_roots, const int *roots, int *comp_ptrs, int *comp_nodes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TARJAN_H_ */
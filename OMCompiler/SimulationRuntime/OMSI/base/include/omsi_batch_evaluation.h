@@ -0,0 +1,84 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+
+
+#ifndef OMSI_BATCH_EVALUATION__H_
+#define OMSI_BATCH_EVALUATION__H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <string.h>
+
+/* Public OMSI headers */
+#include <omsi.h>
+#include <omsi_utils.h>
+
+
+/**
+ * \brief Batch of model instances evaluated with one call.
+ *
+ * Input and output blocks are structure of arrays: value `i` of instance `k`
+ * is stored at `block[i*n_instances + k]`. `batch_vars` uses the same layout
+ * for all variables and parameters, indexed with their value reference.
+ */
+typedef struct omsi_batch_t {
+    omsi_unsigned_int   n_instances;    /**< Number of instances in the batch. */
+
+    omsi_unsigned_int   n_inputs;       /**< Number of real inputs per instance. */
+    omsi_unsigned_int*  vr_inputs;      /**< Value references of real inputs. Defaults to the states. */
+    omsi_unsigned_int   n_outputs;      /**< Number of real outputs per instance. */
+    omsi_unsigned_int*  vr_outputs;     /**< Value references of real outputs. Defaults to the state derivatives. */
+
+    omsi_values*        batch_vars;     /**< Values of all instances, passed to generated batch function. */
+} omsi_batch_t;
+
+
+/* Function prototypes */
+omsi_batch_t* omsi_allocate_batch (omsi_t*                  omsu,
+                                   omsi_unsigned_int        n_instances,
+                                   const omsi_unsigned_int* vr_inputs,
+                                   omsi_unsigned_int        n_inputs,
+                                   const omsi_unsigned_int* vr_outputs,
+                                   omsi_unsigned_int        n_outputs);
+
+void omsi_free_batch (omsi_batch_t* batch);
+
+omsi_status omsi_evaluate_batch (omsi_t*            omsu,
+                                 omsi_batch_t*      batch,
+                                 const omsi_real    inputs[],
+                                 omsi_real          outputs[]);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
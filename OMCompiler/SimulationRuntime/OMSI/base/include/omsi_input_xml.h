@@ -111,6 +111,8 @@ omsi_status omsu_process_input_xml(omsi_t*                         osu_data,
                                    omsi_string                     instanceName,
                                    const omsi_callback_functions*  functions);
 
+void omsu_release_model_data(model_data_t* model_data);
+
 
 
 /*private function prototypes */
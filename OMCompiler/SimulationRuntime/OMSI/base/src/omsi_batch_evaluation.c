@@ -0,0 +1,278 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/** \file omsi_batch_evaluation.c
+ */
+
+/** \defgroup BatchEvaluation Batch evaluation
+ *  \ingroup OMSIBase
+ *
+ * \brief Evaluate the simulation equations for a batch of model instances.
+ *
+ * Used to evaluate the same model at many input points, e.g. for surrogate
+ * model training or uncertainty quantification, without creating one OMSU
+ * instance per point. The equations are evaluated by the generated function
+ * `sim_data_t::evaluate_simulation_batch`, which loops over the instances
+ * innermost for every equation.
+ */
+
+/** \addtogroup BatchEvaluation
+  *  \{ */
+
+#include <omsi_global.h>
+
+#include <omsi_batch_evaluation.h>
+
+
+/**
+ * \brief Allocate memory for a batch of model instances.
+ *
+ * Only possible if the generated code contains a batch function for the
+ * simulation problem, i.e. all simulation equations are explicit assignments
+ * without algebraic systems, events or pre values.
+ *
+ * \param [in]  omsu            Central data structure containing all informations.
+ * \param [in]  n_instances     Number of instances in the batch.
+ * \param [in]  vr_inputs       Value references of real inputs. If `NULL` the states are used.
+ * \param [in]  n_inputs        Length of `vr_inputs`. Ignored if `vr_inputs` is `NULL`.
+ * \param [in]  vr_outputs      Value references of real outputs. If `NULL` the state derivatives are used.
+ * \param [in]  n_outputs       Length of `vr_outputs`. Ignored if `vr_outputs` is `NULL`.
+ * \return      omsi_batch_t*   Pointer to allocated batch or `NULL` if something went wrong.
+ */
+omsi_batch_t* omsi_allocate_batch (omsi_t*                  omsu,
+                                   omsi_unsigned_int        n_instances,
+                                   const omsi_unsigned_int* vr_inputs,
+                                   omsi_unsigned_int        n_inputs,
+                                   const omsi_unsigned_int* vr_outputs,
+                                   omsi_unsigned_int        n_outputs) {
+
+    /* Variables */
+    omsi_batch_t* batch;
+    omsi_values* model_vars;
+    omsi_unsigned_int i, n_states;
+
+    if (omsu == NULL || omsu->sim_data == NULL || omsu->sim_data->model_vars_and_params == NULL) {
+        filtered_base_logger(global_logCategories, log_statuserror, omsi_error,
+                "omsi_allocate_batch: Simulation data not instantiated.");
+        return NULL;
+    }
+    if (omsu->sim_data->evaluate_simulation_batch == NULL) {
+        filtered_base_logger(global_logCategories, log_statuserror, omsi_error,
+                "omsi_allocate_batch: Model has no batch evaluation function. "
+                "Simulation equations contain algebraic systems, events or pre values.");
+        return NULL;
+    }
+    if (n_instances == 0) {
+        filtered_base_logger(global_logCategories, log_statuserror, omsi_error,
+                "omsi_allocate_batch: Batch has no instances.");
+        return NULL;
+    }
+
+    model_vars = omsu->sim_data->model_vars_and_params;
+    n_states = omsu->model_data->n_states;
+    if (vr_inputs == NULL) {
+        n_inputs = n_states;
+    }
+    if (vr_outputs == NULL) {
+        n_outputs = n_states;
+    }
+
+    batch = global_callback->allocateMemory(1, sizeof(omsi_batch_t));
+    if (!batch) {
+        filtered_base_logger(global_logCategories, log_statuserror, omsi_error,
+                "omsi_allocate_batch: Not enough memory.");
+        return NULL;
+    }
+    batch->n_instances = n_instances;
+    batch->n_inputs = n_inputs;
+    batch->n_outputs = n_outputs;
+    batch->vr_inputs = global_callback->allocateMemory(n_inputs + 1, sizeof(omsi_unsigned_int));
+    batch->vr_outputs = global_callback->allocateMemory(n_outputs + 1, sizeof(omsi_unsigned_int));
+    batch->batch_vars = global_callback->allocateMemory(1, sizeof(omsi_values));
+    if (!batch->vr_inputs || !batch->vr_outputs || !batch->batch_vars) {
+        filtered_base_logger(global_logCategories, log_statuserror, omsi_error,
+                "omsi_allocate_batch: Not enough memory.");
+        omsi_free_batch(batch);
+        return NULL;
+    }
+
+    batch->batch_vars->n_reals = model_vars->n_reals;
+    batch->batch_vars->n_ints = model_vars->n_ints;
+    batch->batch_vars->n_bools = model_vars->n_bools;
+    batch->batch_vars->reals = global_callback->allocateMemory((size_t)n_instances * model_vars->n_reals + 1, sizeof(omsi_real));
+    batch->batch_vars->ints = global_callback->allocateMemory((size_t)n_instances * model_vars->n_ints + 1, sizeof(omsi_int));
+    batch->batch_vars->bools = global_callback->allocateMemory((size_t)n_instances * model_vars->n_bools + 1, sizeof(omsi_bool));
+    if (!batch->batch_vars->reals || !batch->batch_vars->ints || !batch->batch_vars->bools) {
+        filtered_base_logger(global_logCategories, log_statuserror, omsi_error,
+                "omsi_allocate_batch: Not enough memory.");
+        omsi_free_batch(batch);
+        return NULL;
+    }
+
+    /* States are stored at reals[0 .. n_states-1] followed by their derivatives */
+    for (i = 0; i < n_inputs; i++) {
+        batch->vr_inputs[i] = vr_inputs ? vr_inputs[i] : i;
+        if (batch->vr_inputs[i] >= model_vars->n_reals) {
+            filtered_base_logger(global_logCategories, log_statuserror, omsi_error,
+                    "omsi_allocate_batch: Input value reference %u out of range.",
+                    batch->vr_inputs[i]);
+            omsi_free_batch(batch);
+            return NULL;
+        }
+    }
+    for (i = 0; i < n_outputs; i++) {
+        batch->vr_outputs[i] = vr_outputs ? vr_outputs[i] : n_states + i;
+        if (batch->vr_outputs[i] >= model_vars->n_reals) {
+            filtered_base_logger(global_logCategories, log_statuserror, omsi_error,
+                    "omsi_allocate_batch: Output value reference %u out of range.",
+                    batch->vr_outputs[i]);
+            omsi_free_batch(batch);
+            return NULL;
+        }
+    }
+
+    return batch;
+}
+
+
+/**
+ * \brief Free memory of batch.
+ *
+ * \param [in,out]  batch   Batch allocated with `omsi_allocate_batch`.
+ */
+void omsi_free_batch (omsi_batch_t* batch) {
+
+    if (batch == NULL) {
+        return;
+    }
+    if (batch->vr_inputs) {
+        global_callback->freeMemory(batch->vr_inputs);
+    }
+    if (batch->vr_outputs) {
+        global_callback->freeMemory(batch->vr_outputs);
+    }
+    if (batch->batch_vars) {
+        if (batch->batch_vars->reals) {
+            global_callback->freeMemory(batch->batch_vars->reals);
+        }
+        if (batch->batch_vars->ints) {
+            global_callback->freeMemory(batch->batch_vars->ints);
+        }
+        if (batch->batch_vars->bools) {
+            global_callback->freeMemory(batch->batch_vars->bools);
+        }
+        global_callback->freeMemory(batch->batch_vars);
+    }
+    global_callback->freeMemory(batch);
+}
+
+
+/**
+ * \brief Evaluate simulation equations for all instances of a batch.
+ *
+ * Every instance starts from the current values and time of `omsu`, i.e.
+ * parameters and all values not given in `inputs` are shared by the whole
+ * batch. The values of `omsu` are unchanged afterwards and `omsu` is not
+ * used by the generated batch function, so it can still be used for scalar
+ * evaluation, also from another thread.
+ *
+ * \param [in]      omsu        Central data structure containing all informations.
+ * \param [in,out]  batch       Batch allocated with `omsi_allocate_batch`.
+ * \param [in]      inputs      Input block of length `n_inputs*n_instances`.
+ * \param [out]     outputs     Output block of length `n_outputs*n_instances`.
+ * \return          omsi_status `omsi_ok` if successful, otherwise `omsi_error`.
+ */
+omsi_status omsi_evaluate_batch (omsi_t*            omsu,
+                                 omsi_batch_t*      batch,
+                                 const omsi_real    inputs[],
+                                 omsi_real          outputs[]) {
+
+    /* Variables */
+    omsi_values* model_vars;
+    omsi_values* batch_vars;
+    omsi_unsigned_int i, k, n_instances;
+
+    if (batch == NULL || inputs == NULL || outputs == NULL) {
+        filtered_base_logger(global_logCategories, log_statuserror, omsi_error,
+                "omsi_evaluate_batch: Invalid arguments.");
+        return omsi_error;
+    }
+
+    model_vars = omsu->sim_data->model_vars_and_params;
+    batch_vars = batch->batch_vars;
+    n_instances = batch->n_instances;
+
+    if (model_vars->n_reals != batch_vars->n_reals
+            || model_vars->n_ints != batch_vars->n_ints
+            || model_vars->n_bools != batch_vars->n_bools) {
+        filtered_base_logger(global_logCategories, log_statuserror, omsi_error,
+                "omsi_evaluate_batch: Batch was allocated for a different model.");
+        return omsi_error;
+    }
+
+    /* Start all instances from the current values */
+    batch_vars->time_value = model_vars->time_value;
+    for (i = 0; i < model_vars->n_reals; i++) {
+        for (k = 0; k < n_instances; k++) {
+            batch_vars->reals[(size_t)i*n_instances + k] = model_vars->reals[i];
+        }
+    }
+    for (i = 0; i < model_vars->n_ints; i++) {
+        for (k = 0; k < n_instances; k++) {
+            batch_vars->ints[(size_t)i*n_instances + k] = model_vars->ints[i];
+        }
+    }
+    for (i = 0; i < model_vars->n_bools; i++) {
+        for (k = 0; k < n_instances; k++) {
+            batch_vars->bools[(size_t)i*n_instances + k] = model_vars->bools[i];
+        }
+    }
+
+    /* Inputs and outputs have the same layout as batch_vars, copy whole rows */
+    for (i = 0; i < batch->n_inputs; i++) {
+        memcpy(&batch_vars->reals[(size_t)batch->vr_inputs[i]*n_instances],
+               &inputs[(size_t)i*n_instances], n_instances*sizeof(omsi_real));
+    }
+
+    if (omsu->sim_data->evaluate_simulation_batch(batch_vars, n_instances) != omsi_ok) {
+        filtered_base_logger(global_logCategories, log_statuserror, omsi_error,
+                "omsi_evaluate_batch: Evaluation of batch failed.");
+        return omsi_error;
+    }
+
+    for (i = 0; i < batch->n_outputs; i++) {
+        memcpy(&outputs[(size_t)i*n_instances],
+               &batch_vars->reals[(size_t)batch->vr_outputs[i]*n_instances], n_instances*sizeof(omsi_real));
+    }
+
+    return omsi_ok;
+}
+
+/** \} */
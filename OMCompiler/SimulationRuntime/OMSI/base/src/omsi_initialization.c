@@ -277,6 +277,9 @@ omsi_status omsi_intialize_callbacks(omsi_t*                                omsu
                                       "simulation",
                                       template_functions->initialize_simulation_problem);
 
+    /* Batch evaluation of simulation problem, NULL if not supported by model */
+    omsu->sim_data->evaluate_simulation_batch = template_functions->evaluate_simulation_batch;
+
     return omsi_ok;
 }
 
@@ -81,6 +81,7 @@ static void readInfoJson(omsi_string    str,
  * \brief Process all informations from input.json file.
  *
  * Read values, allocates memory and writes everything in model_data->equation_info.
+ * Nothing is read for model data shared with an earlier instance of the OMSU.
  *
  * \param [in,out]  osu_data        Central data structure containing all informations.
  * \param [in]      fileName        Path to JSON file.
@@ -104,6 +105,11 @@ omsi_status omsu_process_input_json(omsi_t*                         osu_data,
     global_callback = (omsi_callback_functions*) functions;
     global_instance_name = instanceName;
 
+    /* Model data shared with an earlier instance already has the equation infos */
+    if (osu_data->model_data->equation_info) {
+        return omsi_ok;
+    }
+
     /* Log function call */
     filtered_base_logger(global_logCategories, log_all, omsi_ok,
                 "fmi2Instantiate: Process JSON file %s.", fileName);
@@ -52,6 +52,36 @@
 #define UNUSED(x) (void)(x)     /* ToDo: delete later */
 
 
+/*
+ * Model data read from one modelName_init.xml file is never changed by an
+ * instance, so all instances of the same OMSU share it. The list is reference
+ * counted and, like the other globals of OMSI base, not protected against
+ * concurrent instantiation.
+ */
+typedef struct omsi_shared_model_data {
+    omsi_char*                      filename;
+    model_data_t*                   model_data;
+    omsi_experiment_t               experiment;     /* default experiment, copied for every instance */
+    omsi_status                     status;
+    omsi_unsigned_int               n_instances;
+    size_t                          size;           /* bytes allocated for model_data */
+    struct omsi_shared_model_data*  next;
+} omsi_shared_model_data;
+
+static omsi_shared_model_data* shared_model_data = NULL;
+
+static size_t omsu_model_data_size(model_data_t* model_data);
+
+static omsi_status omsu_use_shared_model_data(omsi_t*                  osu_data,
+                                              omsi_shared_model_data*  shared,
+                                              omsi_string              fmuGUID,
+                                              omsi_string              filename);
+
+static void omsu_share_model_data(omsi_t*       osu_data,
+                                  omsi_string   filename,
+                                  omsi_status   status);
+
+
 /**
  * \brief Processes modelName_init.xml file to get additional model infos.
  *
@@ -84,6 +114,7 @@ omsi_status omsu_process_input_xml(omsi_t*                         osu_data,
     omc_ModelInput mi = {0};
     FILE* file = NULL;
     XML_Parser parser = NULL;
+    omsi_shared_model_data* shared;
 
     status = omsi_ok;
 
@@ -91,6 +122,13 @@ omsi_status omsu_process_input_xml(omsi_t*                         osu_data,
     global_callback = (omsi_callback_functions*) functions;
     global_instance_name = instanceName;
 
+    /* Further instances of the same OMSU use the model data read before */
+    for (shared=shared_model_data; shared; shared=shared->next) {
+        if (0 == strcmp(shared->filename, filename)) {
+            return omsu_use_shared_model_data(osu_data, shared, fmuGUID, filename);
+        }
+    }
+
     /* Log function call */
     filtered_base_logger(global_logCategories, log_all, omsi_ok,
             "fmi2Instantiate: Process XML file %s.", filename);
@@ -216,10 +254,180 @@ omsi_status omsu_process_input_xml(omsi_t*                         osu_data,
     /* Free stuff */
     omsu_free_ModelInput(&mi);
 
+    omsu_share_model_data(osu_data, filename, status);
+
+    return status;
+}
+
+
+/**
+ * \brief Releases model data of an instance.
+ *
+ * Model data shared with other instances is freed together with the last
+ * instance using it.
+ *
+ * \param [in] model_data   Pointer to model data of the instance.
+ */
+void omsu_release_model_data(model_data_t* model_data) {
+
+    /* Variables */
+    omsi_shared_model_data** prev;
+    omsi_shared_model_data* shared;
+
+    if (model_data==NULL) {
+        return;
+    }
+
+    for (prev=&shared_model_data; (shared=*prev); prev=&shared->next) {
+        if (shared->model_data == model_data) {
+            if (--shared->n_instances > 0) {
+                return;
+            }
+            *prev = shared->next;
+            global_callback->freeMemory(shared->filename);
+            global_callback->freeMemory((omsi_char*) shared->experiment.solver_name);
+            global_callback->freeMemory(shared);
+            break;
+        }
+    }
+
+    omsu_free_model_data(model_data);
+}
+
+
+/*
+ * ============================================================================
+ * Helper functions for sharing model data between instances
+ * ============================================================================
+ */
+
+/*
+ * Helper function for omsu_process_input_xml.
+ * Set up experiment data of a further instance and let it use the shared
+ * model data. The GUID is checked as for a freshly read XML file.
+ */
+static omsi_status omsu_use_shared_model_data(omsi_t*                  osu_data,
+                                              omsi_shared_model_data*  shared,
+                                              omsi_string              fmuGUID,
+                                              omsi_string              filename) {
+
+    /* Variables */
+    omsi_status status;
+
+    status = shared->status;
+    if (strcmp(fmuGUID, shared->model_data->modelGUID)) {
+        filtered_base_logger(global_logCategories, log_statuserror, omsi_error,
+                "fmi2Instantiate: Wrong GUID %s in file %s. Expected %s.",
+                shared->model_data->modelGUID, filename, fmuGUID);
+        status = omsi_warning;
+    }
+
+    osu_data->experiment = global_callback->allocateMemory(1, sizeof(omsi_experiment_t));
+    if (!osu_data->experiment) {
+        filtered_base_logger(global_logCategories, log_statuserror, omsi_error,
+                "fmi2Instantiate: Not enough memory to allocate osu_data->experiment.");
+        return omsi_error;
+    }
+    *osu_data->experiment = shared->experiment;
+    osu_data->experiment->solver_name = omsi_strdup(shared->experiment.solver_name);
+
+    osu_data->model_data = shared->model_data;
+    shared->n_instances++;
+
+    filtered_base_logger(global_logCategories, log_all, omsi_ok,
+            "fmi2Instantiate: Model data of %s (%lu kB) shared by %u instances, "
+            "%lu kB per instance without sharing, %lu kB with sharing.",
+            filename, (unsigned long) (shared->size+1023)/1024, shared->n_instances,
+            (unsigned long) (shared->size+sizeof(omsi_experiment_t)+1023)/1024,
+            (unsigned long) (sizeof(omsi_experiment_t)+1023)/1024);
+
     return status;
 }
 
 
+/*
+ * Helper function for omsu_process_input_xml.
+ * Keep the model data of the first instance for further instances of the
+ * same OMSU.
+ */
+static void omsu_share_model_data(omsi_t*       osu_data,
+                                  omsi_string   filename,
+                                  omsi_status   status) {
+
+    /* Variables */
+    omsi_shared_model_data* shared;
+
+    shared = global_callback->allocateMemory(1, sizeof(omsi_shared_model_data));
+    if (!shared) {
+        /* the instance keeps its own model data */
+        return;
+    }
+    shared->filename = omsi_strdup(filename);
+    shared->model_data = osu_data->model_data;
+    shared->experiment = *osu_data->experiment;
+    shared->experiment.solver_name = omsi_strdup(osu_data->experiment->solver_name);
+    shared->status = status;
+    shared->n_instances = 1;
+    shared->size = omsu_model_data_size(osu_data->model_data);
+    shared->next = shared_model_data;
+    shared_model_data = shared;
+
+    filtered_base_logger(global_logCategories, log_all, omsi_ok,
+            "fmi2Instantiate: Model data of %s (%lu kB) shared by 1 instance.",
+            filename, (unsigned long) (shared->size+1023)/1024);
+}
+
+
+/*
+ * Bytes allocated for model data, variable infos and their attributes.
+ */
+static size_t omsu_model_data_size(model_data_t* model_data) {
+
+    /* Variables */
+    omsi_unsigned_int i, n_vars;
+    size_t size;
+    model_variable_info_t* var_info;
+    real_var_attribute_t* attribute_real;
+    string_var_attribute_t* attribute_string;
+
+    n_vars = model_data->n_states + model_data->n_derivatives
+            + model_data->n_real_vars + model_data->n_real_parameters + model_data->n_real_aliases
+            + model_data->n_int_vars + model_data->n_int_parameters + model_data->n_int_aliases
+            + model_data->n_bool_vars + model_data->n_bool_parameters + model_data->n_bool_aliases
+            + model_data->n_string_vars + model_data->n_string_parameters + model_data->n_string_aliases;
+
+    size = sizeof(model_data_t) + strlen(model_data->modelGUID) + 1
+         + n_vars*sizeof(model_variable_info_t);
+
+    for (i=0; i<n_vars; i++) {
+        var_info = &model_data->model_vars_info[i];
+        size += strlen(var_info->name) + 1;
+        size += strlen(var_info->comment) + 1;
+        size += strlen(var_info->info.filename) + 1;
+        switch (var_info->type_index.type) {
+            case OMSI_TYPE_REAL:
+                attribute_real = var_info->modelica_attributes;
+                size += sizeof(real_var_attribute_t) + strlen(attribute_real->unit) + 1 + strlen(attribute_real->displayUnit) + 1;
+                break;
+            case OMSI_TYPE_INTEGER:
+                size += sizeof(int_var_attribute_t);
+                break;
+            case OMSI_TYPE_BOOLEAN:
+                size += sizeof(bool_var_attribute_t);
+                break;
+            case OMSI_TYPE_STRING:
+                attribute_string = var_info->modelica_attributes;
+                size += sizeof(string_var_attribute_t) + strlen(attribute_string->start) + 1;
+                break;
+            default:
+                break;
+        }
+    }
+
+    return size;
+}
+
+
 /*
  * ============================================================================
  * Helper functions for XML parsing
@@ -37,6 +37,7 @@
 
 #include <omsi_callbacks.h>
 #include <omsi_utils.h>
+#include <omsi_input_xml.h>
 
 #define DEBUG_FILTER_FLUSH omsi_true
 #define DEBUG_FLUSH if (DEBUG_FILTER_FLUSH) fflush(stdout);
@@ -240,8 +241,8 @@ void omsu_free_osu_data(omsi_t* omsi_data) {
         return;
     }
 
-    /* free memory for model data */
-    omsu_free_model_data(omsi_data->model_data);
+    /* free memory for model data, if no other instance shares it */
+    omsu_release_model_data(omsi_data->model_data);
 
     /* free memory for simulation data */
     omsu_free_sim_data(omsi_data->sim_data);
@@ -366,6 +366,11 @@ typedef struct omsi_algebraic_system_t {
  * potential linear and non-linear loops, which include in turn `omsi_function_t` structs
  * for residual functions and Jacobi matrix.
  *
+ * The generated equations are scalar code and `function_vars` of all functions of an
+ * OMSU point to the same `omsi_values`. An OMSU therefore evaluates one point at a time
+ * and is not reentrant. Many input points of the simulation problem are evaluated
+ * with `omsi_evaluate_batch` instead, see `sim_data_t::evaluate_simulation_batch`.
+ *
  */
 typedef struct omsi_function_t {
     omsi_unsigned_int           n_algebraic_system; /**< Number of algebraic systems. */
@@ -429,6 +434,12 @@ typedef struct sim_data_t{
 
     omsi_sample* sample_events;         /**< Array of sample events */
 
+    omsi_status (*evaluate_simulation_batch) (omsi_values*      batch_vars,
+                                              omsi_unsigned_int n_instances);
+                                        /**< Generated function evaluating the simulation problem
+                                         * for a structure-of-arrays block of instances. `NULL` if
+                                         * the model has algebraic systems, events or pre values. */
+
     /* start indices to model_vars_and_params */
     omsi_unsigned_int inputs_real_index;    /*start index of input real variables */
     omsi_unsigned_int inputs_int_index;     /*start index of input integer variables */
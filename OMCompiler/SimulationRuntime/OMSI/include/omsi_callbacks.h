@@ -155,6 +155,21 @@ typedef omsi_status (*evaluate_function) (omsi_function_t*  function,
                                           omsi_values*      variables,
                                           void*             data);
 
+/**
+ *\brief Function type for evaluating the simulation problem for a batch of instances.
+ *
+ * Evaluate equations from generated code with the loop over instances innermost.
+ * Value `i` of instance `k` is stored at `reals[i*n_instances + k]`, same for
+ * `ints` and `bools`. All instances share `time_value`.
+ *
+ * \param [in,out]  batch_vars  Structure-of-arrays block of all instances.
+ * \param [in]      n_instances Number of instances in `batch_vars`.
+ * \return                      `omsi_status omsi_ok` if successful <br>
+ *                              `omsi_status omsi_error` if something went wrong.
+ */
+typedef omsi_status (*evaluate_batch_function) (omsi_values*        batch_vars,
+                                                omsi_unsigned_int   n_instances);
+
 /**
  * \brief Callback functions to generated code.
  */
@@ -164,6 +179,7 @@ typedef struct omsi_template_callback_functions_t {
     omsu_initialize_omsi_function initialize_simulation_problem;     /**< Function pointer to initialize the simulation problem */
 
     void (*initialize_samples) (omsi_sample* sample_events);       /**< Function to initialize sampleEvents. */
+    evaluate_batch_function evaluate_simulation_batch;             /**< Function to evaluate the simulation problem for a batch of instances, can be `NULL`. */
 }omsi_template_callback_functions_t;
 
 
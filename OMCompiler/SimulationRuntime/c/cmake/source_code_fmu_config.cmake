@@ -32,6 +32,7 @@ set(SOURCE_FMU_COMMON_FILES_LIST ./gc/memory_pool.c
                                  ./util/omc_file.c
                                  ./util/omc_init.c
                                  ./util/omc_mmap.c
+                                 ./util/omc_prof_hist.c
                                  ./util/omc_msvc.c
                                  ./util/omc_numbers.c
                                  ./util/parallel_helper.c
@@ -138,6 +139,7 @@ set(SOURCE_FMU_COMMON_HEADERS \"./omc_inline.h\",
                               \"./util/omc_error.h\",
                               \"./util/omc_file.h\",
                               \"./util/omc_mmap.h\",
+                              \"./util/omc_prof_hist.h\",
                               \"./util/omc_msvc.h\",
                               \"./util/omc_numbers.h\",
                               \"./util/omc_spinlock.h\",
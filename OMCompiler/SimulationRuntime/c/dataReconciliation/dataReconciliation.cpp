@@ -46,7 +46,12 @@
 #include <ctime>
 #include <regex>
 #include "omc_config.h"
+#ifdef WITH_SUITESPARSE
+#include <klu.h>
+#endif
 #include "../util/omc_file.h"
+#include "../util/rtclock.h"
+#include "../util/jacobian_util.h"
 #include <cmath>
 #include "dataReconciliation.h"
 using namespace std;
@@ -57,6 +62,7 @@ extern "C"
   int dgemm_(char *transa, char *transb, int *m, int *n, int *k, double *alpha, double *a, int *lda,
              double *b, int *ldb, double *beta, double *c, int *ldc);
   int dgetrf_(int *m, int *n, double *a, int *lda, int *ipiv, int *info);
+  int dgetrs_(char *trans, int *n, int *nrhs, double *a, int *lda, int *ipiv, double *b, int *ldb, int *info);
   int dgetri_(int *n, double *a, int *lda, int *ipiv, double *work, int *lwork, int *info);
   int dscal_(int *n, double *da, double *dx, int *incx);
   int dcopy_(int *n, double *dx, int *incx, double *dy, int *incy);
@@ -104,6 +110,59 @@ struct inputData
   vector<int> index;
 };
 
+/*
+ * Sparse matrix in compressed sparse column format,
+ * used by the sparse reconciliation (-reconcileSparse)
+ */
+struct sparseMatrixData
+{
+  int rows;
+  int column;
+  vector<int> leadindex;   // start of column j in index and data, size column+1
+  vector<int> index;       // row of each non-zero element
+  vector<double> data;     // value of each non-zero element
+};
+
+/*
+ * Factorization of the matrix (F*Sx*Ft), with KLU if the runtime
+ * is built with SuiteSparse and with the dense LAPACK LU otherwise
+ */
+struct sparseFactorData
+{
+  int size;
+  size_t nnz;              // non-zero elements of the factors
+  size_t memory;           // memory of the factors in bytes
+#ifdef WITH_SUITESPARSE
+  klu_symbolic *symbolic;
+  klu_numeric *numeric;
+  klu_common common;
+#else
+  vector<double> lu;
+  vector<int> ipiv;
+#endif
+};
+
+/*
+ * Timing and memory of the sparse reconciliation
+ * reported in the html report
+ */
+struct reconciliationStatistics
+{
+  double timeCovariance;
+  double timeJacobian;
+  double timeAssembly;
+  double timeFactorization;
+  double timeSolve;
+  double timeReconciledSx;
+  double timeTotal;
+  size_t nnzF;
+  size_t nnzSx;
+  size_t nnzFSxFt;
+  size_t nnzFactor;
+  size_t memorySparse;
+  double memoryDense;
+};
+
 struct errorData
 {
   string name;
@@ -234,7 +293,7 @@ void createErrorHtmlReport(DATA * data, int status = 0)
 /*
 * create html report for data Reconciliation D.1
 */
-void createHtmlReportFordataReconciliation(DATA *data, csvData &csvinputs, matrixData &xdiag, matrixData &reconciled_X, matrixData &copyreconSx_diag, double *newX, double &eps, int &iterationcount, double &value, correlationDataWarning &warningCorrelationData)
+void createHtmlReportFordataReconciliation(DATA *data, csvData &csvinputs, matrixData &xdiag, matrixData &reconciled_X, matrixData &copyreconSx_diag, double *newX, double &eps, int &iterationcount, double &value, correlationDataWarning &warningCorrelationData, reconciliationStatistics *stats = NULL)
 {
   ofstream myfile;
   time_t now = time(0);
@@ -334,6 +393,27 @@ void createHtmlReportFordataReconciliation(DATA *data, csvData &csvinputs, matri
   myfile << "<tr> \n" << "<th align=right> Result of global test : </th> \n" << "<td>" << "TRUE" << "</td> </tr>\n";
   myfile << "</table>\n";
 
+  /* Add Performance data of the sparse reconciliation */
+  if (stats)
+  {
+    myfile << "<h2> Performance (sparse): </h2>\n";
+    myfile << "<table> \n";
+    myfile << "<tr> \n" << "<th align=right> Non-zero elements of F : </th> \n" << "<td>" << stats->nnzF << "</td> </tr>\n";
+    myfile << "<tr> \n" << "<th align=right> Non-zero elements of Sx : </th> \n" << "<td>" << stats->nnzSx << "</td> </tr>\n";
+    myfile << "<tr> \n" << "<th align=right> Non-zero elements of F*Sx*Ft : </th> \n" << "<td>" << stats->nnzFSxFt << "</td> </tr>\n";
+    myfile << "<tr> \n" << "<th align=right> Non-zero elements of the factorization : </th> \n" << "<td>" << stats->nnzFactor << "</td> </tr>\n";
+    myfile << "<tr> \n" << "<th align=right> Time covariance matrix Sx [s] : </th> \n" << "<td>" << stats->timeCovariance << "</td> </tr>\n";
+    myfile << "<tr> \n" << "<th align=right> Time Jacobian F [s] : </th> \n" << "<td>" << stats->timeJacobian << "</td> </tr>\n";
+    myfile << "<tr> \n" << "<th align=right> Time assembly F*Sx*Ft [s] : </th> \n" << "<td>" << stats->timeAssembly << "</td> </tr>\n";
+    myfile << "<tr> \n" << "<th align=right> Time factorization F*Sx*Ft [s] : </th> \n" << "<td>" << stats->timeFactorization << "</td> </tr>\n";
+    myfile << "<tr> \n" << "<th align=right> Time solve f* and reconciled x [s] : </th> \n" << "<td>" << stats->timeSolve << "</td> </tr>\n";
+    myfile << "<tr> \n" << "<th align=right> Time reconciled Sx [s] : </th> \n" << "<td>" << stats->timeReconciledSx << "</td> </tr>\n";
+    myfile << "<tr> \n" << "<th align=right> Total time [s] : </th> \n" << "<td>" << stats->timeTotal << "</td> </tr>\n";
+    myfile << "<tr> \n" << "<th align=right> Memory sparse matrices [MB] : </th> \n" << "<td>" << stats->memorySparse / 1048576.0 << "</td> </tr>\n";
+    myfile << "<tr> \n" << "<th align=right> Memory dense matrices (estimated) [MB] : </th> \n" << "<td>" << stats->memoryDense / 1048576.0 << "</td> </tr>\n";
+    myfile << "</table>\n";
+  }
+
   // Auxiliary Conditions
   myfile << "<h3> <a href=" << data->modelData->modelFilePrefix << "_AuxiliaryConditions.html" << " target=_blank> Auxiliary conditions </a> </h3>\n";
 
@@ -2453,6 +2533,691 @@ int RunReconciliation(DATA *data, threadData_t *threadData, inputData x, matrixD
   return 0;
 }
 
+/*
+ * Builds a sparse matrix in compressed sparse column format from
+ * triplets, duplicate entries are summed up
+ */
+sparseMatrixData sparseMatrixFromTriplets(int rows, int cols, vector<int> &rowIndex, vector<int> &colIndex, vector<double> &values)
+{
+  sparseMatrixData A;
+  A.rows = rows;
+  A.column = cols;
+  A.leadindex.assign(cols + 1, 0);
+
+  for (size_t k = 0; k < colIndex.size(); k++)
+  {
+    A.leadindex[colIndex[k] + 1]++;
+  }
+  for (int j = 0; j < cols; j++)
+  {
+    A.leadindex[j + 1] += A.leadindex[j];
+  }
+
+  vector<int> next(A.leadindex.begin(), A.leadindex.end() - 1);
+  vector< pair<int, double> > entries(values.size());
+  for (size_t k = 0; k < values.size(); k++)
+  {
+    entries[next[colIndex[k]]++] = make_pair(rowIndex[k], values[k]);
+  }
+
+  // sort every column by row and sum up duplicates
+  A.index.reserve(values.size());
+  A.data.reserve(values.size());
+  int nz = 0;
+  for (int j = 0; j < cols; j++)
+  {
+    sort(entries.begin() + A.leadindex[j], entries.begin() + A.leadindex[j + 1]);
+    int start = nz;
+    for (int k = A.leadindex[j]; k < A.leadindex[j + 1]; k++)
+    {
+      if (nz > start && A.index[nz - 1] == entries[k].first)
+      {
+        A.data[nz - 1] += entries[k].second;
+      }
+      else
+      {
+        A.index.push_back(entries[k].first);
+        A.data.push_back(entries[k].second);
+        nz++;
+      }
+    }
+    A.leadindex[j] = start;
+  }
+  A.leadindex[cols] = nz;
+  return A;
+}
+
+/*
+ * Function to transpose the sparse Matrix
+ */
+sparseMatrixData getSparseTransposeMatrix(sparseMatrixData &A)
+{
+  sparseMatrixData At;
+  At.rows = A.column;
+  At.column = A.rows;
+  At.leadindex.assign(A.rows + 1, 0);
+  At.index.resize(A.index.size());
+  At.data.resize(A.data.size());
+
+  for (size_t k = 0; k < A.index.size(); k++)
+  {
+    At.leadindex[A.index[k] + 1]++;
+  }
+  for (int i = 0; i < A.rows; i++)
+  {
+    At.leadindex[i + 1] += At.leadindex[i];
+  }
+
+  vector<int> next(At.leadindex.begin(), At.leadindex.end() - 1);
+  for (int j = 0; j < A.column; j++)
+  {
+    for (int k = A.leadindex[j]; k < A.leadindex[j + 1]; k++)
+    {
+      int pos = next[A.index[k]]++;
+      At.index[pos] = j;
+      At.data[pos] = A.data[k];
+    }
+  }
+  return At;
+}
+
+/*
+ * Sparse Matrix Multiplication C = A*B
+ */
+sparseMatrixData solveSparseMatrixMultiplication(sparseMatrixData &A, sparseMatrixData &B, ofstream &logfile, DATA * data)
+{
+  if (A.column != B.rows)
+  {
+    errorStreamPrint(LOG_STDOUT, 0, "solveSparseMatrixMultiplication() Failed!, Column of First Matrix not equal to Rows of Second Matrix %i != %i.", A.column, B.rows);
+    logfile << "|  error   |   " << "solveSparseMatrixMultiplication() Failed!, Column of First Matrix not equal to Rows of Second Matrix " << A.column << " != " << B.rows << "\n";
+    logfile.close();
+    createErrorHtmlReport(data);
+    exit(1);
+  }
+
+  sparseMatrixData C;
+  C.rows = A.rows;
+  C.column = B.column;
+  C.leadindex.assign(B.column + 1, 0);
+
+  // dense accumulator for one column of C
+  vector<double> work(A.rows, 0.0);
+  vector<int> mark(A.rows, -1);
+  vector<int> pattern;
+
+  for (int j = 0; j < B.column; j++)
+  {
+    pattern.clear();
+    for (int kb = B.leadindex[j]; kb < B.leadindex[j + 1]; kb++)
+    {
+      int k = B.index[kb];
+      double b = B.data[kb];
+      for (int ka = A.leadindex[k]; ka < A.leadindex[k + 1]; ka++)
+      {
+        int i = A.index[ka];
+        if (mark[i] != j)
+        {
+          mark[i] = j;
+          work[i] = 0.0;
+          pattern.push_back(i);
+        }
+        work[i] += A.data[ka] * b;
+      }
+    }
+    sort(pattern.begin(), pattern.end());
+    for (size_t p = 0; p < pattern.size(); p++)
+    {
+      C.index.push_back(pattern[p]);
+      C.data.push_back(work[pattern[p]]);
+    }
+    C.leadindex[j + 1] = C.index.size();
+  }
+  return C;
+}
+
+/*
+ * Sparse Matrix Vector Multiplication y = A*x or y = At*x
+ */
+void solveSparseMatrixVectorMultiplication(sparseMatrixData &A, double *x, double *y, bool transpose)
+{
+  if (transpose)
+  {
+    for (int j = 0; j < A.column; j++)
+    {
+      double sum = 0.0;
+      for (int k = A.leadindex[j]; k < A.leadindex[j + 1]; k++)
+      {
+        sum += A.data[k] * x[A.index[k]];
+      }
+      y[j] = sum;
+    }
+  }
+  else
+  {
+    for (int i = 0; i < A.rows; i++)
+    {
+      y[i] = 0.0;
+    }
+    for (int j = 0; j < A.column; j++)
+    {
+      for (int k = A.leadindex[j]; k < A.leadindex[j + 1]; k++)
+      {
+        y[A.index[k]] += A.data[k] * x[j];
+      }
+    }
+  }
+}
+
+/*
+ * Memory in bytes of the sparse Matrix
+ */
+size_t sparseMatrixMemory(sparseMatrixData &A)
+{
+  return A.leadindex.size() * sizeof(int) + A.index.size() * sizeof(int) + A.data.size() * sizeof(double);
+}
+
+/*
+ * Function to print the sparse Matrix as (row, column) value list
+ */
+void printSparseMatrix(sparseMatrixData &A, string name, ofstream & logfile)
+{
+  logfile << "\n" << "************ " << name << " **********" << "\n";
+  logfile << "size: " << A.rows << " x " << A.column << ", non-zero elements: " << A.index.size() << "\n";
+  for (int j = 0; j < A.column; j++)
+  {
+    for (int k = A.leadindex[j]; k < A.leadindex[j + 1]; k++)
+    {
+      logfile << "(" << A.index[k] << ", " << j << ") " << A.data[k] << "\n";
+    }
+  }
+}
+
+/*
+ * Function Which Computes the sparse Jacobian Matrix F
+ * using the coloring of the symbolic sparsity pattern,
+ * all columns of one color are evaluated with a single directional derivative
+ */
+sparseMatrixData getSparseJacobianMatrixF(DATA * data, threadData_t * threadData, ANALYTIC_JACOBIAN * jacobian, ofstream & logfile)
+{
+  const SPARSE_PATTERN *sp = jacobian->sparsePattern;
+  int cols = jacobian->sizeCols;
+
+  if (cols == 0 || sp == NULL)
+  {
+    errorStreamPrint(LOG_STDOUT, 0, "Cannot Compute sparse Jacobian Matrix F");
+    logfile << "|  error   |   " << "Cannot Compute sparse Jacobian Matrix F" << "\n";
+    logfile.close();
+    createErrorHtmlReport(data);
+    exit(1);
+  }
+
+  sparseMatrixData F;
+  F.rows = jacobian->sizeRows;
+  F.column = cols;
+  F.leadindex.assign(sp->leadindex, sp->leadindex + cols + 1);
+  F.index.assign(sp->index, sp->index + sp->numberOfNonZeros);
+  F.data.assign(sp->numberOfNonZeros, 0.0);
+
+  for (unsigned int color = 1; color <= sp->maxColors; color++)
+  {
+    for (int x = 0; x < cols; x++)
+    {
+      if (sp->colorCols[x] == color)
+      {
+        jacobian->seedVars[x] = 1.0;
+      }
+    }
+
+    data->callback->functionJacF_column(data, threadData, jacobian, NULL);
+
+    for (int x = 0; x < cols; x++)
+    {
+      if (sp->colorCols[x] == color)
+      {
+        for (int k = F.leadindex[x]; k < F.leadindex[x + 1]; k++)
+        {
+          F.data[k] = jacobian->resultVars[F.index[k]];
+        }
+        jacobian->seedVars[x] = 0.0;
+      }
+    }
+  }
+  return F;
+}
+
+/*
+ * Function which computes the sparse covariance matrix Sx,
+ * the diagonal (Sx/1.96)^2 plus the entries of the correlation coefficients
+ */
+sparseMatrixData computeSparseCovarianceMatrixSx(csvData &Sx_result, correlationData &Cx_data, ofstream &logfile, DATA * data)
+{
+  int n = Sx_result.rowcount;
+  vector<int> rowIndex, colIndex;
+  vector<double> values;
+  vector<double> diag(n);
+
+  for (int i = 0; i < n; i++)
+  {
+    diag[i] = pow(Sx_result.sxdata[i] / 1.96, 2);
+    rowIndex.push_back(i);
+    colIndex.push_back(i);
+    values.push_back(diag[i]);
+  }
+
+  // consider the correlation coefficients which are strictly below the diagonal entry
+  if (!Cx_data.data.empty())
+  {
+    for (unsigned int i = 0; i < Cx_data.rowHeaders.size(); i++)
+    {
+      for (unsigned int j = 0; j < i && j < Cx_data.columnHeaders.size(); j++)
+      {
+        double rx = Cx_data.data[Cx_data.columnHeaders.size() * i + j];
+        if (rx != 0)
+        {
+          int rowpos = getVariableIndex(Sx_result.headers, Cx_data.rowHeaders[i], logfile, data);
+          int colpos = getVariableIndex(Sx_result.headers, Cx_data.columnHeaders[j], logfile, data);
+          double tmprx = rx * sqrt(diag[rowpos]) * sqrt(diag[colpos]);
+
+          // insert the element and its symmetric position
+          rowIndex.push_back(rowpos);
+          colIndex.push_back(colpos);
+          values.push_back(tmprx);
+          rowIndex.push_back(colpos);
+          colIndex.push_back(rowpos);
+          values.push_back(tmprx);
+        }
+      }
+    }
+  }
+  return sparseMatrixFromTriplets(n, n, rowIndex, colIndex, values);
+}
+
+/*
+ * Initializes the factorization data of the (n x n) Matrix (F*Sx*Ft)
+ */
+void initSparseFactorization(sparseFactorData &L, int n)
+{
+  L.size = n;
+  L.nnz = 0;
+  L.memory = 0;
+#ifdef WITH_SUITESPARSE
+  klu_defaults(&L.common);
+  L.symbolic = NULL;
+  L.numeric = NULL;
+#endif
+}
+
+void freeSparseFactorization(sparseFactorData &L)
+{
+#ifdef WITH_SUITESPARSE
+  if (L.numeric)
+  {
+    klu_free_numeric(&L.numeric, &L.common);
+  }
+  if (L.symbolic)
+  {
+    klu_free_symbolic(&L.symbolic, &L.common);
+  }
+#endif
+}
+
+/*
+ * Factorizes the symmetric positive definite Matrix (F*Sx*Ft) with KLU,
+ * its pattern does not change between the iterations and is analyzed once.
+ * Without SuiteSparse the Matrix is factorized with the dense LAPACK LU.
+ */
+void solveSparseFactorization(sparseMatrixData &A, sparseFactorData &L, ofstream &logfile, DATA * data)
+{
+  int n = L.size;
+  bool failed;
+#ifdef WITH_SUITESPARSE
+  if (L.symbolic == NULL)
+  {
+    L.symbolic = klu_analyze(n, A.leadindex.data(), A.index.data(), &L.common);
+  }
+  if (L.numeric)
+  {
+    klu_free_numeric(&L.numeric, &L.common);
+  }
+  L.numeric = L.symbolic ? klu_factor(A.leadindex.data(), A.index.data(), A.data.data(), L.symbolic, &L.common) : NULL;
+  failed = (L.numeric == NULL || L.common.status != KLU_OK);
+  if (!failed)
+  {
+    L.nnz = L.numeric->lnz + L.numeric->unz;
+    L.memory = L.common.memusage;
+  }
+#else
+  int info = 0;
+  L.lu.assign((size_t) n * n, 0.0);
+  L.ipiv.resize(n);
+  for (int j = 0; j < A.column; j++)
+  {
+    for (int k = A.leadindex[j]; k < A.leadindex[j + 1]; k++)
+    {
+      L.lu[A.index[k] + (size_t) j * n] = A.data[k];
+    }
+  }
+  dgetrf_(&n, &n, L.lu.data(), &n, L.ipiv.data(), &info);
+  failed = (info != 0);
+  L.nnz = (size_t) n * n;
+  L.memory = L.lu.size() * sizeof(double) + L.ipiv.size() * sizeof(int);
+#endif
+  if (failed)
+  {
+    errorStreamPrint(LOG_STDOUT, 0, "solveSparseFactorization() Failed !, The Matrix F*Sx*Ft is singular.");
+    logfile << "|  error   |   " << "solveSparseFactorization() Failed !, The Matrix F*Sx*Ft is singular." << "\n";
+    logfile.close();
+    createErrorHtmlReport(data);
+    exit(1);
+  }
+}
+
+/*
+ * Solve the Linear System (F*Sx*Ft)*x=b with the factorization,
+ * b will be overridden with the solution
+ */
+void solveSparseSystem(sparseFactorData &L, double *b)
+{
+#ifdef WITH_SUITESPARSE
+  klu_solve(L.symbolic, L.numeric, L.size, 1, b, &L.common);
+#else
+  char trans = 'N';
+  int nrhs = 1, info = 0;
+  dgetrs_(&trans, &L.size, &nrhs, L.lu.data(), &L.size, L.ipiv.data(), b, &L.size, &info);
+#endif
+}
+
+/*
+ * Solves the system column by column
+ * recon_Sx = Sx - (F*Sx)t*(F*Sx*Ft)^-1*(F*Sx)
+ * and writes the result row by row to the csv file, only the
+ * diagonal elements are kept in memory. Zero entries are left
+ * empty and every row ends at its last non-zero entry, missing
+ * entries are read as zero (-reconcileBoundaryConditions)
+ */
+void solveSparseReconciledSx(sparseMatrixData &Sx, sparseMatrixData &FSx, sparseFactorData &L, vector<string> &headers, double *reconSx_diag, DATA * data)
+{
+  ofstream csvfile;
+  std::stringstream csv_file;
+  if (omc_flag[FLAG_OUTPUT_PATH])
+  {
+    csv_file << string(omc_flagValue[FLAG_OUTPUT_PATH]) << "/" << data->modelData->modelName << "_Reconciled_Sx.csv";
+  }
+  else
+  {
+    csv_file << data->modelData->modelName << "_Reconciled_Sx.csv";
+  }
+  csvfile.open(csv_file.str().c_str());
+
+  csvfile << "Sxij" << ",";
+  for (auto it : headers)
+  {
+    csvfile << it << ",";
+  }
+  csvfile << "\n";
+
+  int n = Sx.column;
+  vector<double> rhs(FSx.rows, 0.0);
+  vector<double> column(n);
+
+  for (int j = 0; j < n; j++)
+  {
+    // rhs = (F*Sx)(:,j)
+    fill(rhs.begin(), rhs.end(), 0.0);
+    for (int k = FSx.leadindex[j]; k < FSx.leadindex[j + 1]; k++)
+    {
+      rhs[FSx.index[k]] = FSx.data[k];
+    }
+    solveSparseSystem(L, rhs.data());
+    solveSparseMatrixVectorMultiplication(FSx, rhs.data(), column.data(), true);
+
+    for (int i = 0; i < n; i++)
+    {
+      column[i] = -column[i];
+    }
+    for (int k = Sx.leadindex[j]; k < Sx.leadindex[j + 1]; k++)
+    {
+      column[Sx.index[k]] += Sx.data[k];
+    }
+    reconSx_diag[j] = column[j];
+
+    // recon_Sx is symmetric, column j is written as row j
+    int last = n - 1;
+    while (last >= 0 && column[last] == 0)
+    {
+      last--;
+    }
+    csvfile << headers[j] << ",";
+    for (int i = 0; i <= last; i++)
+    {
+      if (column[i] != 0)
+      {
+        csvfile << column[i];
+      }
+      csvfile << ",";
+    }
+    csvfile << "\n";
+  }
+  csvfile.flush();
+  csvfile.close();
+}
+
+/*
+ * Sparse variant of RunReconciliation (-reconcileSparse)
+ * F is evaluated with the colored sparsity pattern, Sx is kept sparse
+ * and (F*Sx*Ft) is factorized with KLU,
+ * the convergence test uses Sx^-1*(recon_x-x) = -Ft*f*
+ * so that Sx has never to be factorized
+ */
+int RunSparseReconciliation(DATA *data, threadData_t *threadData, inputData x, sparseMatrixData &Sx, double eps, csvData &csvinputs, matrixData xdiag, matrixData sxdiag, ofstream &logfile, correlationDataWarning &warningCorrelationData, reconciliationStatistics &stats)
+{
+  rtclock_t clock;
+  int n = x.rows;
+  int r = data->modelData->nSetcVars;
+  int iterationcount = 1;
+  double value = 0;
+
+  const int index = data->callback->INDEX_JAC_F;
+  ANALYTIC_JACOBIAN *jacobian = &(data->simulationInfo->analyticJacobians[index]);
+  data->callback->initialAnalyticJacobianF(data, threadData, jacobian);
+
+  double *reconciledX = (double*) calloc(n, sizeof(double));
+  double *setc = (double*) calloc(r, sizeof(double));
+  double *fstar = (double*) calloc(r, sizeof(double));
+  double *F_recon_x_x = (double*) calloc(r, sizeof(double));
+  vector<double> recon_x_x(n);
+  sparseMatrixData FSx;
+  sparseFactorData L;
+  initSparseFactorization(L, r);
+
+  while (true)
+  {
+    // set the inputs from csv file to simulationInfo datainputVars
+    for (int i = 0; i < n; i++)
+    {
+      data->simulationInfo->datainputVars[i] = x.data[i];
+    }
+    data->callback->data_function(data, threadData);
+    data->callback->functionDAE(data, threadData);
+    data->callback->setc_function(data, threadData);
+
+    rt_ext_tp_tick(&clock);
+    sparseMatrixData jacF = getSparseJacobianMatrixF(data, threadData, jacobian, logfile);
+    stats.timeJacobian += rt_ext_tp_tock(&clock);
+    if (ACTIVE_STREAM(LOG_JAC))
+    {
+      printSparseMatrix(jacF, "F", logfile);
+    }
+
+    if (jacF.column != Sx.rows || jacF.rows != r)
+    {
+      errorStreamPrint(LOG_STDOUT, 0, "RunSparseReconciliation() Failed!, Dimension of Jacobian Matrix F %i x %i does not match %i x %i.", jacF.rows, jacF.column, r, Sx.rows);
+      logfile << "|  error   |   " << "RunSparseReconciliation() Failed!, Dimension of Jacobian Matrix F " << jacF.rows << " x " << jacF.column << " does not match " << r << " x " << Sx.rows << "\n";
+      logfile.close();
+      createErrorHtmlReport(data);
+      exit(1);
+    }
+
+    /* loop to store the data C(x,y) rhs side, get the elements in reverse order */
+    for (int i = 0; i < r; i++)
+    {
+      setc[i] = data->simulationInfo->setcVars[r - 1 - i];
+      fstar[i] = setc[i];
+    }
+
+    // F*Sx and (F*Sx)*Ft
+    rt_ext_tp_tick(&clock);
+    FSx = solveSparseMatrixMultiplication(jacF, Sx, logfile, data);
+    sparseMatrixData jacFt = getSparseTransposeMatrix(jacF);
+    sparseMatrixData FSxFt = solveSparseMatrixMultiplication(FSx, jacFt, logfile, data);
+    stats.timeAssembly += rt_ext_tp_tock(&clock);
+
+    rt_ext_tp_tick(&clock);
+    solveSparseFactorization(FSxFt, L, logfile, data);
+    stats.timeFactorization += rt_ext_tp_tock(&clock);
+
+    stats.nnzF = jacF.index.size();
+    stats.nnzFSxFt = FSxFt.index.size();
+    stats.nnzFactor = L.nnz;
+    stats.memorySparse = max(stats.memorySparse, sparseMatrixMemory(jacF) + sparseMatrixMemory(jacFt) + sparseMatrixMemory(Sx) + sparseMatrixMemory(FSx)
+                                                 + sparseMatrixMemory(FSxFt) + L.memory);
+
+    if (ACTIVE_STREAM(LOG_JAC))
+    {
+      logfile << "Calculations of Matrix (F*Sx*Ft) f* = c(x,y) " << "\n";
+      logfile << "============================================\n";
+      printSparseMatrix(FSx, "F*Sx", logfile);
+      printSparseMatrix(FSxFt, "F*Sx*Ft", logfile);
+      printMatrix(setc, r, 1, "c(x,y)", logfile);
+    }
+
+    /*
+     * calculate f* for covariance matrix (F*Sx*Ftranspose).f*= c(x,y)
+     * and recon_x = x - (F*Sx)t*f*
+     */
+    rt_ext_tp_tick(&clock);
+    solveSparseSystem(L, fstar);
+    solveSparseMatrixVectorMultiplication(FSx, fstar, reconciledX, true);
+    for (int i = 0; i < n; i++)
+    {
+      reconciledX[i] = x.data[i] - reconciledX[i];
+    }
+
+    /*
+     * J* = (recon_x-x)T*(Sx^-1)*(recon_x-x)+2.[f+F*(recon_x-x)]T*fstar
+     * with (Sx^-1)*(recon_x-x) = -Ft*f*
+     */
+    for (int i = 0; i < n; i++)
+    {
+      recon_x_x[i] = reconciledX[i] - x.data[i];
+    }
+    solveSparseMatrixVectorMultiplication(jacF, recon_x_x.data(), F_recon_x_x, false);
+    double lhs = 0.0, rhs = 0.0;
+    for (int i = 0; i < r; i++)
+    {
+      lhs -= F_recon_x_x[i] * fstar[i];
+      rhs += (setc[i] + F_recon_x_x[i]) * fstar[i];
+    }
+    value = (lhs + 2.0 * rhs) / r;
+    stats.timeSolve += rt_ext_tp_tock(&clock);
+
+    if (ACTIVE_STREAM(LOG_JAC))
+    {
+      printMatrix(fstar, r, 1, "f*", logfile);
+      printMatrix(reconciledX, n, 1, "x - ((F*Sx)t*f*))", logfile);
+      logfile << "***** Completed ****** \n\n";
+    }
+
+    if (value <= eps)
+    {
+      break;
+    }
+
+    logfile << "J*/r" << "(" << value << ")" << " > " << eps << ", Value not Converged \n";
+    logfile << "==========================================\n\n";
+    logfile << "Running Convergence iteration: " << iterationcount << " with the following reconciled values:" << "\n";
+    logfile << "========================================================================" << "\n";
+    printMatrixWithHeaders(reconciledX, n, 1, csvinputs.headers, "reconciled_X ===> (x - (Sx*Ft*fstar))", logfile);
+    memcpy(x.data, reconciledX, n * sizeof(double));
+    iterationcount++;
+  }
+
+  if (iterationcount == 1)
+  {
+    logfile << "J*/r" << "(" << value << ")" << " > " << eps << ", Convergence iteration not required \n\n";
+  }
+  else
+  {
+    logfile << "***** Value Converged, Convergence Completed******* \n\n";
+  }
+  logfile << "Final Results:\n";
+  logfile << "=============\n";
+  logfile << "Total Iteration to Converge : " << iterationcount << "\n";
+  logfile << "Final Converged Value(J*/r) : " << value << "\n";
+  logfile << "Epsilon                     : " << eps << "\n";
+  printMatrixWithHeaders(reconciledX, n, 1, csvinputs.headers, "reconciled_X ===> (x - (Sx*Ft*fstar))", logfile);
+
+  // reconciled Sx is dense, it is only written to the csv file
+  double *reconSx_diag = (double*) calloc(n, sizeof(double));
+  rt_ext_tp_tick(&clock);
+  solveSparseReconciledSx(Sx, FSx, L, csvinputs.headers, reconSx_diag, data);
+  stats.timeReconciledSx = rt_ext_tp_tock(&clock);
+  freeSparseFactorization(L);
+  printMatrixWithHeaders(reconSx_diag, n, 1, csvinputs.headers, "reconciled_Sx_Diagonal ===> (Sx - (Sx*Ft*Fstar))", logfile);
+
+  /*
+   * Calculate half width Confidence interval
+   * W=lambda*sqrt(Sx)
+   */
+  matrixData copyreconSx_diag = {n, 1, reconSx_diag};
+  matrixData tmpcopyreconSx_diag = copyMatrix(copyreconSx_diag);
+  calculateSquareRoot(copyreconSx_diag.data, n);
+  scaleVector(n, 1, 1.96, copyreconSx_diag.data);
+  printMatrixWithHeaders(copyreconSx_diag.data, n, 1, csvinputs.headers, "Wx-HalfWidth-Interval-(1.96)*sqrt(Sx_diagonal)", logfile);
+
+  /*
+   * Calculate individual tests
+   * (recon_x - x)/sqrt(Sx-recon_Sx)
+   */
+  double *newSx_diag = (double*) calloc(n, sizeof(double));
+  solveMatrixSubtraction(sxdiag, tmpcopyreconSx_diag, newSx_diag, logfile, data);
+  calculateSquareRoot(newSx_diag, n);
+
+  matrixData reconciled_X = {n, 1, reconciledX};
+  double *newX = (double*) calloc(n, sizeof(double));
+  solveMatrixSubtraction(reconciled_X, xdiag, newX, logfile, data);
+  for (int val = 0; val < n; val++)
+  {
+    newX[val] = fabs(newX[val]) / max(newSx_diag[val], sqrt(sxdiag.data[val] / 10));
+  }
+  printMatrixWithHeaders(newX, n, 1, csvinputs.headers, "IndividualTests_Value- (recon_x-x)/sqrt(Sx_diag)", logfile);
+
+  // memory of the dense algorithm: Sx, recon_Sx, (Sx*Ft)*F* and the copy of Sx, F and its copies, F*Sx*Ft
+  stats.memoryDense = sizeof(double) * (4.0 * n * n + 5.0 * r * n + 2.0 * r * r);
+
+  logfile << "\n" << "Sparse reconciliation statistics:\n";
+  logfile << "================================\n";
+  logfile << "non-zero elements F / Sx / F*Sx*Ft / factorization : " << stats.nnzF << " / " << stats.nnzSx << " / " << stats.nnzFSxFt << " / " << stats.nnzFactor << "\n";
+  logfile << "time covariance / jacobian / assembly / factorization / solve / reconciled Sx [s] : " << stats.timeCovariance << " / " << stats.timeJacobian << " / " << stats.timeAssembly << " / " << stats.timeFactorization << " / " << stats.timeSolve << " / " << stats.timeReconciledSx << "\n";
+  logfile << "memory sparse / dense (estimated) [MB] : " << stats.memorySparse / 1048576.0 << " / " << stats.memoryDense / 1048576.0 << "\n";
+
+  free(setc);
+  free(fstar);
+  free(F_recon_x_x);
+  free(tmpcopyreconSx_diag.data);
+  free(newSx_diag);
+
+  // create HTML Report for D.1
+  stats.timeTotal = stats.timeCovariance + stats.timeJacobian + stats.timeAssembly + stats.timeFactorization + stats.timeSolve + stats.timeReconciledSx;
+  createHtmlReportFordataReconciliation(data, csvinputs, xdiag, reconciled_X, copyreconSx_diag, newX, eps, iterationcount, value, warningCorrelationData, &stats);
+
+  free(reconciledX);
+  free(reconSx_diag);
+  free(newX);
+  freeAnalyticJacobian(jacobian);
+  return 0;
+}
+
 /*
  * Runs the numerical procedure to compute constraint equation (D.1)
 */
@@ -2513,6 +3278,53 @@ int dataReconciliation(DATA * data, threadData_t * threadData, int status)
   // read the correlation coefficient input data provide by user
   correlationData Cx_data = readCorrelationCoefficientFile(Sx_data, logfile, data);
 
+  if (omc_flag[FLAG_DATA_RECONCILE_SPARSE])
+  {
+    reconciliationStatistics stats = {0};
+    rtclock_t clock;
+
+    // Compute the sparse covariance matrix (Sx) from csvData
+    rt_ext_tp_tick(&clock);
+    sparseMatrixData Sx = computeSparseCovarianceMatrixSx(Sx_data, Cx_data, logfile, data);
+    stats.timeCovariance = rt_ext_tp_tock(&clock);
+    stats.nnzSx = Sx.index.size();
+
+    double *Sx_diag = (double*) calloc(Sx.rows, sizeof(double));
+    for (int j = 0; j < Sx.column; j++)
+    {
+      for (int k = Sx.leadindex[j]; k < Sx.leadindex[j + 1]; k++)
+      {
+        if (Sx.index[k] == j)
+        {
+          Sx_diag[j] = Sx.data[k];
+        }
+      }
+    }
+    matrixData tmpSx_diag = {Sx.rows, 1, Sx_diag};
+    matrixData tmp_x = {x.rows, x.column, x.data};
+    matrixData x_diag = copyMatrix(tmp_x);
+
+    correlationDataWarning warningCorrelationData;
+    logfile << "\n\nInitial Data \n" << "=============\n";
+    printMatrixWithHeaders(x.data, x.rows, x.column, Sx_data.headers, "X", logfile);
+    printVectorMatrixWithHeaders(Sx_data.sxdata, Sx_data.rowcount, 1, Sx_data.headers, "Half-WidthConfidenceInterval", logfile);
+    printCorelationMatrix(Cx_data.data, Cx_data.rowHeaders, Cx_data.columnHeaders, "Co-Relation_Coefficient", logfile, warningCorrelationData);
+    if (ACTIVE_STREAM(LOG_JAC))
+    {
+      printSparseMatrix(Sx, "Sx", logfile);
+    }
+
+    RunSparseReconciliation(data, threadData, x, Sx, atof(epselon), Sx_data, x_diag, tmpSx_diag, logfile, warningCorrelationData, stats);
+    logfile << "|  info    |   " << "DataReconciliation Completed! \n";
+    logfile.flush();
+    logfile.close();
+    free(x.data);
+    free(tmpSx_diag.data);
+    free(x_diag.data);
+    TRACE_POP
+    return 0;
+  }
+
   // Compute the covariance matrix (Sx) from csvData
   matrixData Sx = computeCovarianceMatrixSx(Sx_data, Cx_data, logfile, data);
 
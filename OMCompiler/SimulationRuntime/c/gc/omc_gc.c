@@ -42,6 +42,8 @@
 #include "../util/omc_error.h"
 #include "../util/omc_file.h"
 #include "../util/omc_init.h"
+#include "../meta/meta_modelica_data.h"
+#include <string.h>
 
 static mmc_GC_state_type x_mmc_GC_state = {0};
 mmc_GC_state_type *mmc_GC_state = &x_mmc_GC_state;
@@ -126,4 +128,227 @@ size_t omc_GC_get_max_heap_size()
 {
   return max_heap_size;
 }
+
+/* Time in seconds spent in full collections, if the GC can measure it */
+double omc_GC_get_total_time()
+{
+#if defined(GC_VERSION_MAJOR) && (GC_VERSION_MAJOR >= 8)
+  return GC_get_full_gc_total_time() / 1000.0;
+#else
+  return 0.0;
+#endif
+}
+
+/* Region allocation, see omc_gc.h.
+ * A region is a list of chunks allocated as uncollectable GC objects, so the GC
+ * scans them for pointers to the GC heap, but never looks at the individual
+ * objects in them. Leaving a region copies the live data out of it (Cheney
+ * style, using the RML forwarding headers) and frees all chunks. */
+
+#define OMC_REGION_MIN_CHUNK (1024*1024)
+#define OMC_REGION_MAX_CHUNK (64*1024*1024)
+
+typedef struct {
+  char *begin;
+  char *end;
+} omc_region_chunk;
+
+typedef struct omc_region {
+  struct omc_region *parent;
+  char *cur;
+  char *limit;
+  omc_region_chunk *chunks; /* sorted by address */
+  size_t nchunks;
+  size_t capchunks;
+  size_t nextChunkSize;
+} omc_region;
+
+int omc_gc_regions_active = 0;
+static pthread_key_t omc_region_key;
+static pthread_once_t omc_region_key_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t omc_region_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void omc_region_make_key(void)
+{
+  pthread_key_create(&omc_region_key, NULL);
+}
+
+static omc_region* omc_region_current(void)
+{
+  pthread_once(&omc_region_key_once, omc_region_make_key);
+  return (omc_region*) pthread_getspecific(omc_region_key);
+}
+
+int omc_region_is_active(void)
+{
+  return omc_gc_regions_active && omc_region_current() != NULL;
+}
+
+static void omc_region_new_chunk(omc_region *r, size_t minBytes)
+{
+  size_t sz = r->nextChunkSize, i;
+  char *mem;
+  if (sz < minBytes) {
+    sz = minBytes;
+  }
+  mem = (char*) mmc_check_out_of_memory(GC_malloc_uncollectable(sz));
+  if (r->nchunks == r->capchunks) {
+    r->capchunks = r->capchunks ? 2*r->capchunks : 16;
+    r->chunks = (omc_region_chunk*) realloc(r->chunks, r->capchunks*sizeof(omc_region_chunk));
+    if (!r->chunks) {
+      mmc_do_out_of_memory();
+    }
+  }
+  for (i = r->nchunks; i > 0 && r->chunks[i-1].begin > mem; i--) {
+    r->chunks[i] = r->chunks[i-1];
+  }
+  r->chunks[i].begin = mem;
+  r->chunks[i].end = mem + sz;
+  r->nchunks++;
+  r->cur = mem;
+  r->limit = mem + sz;
+  if (r->nextChunkSize < OMC_REGION_MAX_CHUNK) {
+    r->nextChunkSize *= 2;
+  }
+}
+
+void* omc_region_alloc_words(unsigned int nwords, int atomic)
+{
+  omc_region *r = omc_region_current();
+  size_t sz = nwords * sizeof(void*);
+  void *res;
+  if (r == NULL) {
+    /* Another thread is in a region */
+    return mmc_check_out_of_memory(atomic ? GC_malloc_atomic(sz) : GC_malloc(sz));
+  }
+  if ((size_t)(r->limit - r->cur) < sz) {
+    omc_region_new_chunk(r, sz);
+  }
+  res = r->cur;
+  r->cur += sz;
+  /* The chunks are not cleared; the GC malloc functions return zeroed memory */
+  memset(res, 0, sz);
+  return res;
+}
+
+void omc_region_enter(void)
+{
+  omc_region *r = (omc_region*) calloc(1, sizeof(omc_region));
+  if (!r) {
+    mmc_do_out_of_memory();
+  }
+  r->parent = omc_region_current();
+  r->nextChunkSize = OMC_REGION_MIN_CHUNK;
+  pthread_setspecific(omc_region_key, r);
+  pthread_mutex_lock(&omc_region_mutex);
+  omc_gc_regions_active++;
+  pthread_mutex_unlock(&omc_region_mutex);
+}
+
+static int omc_region_contains(omc_region *r, void *p)
+{
+  size_t lo = 0, hi = r->nchunks;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if ((char*)p < r->chunks[mid].begin) {
+      hi = mid;
+    } else if ((char*)p >= r->chunks[mid].end) {
+      lo = mid + 1;
+    } else {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+typedef struct {
+  omc_region *region;
+  void **stack;
+  size_t size;
+  size_t capacity;
+} omc_region_copy;
+
+static void* omc_region_copy_object(omc_region_copy *c, void *x)
+{
+  mmc_uint_t *p, hdr;
+  size_t nwords;
+  mmc_uint_t *res;
+  if (MMC_IS_IMMEDIATE(x)) {
+    return x;
+  }
+  p = (mmc_uint_t*) MMC_UNTAGPTR(x);
+  if (!omc_region_contains(c->region, p)) {
+    return x;
+  }
+  hdr = *p;
+  if (MMC_HDR_IS_FORWARD(hdr)) {
+    return MMC_TAGPTR((void*)(hdr - 3));
+  }
+  nwords = MMC_HDRSLOTS(hdr) + 1;
+  /* Allocated in the parent region if there is one, otherwise in the GC heap */
+  res = (mmc_uint_t*) (MMC_HDRISSTRUCT(hdr) ? mmc_alloc_words(nwords) : mmc_alloc_words_atomic(nwords));
+  memcpy(res, p, nwords * sizeof(void*));
+  *p = (mmc_uint_t) res + 3;
+  if (MMC_HDRISSTRUCT(hdr) && nwords > 1) {
+    if (c->size == c->capacity) {
+      c->capacity = c->capacity ? 2*c->capacity : 1024;
+      c->stack = (void**) realloc(c->stack, c->capacity*sizeof(void*));
+      if (!c->stack) {
+        mmc_do_out_of_memory();
+      }
+    }
+    c->stack[c->size++] = res;
+  }
+  return MMC_TAGPTR(res);
+}
+
+static void* omc_region_copy_out(omc_region_copy *c, void *x)
+{
+  x = omc_region_copy_object(c, x);
+  while (c->size > 0) {
+    void **obj = (void**) c->stack[--c->size];
+    size_t i, n = MMC_HDRSLOTS(*(mmc_uint_t*)obj);
+    for (i = 1; i <= n; i++) {
+      obj[i] = omc_region_copy_object(c, obj[i]);
+    }
+  }
+  return x;
+}
+
+void* omc_region_leave(void *data)
+{
+  omc_region_copy c = {0};
+  omc_region *r = omc_region_current();
+  threadData_t *threadData = (threadData_t*) pthread_getspecific(mmc_thread_data_key);
+  size_t i;
+  if (r == NULL) {
+    return data;
+  }
+  /* Copy into the enclosing region (or the GC heap) */
+  pthread_setspecific(omc_region_key, r->parent);
+  c.region = r;
+  data = omc_region_copy_out(&c, data);
+  for (i = 0; i < MMC_GC_GLOBAL_ROOTS_SIZE; i++) {
+    if (mmc_GC_state->global_roots[i]) {
+      mmc_GC_state->global_roots[i] = omc_region_copy_out(&c, mmc_GC_state->global_roots[i]);
+    }
+  }
+  if (threadData) {
+    for (i = 0; i < MAX_LOCAL_ROOTS; i++) {
+      if (threadData->localRoots[i]) {
+        threadData->localRoots[i] = omc_region_copy_out(&c, threadData->localRoots[i]);
+      }
+    }
+  }
+  free(c.stack);
+  for (i = 0; i < r->nchunks; i++) {
+    GC_free(r->chunks[i].begin);
+  }
+  free(r->chunks);
+  free(r);
+  pthread_mutex_lock(&omc_region_mutex);
+  omc_gc_regions_active--;
+  pthread_mutex_unlock(&omc_region_mutex);
+  return data;
+}
 #endif
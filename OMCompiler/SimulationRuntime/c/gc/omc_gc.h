@@ -197,6 +197,21 @@ static inline void* mmc_check_out_of_memory(void *ptr)
 
 void omc_GC_set_max_heap_size(size_t);
 size_t omc_GC_get_max_heap_size();
+double omc_GC_get_total_time();
+
+/* Region allocation.
+ * After omc_region_enter the MetaModelica data allocated by the calling thread
+ * is bump-allocated in a region instead of the GC heap. omc_region_leave copies
+ * the data reachable from its argument and from the global and thread-local
+ * roots out of the region and frees the region in one go. Anything else that
+ * points into the region is dangling afterwards, i.e. the code running in the
+ * region must not store new data in objects created before the region. */
+#define OMC_GC_REGIONS
+extern int omc_gc_regions_active;
+void omc_region_enter(void);
+void* omc_region_leave(void *data);
+int omc_region_is_active(void);
+void* omc_region_alloc_words(unsigned int nwords, int atomic);
 
 #endif /* #if (defined(OMC_MINIMAL_RUNTIME) || defined(OMC_FMI_RUNTIME)) */
 
@@ -225,6 +240,9 @@ static inline void mmc_GC_init(void)
   GC_register_displacement(3);
 #endif
   GC_set_force_unmap_on_gcollect(1);
+#if defined(OMC_GC_REGIONS) && defined(GC_VERSION_MAJOR) && (GC_VERSION_MAJOR >= 8)
+  GC_start_performance_measurement();
+#endif
 }
 
 static inline void mmc_GC_init_default(void)
@@ -243,6 +261,11 @@ void mmc_set_current_pos(const char *str);
 static inline void* mmc_alloc_words_atomic(unsigned int nwords) {
 #if defined(OMC_RECORD_ALLOC_WORDS)
   mmc_record_alloc_words((nwords) * sizeof(void*));
+#endif
+#if defined(OMC_GC_REGIONS)
+  if (omc_gc_regions_active) {
+    return omc_region_alloc_words(nwords, 1);
+  }
 #endif
   GC_RETURN_REPORT_ALLOC_FAILED(GC_malloc_atomic((nwords) * sizeof(void*)));
 }
@@ -250,6 +273,11 @@ static inline void* mmc_alloc_words_atomic(unsigned int nwords) {
 static inline void* mmc_alloc_words(unsigned int nwords) {
 #if defined(OMC_RECORD_ALLOC_WORDS)
   mmc_record_alloc_words((nwords) * sizeof(void*));
+#endif
+#if defined(OMC_GC_REGIONS)
+  if (omc_gc_regions_active) {
+    return omc_region_alloc_words(nwords, 0);
+  }
 #endif
   GC_RETURN_REPORT_ALLOC_FAILED(GC_malloc((nwords) * sizeof(void*)));
 }
@@ -258,6 +286,11 @@ static inline void* mmc_alloc_words(unsigned int nwords) {
 static inline void* mmc_alloc_words_atomic_ignore_off_page(unsigned int nwords) {
 #if defined(OMC_RECORD_ALLOC_WORDS)
   mmc_record_alloc_words((nwords) * sizeof(void*));
+#endif
+#if defined(OMC_GC_REGIONS)
+  if (omc_gc_regions_active) {
+    return omc_region_alloc_words(nwords, 1);
+  }
 #endif
   GC_RETURN_REPORT_ALLOC_FAILED(GC_malloc_atomic_ignore_off_page((nwords) * sizeof(void*)));
 }
@@ -266,6 +299,11 @@ static inline void* mmc_alloc_words_atomic_ignore_off_page(unsigned int nwords)
 static inline void* mmc_alloc_words_ignore_off_page(unsigned int nwords) {
 #if defined(OMC_RECORD_ALLOC_WORDS)
   mmc_record_alloc_words((nwords) * sizeof(void*));
+#endif
+#if defined(OMC_GC_REGIONS)
+  if (omc_gc_regions_active) {
+    return omc_region_alloc_words(nwords, 1);
+  }
 #endif
   GC_RETURN_REPORT_ALLOC_FAILED(GC_malloc_atomic_ignore_off_page((nwords) * sizeof(void*)));
 }
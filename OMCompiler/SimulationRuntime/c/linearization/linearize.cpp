@@ -28,8 +28,14 @@
  *
  */
 
+#ifdef USE_PARJAC
+  #define GC_THREADS
+  #include <gc/omc_gc.h>
+#endif
+
 #include "util/omc_error.h"
 #include "util/omc_file.h"
+#include "util/parallel_helper.h"
 #include "simulation_data.h"
 #include "openmodelica_func.h"
 #include "simulation/solver/external_input.h"
@@ -39,6 +45,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <cstring>
 
 using namespace std;
 
@@ -104,6 +111,136 @@ static string array2PythonString(double* array, int row, int col)
   return retVal.str();
 }
 
+/* Name of the generated files without extension. With several points of time
+ * (flag -l=t1,t2,...) the files are numbered in the order of the times. */
+static string linearizationFileName(DATA* data)
+{
+  ostringstream name(ostringstream::out);
+  /* ticket #5927: Don't use the model name to prevent bad names for certain languages. */
+  name << "linearized_model";
+  if (data->simulationInfo->nLinearizationTimes > 0) {
+    name << "_" << (data->simulationInfo->nextLinearizationTime + 1);
+  }
+  return name.str();
+}
+
+static void writeMatrixMarketHeader(FILE* fout, int row, int col, int nnz)
+{
+  fprintf(fout, "%%%%MatrixMarket matrix coordinate real general\n");
+  fprintf(fout, "%d %d %d\n", row, col, nnz);
+}
+
+/* Writes a dense column-major matrix in MatrixMarket coordinate format, zeros are skipped. */
+static void writeMatrixMarketDense(FILE* fout, double* array, int row, int col)
+{
+  int i, nnz = 0;
+  for(i=0; i<row*col; i++) {
+    if(array[i] != 0.0) {
+      nnz++;
+    }
+  }
+  writeMatrixMarketHeader(fout, row, col, nnz);
+  for(i=0; i<row*col; i++) {
+    if(array[i] != 0.0) {
+      fprintf(fout, "%d %d %.16g\n", i % row + 1, i / row + 1, array[i]);
+    }
+  }
+}
+
+/* Writes a matrix given by a sparsity pattern (compressed sparse column) and the
+ * values of its non-zeros in MatrixMarket coordinate format. */
+static void writeMatrixMarketSparse(FILE* fout, SPARSE_PATTERN* sparsePattern, double* values, int row, int col)
+{
+  int i;
+  unsigned int nz;
+  writeMatrixMarketHeader(fout, row, col, sparsePattern->numberOfNonZeros);
+  for(i=0; i<col; i++) {
+    for(nz=sparsePattern->leadindex[i]; nz<sparsePattern->leadindex[i+1]; nz++) {
+      fprintf(fout, "%u %d %.16g\n", sparsePattern->index[nz] + 1, i + 1, values[nz]);
+    }
+  }
+}
+
+static void writeMatrixMarketVector(FILE* fout, double* array, int size)
+{
+  int i;
+  fprintf(fout, "%%%%MatrixMarket matrix array real general\n");
+  fprintf(fout, "%d 1\n", size);
+  for(i=0; i<size; i++) {
+    fprintf(fout, "%.16g\n", array[i]);
+  }
+}
+
+/* Seeds all columns of one color and stores the non-zeros of these columns in values. */
+static void functionJacSparseColor(DATA* data, threadData_t *threadData, ANALYTIC_JACOBIAN* jacobian,
+                                   analyticalJacobianColumn_func_ptr jacobianColumn, unsigned int color, double* values)
+{
+  SPARSE_PATTERN* sparsePattern = jacobian->sparsePattern;
+  unsigned int j, nz;
+
+  for(j=0; j < jacobian->sizeCols; j++) {
+    jacobian->seedVars[j] = (sparsePattern->colorCols[j]-1 == color) ? 1.0 : 0.0;
+  }
+
+  jacobianColumn(data, threadData, jacobian, NULL);
+
+  for(j=0; j < jacobian->sizeCols; j++) {
+    if(sparsePattern->colorCols[j]-1 == color) {
+      for(nz=sparsePattern->leadindex[j]; nz<sparsePattern->leadindex[j+1]; nz++) {
+        values[nz] = jacobian->resultVars[sparsePattern->index[nz]];
+      }
+    }
+  }
+}
+
+/*  Calculate the non-zeros of a symbolic jacobian in the order of its sparse pattern,
+ *  with one evaluation per color. The colors are distributed over threads with -jacobianThreads. */
+static void functionJacSparse(DATA* data, threadData_t *threadData, ANALYTIC_JACOBIAN* jacobian,
+                              analyticalJacobianColumn_func_ptr jacobianColumn, double* values)
+{
+  SPARSE_PATTERN* sparsePattern = jacobian->sparsePattern;
+  int color;
+
+  if (jacobian->constantEqns != NULL) {
+    jacobian->constantEqns(data, threadData, jacobian, NULL);
+  }
+
+#ifdef USE_PARJAC
+  GC_allow_register_threads();
+
+#pragma omp parallel shared(data, threadData, jacobian, jacobianColumn, values, sparsePattern) private(color)
+  {
+  /* Register omp-thread in GC */
+  if(!GC_thread_is_registered()) {
+     struct GC_stack_base sb;
+     memset (&sb, 0, sizeof(sb));
+     GC_get_stack_base(&sb);
+     GC_register_my_thread (&sb);
+  }
+
+  /* thread local copy, the constant equations are already part of tmpVars */
+  ANALYTIC_JACOBIAN t_jac = *jacobian;
+  t_jac.seedVars = (double*) calloc(jacobian->sizeCols, sizeof(double));
+  t_jac.resultVars = (double*) calloc(jacobian->sizeRows, sizeof(double));
+  t_jac.tmpVars = (double*) malloc(jacobian->sizeTmpVars * sizeof(double));
+  memcpy(t_jac.tmpVars, jacobian->tmpVars, jacobian->sizeTmpVars * sizeof(double));
+
+#pragma omp for schedule(runtime)
+  for(color=0; color < (int) sparsePattern->maxColors; color++) {
+    functionJacSparseColor(data, threadData, &t_jac, jacobianColumn, color, values);
+  }
+
+  free(t_jac.seedVars);
+  free(t_jac.resultVars);
+  free(t_jac.tmpVars);
+  } // omp parallel
+#else
+  for(color=0; color < (int) sparsePattern->maxColors; color++) {
+    functionJacSparseColor(data, threadData, jacobian, jacobianColumn, color, values);
+  }
+#endif
+}
+
 extern "C" {
 
 int functionODE_residual(DATA* data, threadData_t *threadData, double *dx, double *dy, double *dz)
@@ -504,9 +641,175 @@ int functionJacD(DATA* data, threadData_t *threadData, double* jac){
 
 
 
+/* Writes a matrix given either densely in array or by the non-zeros values of sparsePattern. */
+static void writeLinearizationFile(threadData_t *threadData, const string& filename, double* array, int row, int col,
+                                   SPARSE_PATTERN* sparsePattern, double* values)
+{
+  FILE *fout = omc_fopen(filename.c_str(), "wb");
+  assertStreamPrint(threadData,0!=fout,"Cannot open File %s",filename.c_str());
+  if(values) {
+    writeMatrixMarketSparse(fout, sparsePattern, values, row, col);
+  } else {
+    writeMatrixMarketDense(fout, array, row, col);
+  }
+  fclose(fout);
+}
+
+static void writeLinearizationVector(threadData_t *threadData, const string& filename, double* array, int size)
+{
+  FILE *fout = omc_fopen(filename.c_str(), "wb");
+  assertStreamPrint(threadData,0!=fout,"Cannot open File %s",filename.c_str());
+  writeMatrixMarketVector(fout, array, size);
+  fclose(fout);
+}
+
+/* The symbolic jacobians are set up once, either by the integrator or by the
+ * first linearization, and reused for every further linearization time. */
+static int initialLinearizationJacobian(DATA* data, threadData_t *threadData, ANALYTIC_JACOBIAN* jacobian,
+                                        int (*initialAnalyticJacobian)(DATA*, threadData_t*, ANALYTIC_JACOBIAN*))
+{
+  if(jacobian->seedVars != NULL){
+    return 0;
+  }
+  return initialAnalyticJacobian(data, threadData, jacobian);
+}
+
+/* Linearization for large models: the symbolic jacobians are evaluated by colors
+ * and written together with the operating point in MatrixMarket format without
+ * building dense matrices. */
+static int linearizeSparse(DATA* data, threadData_t *threadData)
+{
+    TRACE_PUSH
+    int do_data_recovery = omc_flag[FLAG_L_DATA_RECOVERY] ? 1 : 0;
+    int symbolic = data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_A].sizeTmpVars > 0;
+
+    int size_A = data->modelData->nStates;
+    int size_Inputs = data->modelData->nInputVars;
+    int size_Outputs = data->modelData->nOutputVars;
+    int size_z = data->modelData->nVariablesReal - 2*data->modelData->nStates;
+    string prefix = linearizationFileName(data);
+    double *matrixA = 0, *matrixB = 0, *matrixC = 0, *matrixD = 0, *matrixCz = 0, *matrixDz = 0;
+    double *x0 = (double*)malloc(size_A*sizeof(double));
+    double *z0 = 0;
+    int i;
+    int numeric = do_data_recovery > 0 || !symbolic;
+    struct {
+        const char* name;
+        int index;
+        int (*initialAnalyticJacobian)(DATA*, threadData_t*, ANALYTIC_JACOBIAN*);
+        analyticalJacobianColumn_func_ptr jacobianColumn;
+        int rows, cols;
+        SPARSE_PATTERN* sparsePattern;
+    } jacobians[4] = {
+        {"A", data->callback->INDEX_JAC_A, data->callback->initialAnalyticJacobianA, data->callback->functionJacA_column, size_A, size_A, NULL},
+        {"B", data->callback->INDEX_JAC_B, data->callback->initialAnalyticJacobianB, data->callback->functionJacB_column, size_A, size_Inputs, NULL},
+        {"C", data->callback->INDEX_JAC_C, data->callback->initialAnalyticJacobianC, data->callback->functionJacC_column, size_Outputs, size_A, NULL},
+        {"D", data->callback->INDEX_JAC_D, data->callback->initialAnalyticJacobianD, data->callback->functionJacD_column, size_Outputs, size_Inputs, NULL}
+    };
+
+    /* Without a sparsity pattern a symbolic jacobian can not be evaluated by colors,
+     * the numerical one is written instead. */
+    for(i=0; symbolic && i<4; i++){
+        ANALYTIC_JACOBIAN* jacobian = &(data->simulationInfo->analyticJacobians[jacobians[i].index]);
+        if(jacobians[i].rows == 0 || jacobians[i].cols == 0){
+            continue;
+        }
+        if(initialLinearizationJacobian(data, threadData, jacobian, jacobians[i].initialAnalyticJacobian) || !jacobian->sparsePattern){
+            warningStreamPrint(LOG_STDOUT, 0, "No sparsity pattern for the symbolic jacobian %s, using the numerical jacobian instead.", jacobians[i].name);
+            numeric = 1;
+        }else{
+            jacobians[i].sparsePattern = jacobian->sparsePattern;
+        }
+    }
+
+    assertStreamPrint(threadData,0!=x0,"malloc failed");
+    memcpy(x0, data->localData[0]->realVars, size_A*sizeof(double));
+    if(do_data_recovery > 0){
+        z0 = (double*)malloc(size_z*sizeof(double));
+        assertStreamPrint(threadData,0!=z0,"malloc failed");
+        memcpy(z0, &data->localData[0]->realVars[2*size_A], size_z*sizeof(double));
+    }
+
+    /* Can currently only extract data recovery matrices Cz and Dz numerically */
+    if(numeric){
+        matrixA = (double*)calloc(size_A*size_A,sizeof(double));
+        matrixB = (double*)calloc(size_A*size_Inputs,sizeof(double));
+        matrixC = (double*)calloc(size_Outputs*size_A,sizeof(double));
+        matrixD = (double*)calloc(size_Outputs*size_Inputs,sizeof(double));
+        assertStreamPrint(threadData,0!=matrixA,"calloc failed");
+        assertStreamPrint(threadData,0!=matrixB,"calloc failed");
+        assertStreamPrint(threadData,0!=matrixC,"calloc failed");
+        assertStreamPrint(threadData,0!=matrixD,"calloc failed");
+        if(do_data_recovery > 0){
+            matrixCz = (double*)calloc(size_z*size_A,sizeof(double));
+            matrixDz = (double*)calloc(size_z*size_Inputs,sizeof(double));
+            assertStreamPrint(threadData,0!=matrixCz,"calloc failed");
+            assertStreamPrint(threadData,0!=matrixDz,"calloc failed");
+        }
+        assertStreamPrint(threadData,0==functionJacAC_num(data, threadData, matrixA, matrixC, matrixCz),"Error, can not get Matrix A or C ");
+        assertStreamPrint(threadData,0==functionJacBD_num(data, threadData, matrixB, matrixD, matrixDz),"Error, can not get Matrix B or D ");
+    }
+
+    double* numericMatrices[4] = {matrixA, matrixB, matrixC, matrixD};
+    for(i=0; i<4; i++){
+        SPARSE_PATTERN* sparsePattern = jacobians[i].sparsePattern;
+        string filename = prefix + "_" + jacobians[i].name + ".mtx";
+        if(sparsePattern){
+            ANALYTIC_JACOBIAN* jacobian = &(data->simulationInfo->analyticJacobians[jacobians[i].index]);
+            double* values = (double*)calloc(sparsePattern->numberOfNonZeros + 1, sizeof(double));
+            assertStreamPrint(threadData,0!=values,"calloc failed");
+            functionJacSparse(data, threadData, jacobian, jacobians[i].jacobianColumn, values);
+            infoStreamPrint(LOG_JAC, 0, "Matrix %s: %u non-zeros, %u colors", jacobians[i].name, sparsePattern->numberOfNonZeros, sparsePattern->maxColors);
+            writeLinearizationFile(threadData, filename, NULL, jacobians[i].rows, jacobians[i].cols, sparsePattern, values);
+            free(values);
+        }else{
+            /* empty matrices are never evaluated */
+            writeLinearizationFile(threadData, filename, numericMatrices[i], jacobians[i].rows, jacobians[i].cols, NULL, NULL);
+        }
+    }
+
+    writeLinearizationVector(threadData, prefix + "_x0.mtx", x0, size_A);
+    writeLinearizationVector(threadData, prefix + "_u0.mtx", data->simulationInfo->inputVars, size_Inputs);
+    if(do_data_recovery > 0){
+        writeLinearizationFile(threadData, prefix + "_Cz.mtx", matrixCz, size_z, size_A, NULL, NULL);
+        writeLinearizationFile(threadData, prefix + "_Dz.mtx", matrixDz, size_z, size_Inputs, NULL, NULL);
+        writeLinearizationVector(threadData, prefix + "_z0.mtx", z0, size_z);
+    }
+
+    free(matrixA);
+    free(matrixB);
+    free(matrixC);
+    free(matrixD);
+    free(matrixCz);
+    free(matrixDz);
+    free(x0);
+    free(z0);
+
+    if (data->modelData->runTestsuite) {
+        infoStreamPrint(LOG_STDOUT, 0, "Linear model is created.");
+    }
+    else {
+        char* cwd = getcwd(NULL, 0); /* call with NULL and 0 to allocate the buffer dynamically (no pathmax needed) */
+        if(!cwd) {
+          infoStreamPrint(LOG_STDOUT, 0, "Linear model %s_*.mtx is created at time %g, but getting the full path failed.", prefix.c_str(), data->localData[0]->timeValue);
+        }
+        else {
+          infoStreamPrint(LOG_STDOUT, 0, "Linear model is created at time %g in %s/%s_*.mtx", data->localData[0]->timeValue, cwd, prefix.c_str());
+          free(cwd);
+        }
+    }
+    TRACE_POP
+    return 0;
+}
+
 int linearize(DATA* data, threadData_t *threadData)
 {
     TRACE_PUSH
+    if (omc_flag[FLAG_L_SPARSE]) {
+      TRACE_POP
+      return linearizeSparse(data, threadData);
+    }
+
     /* Check if data recovery is requested */
     int do_data_recovery = omc_flag[FLAG_L_DATA_RECOVERY] ? 1 : 0;
 
@@ -566,25 +869,25 @@ int linearize(DATA* data, threadData_t *threadData)
         /* Retrieve symbolic Jacobian */
         /* Determine Matrix A */
         ANALYTIC_JACOBIAN* jacobian = &(data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_A]);
-        if(!data->callback->initialAnalyticJacobianA(data, threadData, jacobian)){
+        if(!initialLinearizationJacobian(data, threadData, jacobian, data->callback->initialAnalyticJacobianA)){
             assertStreamPrint(threadData,0==functionJacA(data, threadData, matrixA),"Error, can not get Matrix A ");
         }
 
         /* Determine Matrix B */
         jacobian = &(data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_B]);
-        if(!data->callback->initialAnalyticJacobianB(data, threadData, jacobian)){
+        if(!initialLinearizationJacobian(data, threadData, jacobian, data->callback->initialAnalyticJacobianB)){
             assertStreamPrint(threadData,0==functionJacB(data, threadData, matrixB),"Error, can not get Matrix B ");
         }
 
         /* Determine Matrix C */
         jacobian = &(data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_C]);
-        if(!data->callback->initialAnalyticJacobianC(data, threadData, jacobian)){
+        if(!initialLinearizationJacobian(data, threadData, jacobian, data->callback->initialAnalyticJacobianC)){
             assertStreamPrint(threadData,0==functionJacC(data, threadData, matrixC),"Error, can not get Matrix C ");
         }
 
         /* Determine Matrix D */
         jacobian = &(data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_D]);
-        if(!data->callback->initialAnalyticJacobianD(data, threadData, jacobian)){
+        if(!initialLinearizationJacobian(data, threadData, jacobian, data->callback->initialAnalyticJacobianD)){
             assertStreamPrint(threadData,0==functionJacD(data, threadData, matrixD),"Error, can not get Matrix D ");
         }
     }
@@ -654,19 +957,20 @@ int linearize(DATA* data, threadData_t *threadData)
       case OMC_LINEARIZE_DUMP_LANGUAGE_JULIA: ext = ".jl";  break;
       case OMC_LINEARIZE_DUMP_LANGUAGE_PYTHON: ext = ".py";  break;
     }
-    /* ticket #5927: Don't use the model name to prevent bad names for certain languages. */
-    filename = "linearized_model" + string(ext);
+    filename = linearizationFileName(data) + ext;
 
     FILE *fout = omc_fopen(filename.c_str(),"wb");
     assertStreamPrint(threadData,0!=fout,"Cannot open File %s",filename.c_str());
 
+    /* intermediate points of time of -l=t1,t2,... are before stopTime */
+    double linTime = data->simulationInfo->nextLinearizationTime < data->simulationInfo->nLinearizationTimes ? data->localData[0]->timeValue : data->simulationInfo->stopTime;
     if(do_data_recovery > 0){
         fprintf(fout, data->callback->linear_model_datarecovery_frame(), strX.c_str(), strU.c_str(), strZ0.c_str(), strA.c_str(), strB.c_str(), strC.c_str(), strD.c_str(), strCz.c_str(), strDz.c_str());
     }else{
-        fprintf(fout, data->callback->linear_model_frame(), strX.c_str(), strU.c_str(), strA.c_str(), strB.c_str(), strC.c_str(), strD.c_str(), (double) data->simulationInfo->stopTime);
+        fprintf(fout, data->callback->linear_model_frame(), strX.c_str(), strU.c_str(), strA.c_str(), strB.c_str(), strC.c_str(), strD.c_str(), linTime);
     }
     if(ACTIVE_STREAM(LOG_STATS)) {
-      infoStreamPrint(LOG_STATS, 0, data->callback->linear_model_frame(), strX.c_str(), strU.c_str(), strA.c_str(), strB.c_str(), strC.c_str(), strD.c_str(), (double) data->simulationInfo->stopTime);
+      infoStreamPrint(LOG_STATS, 0, data->callback->linear_model_frame(), strX.c_str(), strU.c_str(), strA.c_str(), strB.c_str(), strC.c_str(), strD.c_str(), linTime);
     }
 
     fflush(fout);
@@ -31,14 +31,21 @@
 /*! MoveData.c
  */
 
+#ifdef USE_PARJAC
+  #define GC_THREADS
+  #include <gc/omc_gc.h>
+#endif
+
 #include "../../meta/meta_modelica.h"
 #include "../../openmodelica_types.h"
 #include "../../openmodelica.h"
 #include "../../simulation/options.h"
 #include "../../simulation/results/simulation_result.h"
 #include "../../simulation/solver/model_help.h"
+#include "../../simulation/solver/nonlinearSystem.h"
 #include "../../util/context.h"
 #include "../../util/omc_file.h"
+#include "../../util/parallel_helper.h"
 #include "../OptimizerData.h"
 #include "../OptimizerLocalFunction.h"
 
@@ -689,6 +696,226 @@ void copy_initial_values(OptData * optData, DATA* data){
 
 }
 
+#define COPY_ARRAY(dst, src, n, type) { dst = (type*) malloc(((n) > 0 ? (n) : 1)*sizeof(type)); memcpy(dst, src, (n)*sizeof(type)); }
+
+/*!
+ *  allocate the model data of the threads for the parallel evaluation of the
+ *  collocation points (-jacobianThreads). Everything written while evaluating one
+ *  point is copied, static model data and the thread aware linear systems are shared.
+ **/
+void allocateOptDataThreads(OptData *optData){
+  DATA *data = optData->data;
+  const MODEL_DATA *mData = data->modelData;
+  const SIMULATION_INFO *sInfo = data->simulationInfo;
+  const int nv = optData->dim.nv;
+  const int nJ = optData->dim.nJ;
+  const int nJ2 = optData->dim.nJ2;
+  const int * indexBC = optData->s.indexABCD + 2;
+  int nThreads = omc_get_max_threads();
+  int t, i, j, l;
+
+  if(nThreads > 1 && (mData->nMixedSystems > 0 || mData->nStateSets > 0 || mData->nDelayExpressions > 0)){
+    warningStreamPrint(LOG_STDOUT, 0, "Collocation points are evaluated by one thread, since the model has mixed systems, state sets or delay expressions.");
+    nThreads = 1;
+  }
+
+  memset(&optData->stats, 0, sizeof(OptDataStatistics));
+  optData->nThreads = nThreads;
+  optData->th = (OptDataThread*) calloc(nThreads, sizeof(OptDataThread));
+
+  optData->th[0].data = data;
+  optData->th[0].threadData = optData->threadData;
+  for(l = 0; l < 3; ++l)
+    optData->th[0].realVars[l] = data->localData[l]->realVars;
+  optData->th[0].tmpJ = optData->tmpJ;
+  optData->th[0].H = optData->H;
+  optData->th[0].Hl = optData->Hl;
+
+  for(t = 1; t < nThreads; ++t){
+    OptDataThread *th = &optData->th[t];
+    DATA *tData = (DATA*) malloc(sizeof(DATA));
+    SIMULATION_INFO *tInfo = (SIMULATION_INFO*) malloc(sizeof(SIMULATION_INFO));
+
+    memcpy(tData, data, sizeof(DATA));
+    memcpy(tInfo, sInfo, sizeof(SIMULATION_INFO));
+    tData->simulationInfo = tInfo;
+
+    tData->localData = (SIMULATION_DATA**) malloc(3*sizeof(SIMULATION_DATA*));
+    for(l = 0; l < 3; ++l){
+      tData->localData[l] = (SIMULATION_DATA*) malloc(sizeof(SIMULATION_DATA));
+      memcpy(tData->localData[l], data->localData[l], sizeof(SIMULATION_DATA));
+      COPY_ARRAY(tData->localData[l]->realVars, data->localData[l]->realVars, mData->nVariablesReal, modelica_real);
+      COPY_ARRAY(tData->localData[l]->integerVars, data->localData[l]->integerVars, mData->nVariablesInteger, modelica_integer);
+      COPY_ARRAY(tData->localData[l]->booleanVars, data->localData[l]->booleanVars, mData->nVariablesBoolean, modelica_boolean);
+      th->realVars[l] = tData->localData[l]->realVars;
+    }
+
+    COPY_ARRAY(tInfo->realVarsPre, sInfo->realVarsPre, mData->nVariablesReal, modelica_real);
+    COPY_ARRAY(tInfo->integerVarsPre, sInfo->integerVarsPre, mData->nVariablesInteger, modelica_integer);
+    COPY_ARRAY(tInfo->booleanVarsPre, sInfo->booleanVarsPre, mData->nVariablesBoolean, modelica_boolean);
+    COPY_ARRAY(tInfo->realVarsOld, sInfo->realVarsOld, mData->nVariablesReal, modelica_real);
+    COPY_ARRAY(tInfo->integerVarsOld, sInfo->integerVarsOld, mData->nVariablesInteger, modelica_integer);
+    COPY_ARRAY(tInfo->booleanVarsOld, sInfo->booleanVarsOld, mData->nVariablesBoolean, modelica_boolean);
+    COPY_ARRAY(tInfo->relations, sInfo->relations, mData->nRelations, modelica_boolean);
+    COPY_ARRAY(tInfo->relationsPre, sInfo->relationsPre, mData->nRelations, modelica_boolean);
+    COPY_ARRAY(tInfo->storedRelations, sInfo->storedRelations, mData->nRelations, modelica_boolean);
+    COPY_ARRAY(tInfo->zeroCrossings, sInfo->zeroCrossings, mData->nZeroCrossings, modelica_real);
+    COPY_ARRAY(tInfo->zeroCrossingsPre, sInfo->zeroCrossingsPre, mData->nZeroCrossings, modelica_real);
+    COPY_ARRAY(tInfo->zeroCrossingsBackup, sInfo->zeroCrossingsBackup, mData->nZeroCrossings, modelica_real);
+    COPY_ARRAY(tInfo->mathEventsValuePre, sInfo->mathEventsValuePre, mData->nMathEvents, modelica_real);
+    COPY_ARRAY(tInfo->samples, sInfo->samples, mData->nSamples, modelica_boolean);
+    COPY_ARRAY(tInfo->inputVars, sInfo->inputVars, mData->nInputVars, modelica_real);
+    COPY_ARRAY(tInfo->outputVars, sInfo->outputVars, mData->nOutputVars, modelica_real);
+
+    /* own result and tmp vars of the jacobians B and C, the seed vectors are shared */
+    COPY_ARRAY(tInfo->analyticJacobians, sInfo->analyticJacobians, mData->nJacobians, ANALYTIC_JACOBIAN);
+    for(l = 0; l < 2; ++l){
+      if(optData->s.matrix[2 + l]){
+        ANALYTIC_JACOBIAN *jac = &tInfo->analyticJacobians[indexBC[l]];
+        COPY_ARRAY(jac->resultVars, sInfo->analyticJacobians[indexBC[l]].resultVars, jac->sizeRows, modelica_real);
+        COPY_ARRAY(jac->tmpVars, sInfo->analyticJacobians[indexBC[l]].tmpVars, jac->sizeTmpVars, modelica_real);
+      }
+    }
+
+    th->threadData = (threadData_t*) malloc(sizeof(threadData_t));
+    memcpy(th->threadData, optData->threadData, sizeof(threadData_t));
+    pthread_mutex_init(&th->threadData->parentMutex, NULL);
+
+    if(mData->nNonLinearSystems > 0){
+      tInfo->nonlinearSystemData = (NONLINEAR_SYSTEM_DATA*) omc_alloc_interface.malloc_uncollectable(mData->nNonLinearSystems*sizeof(NONLINEAR_SYSTEM_DATA));
+      data->callback->initialNonLinearSystem(mData->nNonLinearSystems, tInfo->nonlinearSystemData);
+      initializeNonlinearSystems(tData, th->threadData);
+      updateStaticDataOfNonlinearSystems(tData, th->threadData);
+    }
+    th->data = tData;
+
+    th->tmpJ = (modelica_real**) malloc(nJ2*sizeof(modelica_real*));
+    for(i = 0; i < nJ2; ++i)
+      th->tmpJ[i] = (modelica_real*) calloc(nv, sizeof(modelica_real));
+
+    th->H = (long double ***) malloc(nJ*sizeof(long double**));
+    for(i = 0; i < nJ; ++i){
+      th->H[i] = (long double **) malloc(nv*sizeof(long double*));
+      for(j = 0; j < nv; ++j)
+        th->H[i][j] = (long double *) calloc(nv, sizeof(long double));
+    }
+
+    th->Hl = (long double **) malloc(nv*sizeof(long double*));
+    for(j = 0; j < nv; ++j)
+      th->Hl[j] = (long double *) calloc(nv, sizeof(long double));
+  }
+
+  if(nThreads > 1)
+    infoStreamPrint(LOG_SOLVER, 0, "evaluate collocation points with %i threads", nThreads);
+}
+
+#undef COPY_ARRAY
+
+/*!
+ *  free the model data of the threads, thread 0 is the model itself
+ **/
+void freeOptDataThreads(OptData *optData){
+  const int nv = optData->dim.nv;
+  const int nJ = optData->dim.nJ;
+  const int nJ2 = optData->dim.nJ2;
+  const int * indexBC = optData->s.indexABCD + 2;
+  int t, i, j, l;
+
+  for(t = 1; t < optData->nThreads; ++t){
+    OptDataThread *th = &optData->th[t];
+    DATA *tData = th->data;
+    SIMULATION_INFO *tInfo = tData->simulationInfo;
+
+    for(i = 0; i < nJ2; ++i)
+      free(th->tmpJ[i]);
+    free(th->tmpJ);
+    for(i = 0; i < nJ; ++i){
+      for(j = 0; j < nv; ++j)
+        free(th->H[i][j]);
+      free(th->H[i]);
+    }
+    free(th->H);
+    for(j = 0; j < nv; ++j)
+      free(th->Hl[j]);
+    free(th->Hl);
+
+    if(tData->modelData->nNonLinearSystems > 0){
+      freeNonlinearSystems(tData, th->threadData);
+      omc_alloc_interface.free_uncollectable(tInfo->nonlinearSystemData);
+    }
+
+    for(l = 0; l < 2; ++l){
+      if(optData->s.matrix[2 + l]){
+        free(tInfo->analyticJacobians[indexBC[l]].resultVars);
+        free(tInfo->analyticJacobians[indexBC[l]].tmpVars);
+      }
+    }
+    free(tInfo->analyticJacobians);
+    free(tInfo->realVarsPre);
+    free(tInfo->integerVarsPre);
+    free(tInfo->booleanVarsPre);
+    free(tInfo->realVarsOld);
+    free(tInfo->integerVarsOld);
+    free(tInfo->booleanVarsOld);
+    free(tInfo->relations);
+    free(tInfo->relationsPre);
+    free(tInfo->storedRelations);
+    free(tInfo->zeroCrossings);
+    free(tInfo->zeroCrossingsPre);
+    free(tInfo->zeroCrossingsBackup);
+    free(tInfo->mathEventsValuePre);
+    free(tInfo->samples);
+    free(tInfo->inputVars);
+    free(tInfo->outputVars);
+    free(tInfo);
+
+    for(l = 0; l < 3; ++l){
+      free(th->realVars[l]);
+      free(tData->localData[l]->integerVars);
+      free(tData->localData[l]->booleanVars);
+      free(tData->localData[l]);
+    }
+    free(tData->localData);
+    free(tData);
+    free(th->threadData);
+  }
+  free(optData->th);
+}
+
+/*!
+ *  prepare the current OpenMP thread for the evaluation with the data of th
+ **/
+void enterOptDataThread(OptData *optData, OptDataThread *th){
+  if(th->threadData == optData->threadData)
+    return;
+#ifdef USE_PARJAC
+  /* Register omp-thread in GC */
+  if(!GC_thread_is_registered()) {
+     struct GC_stack_base sb;
+     memset (&sb, 0, sizeof(sb));
+     GC_get_stack_base(&sb);
+     GC_register_my_thread (&sb);
+  }
+#endif
+  /* the copy of the thread data must not jump back into the stack of the main thread */
+  th->threadData->mmc_jumper = NULL;
+  th->threadData->globalJumpBuffer = NULL;
+  th->threadData->simulationJumpBuffer = NULL;
+  th->threadData->mmc_stack_overflow_jumper = NULL;
+  pthread_setspecific(mmc_thread_data_key, th->threadData);
+  mmc_init_stackoverflow(th->threadData);
+}
+
+/*!
+ *  reset the model data of th to the initial values before the evaluation of the next point
+ **/
+void resetOptDataThread(OptData *optData, OptDataThread *th){
+  int l;
+  for(l = 0; l < 3; ++l)
+    th->data->localData[l]->realVars = th->realVars[l];
+  copy_initial_values(optData, th->data);
+}
+
 /*!
  *  transfer optimizer data to model data
  *  author: Vitalij Ruge
@@ -697,14 +924,19 @@ void optData2ModelData(OptData *optData, double *vopt, const int index){
   const int nv = optData->dim.nv;
   const int nsi = optData->dim.nsi;
   const int np = optData->dim.np;
+  /* all collocation points but the last one, which also evaluates the mayer term */
+  const int nPoints = nsi*np - 1;
 
   modelica_real * realVars[3];
   modelica_real * tmpVars[2] = {NULL, NULL};
 
-  int i, j, k, shift, l;
+  int i, j, q, l;
   DATA * data = optData->data;
   const int * indexBC = optData->s.indexABCD + 3;
   threadData_t *threadData = optData->threadData;
+  rtclock_t clock;
+
+  rt_ext_tp_tick(&clock);
 
   for(l = 0; l < 3; ++l)
     realVars[l] = data->localData[l]->realVars;
@@ -715,18 +947,33 @@ void optData2ModelData(OptData *optData, double *vopt, const int index){
   }
   copy_initial_values(optData, data);
 
-  for(i = 0, shift = 0; i < nsi-1; ++i){
-    for(j = 0; j < np; ++j, shift += nv){
-      setLocalVars(optData, data, vopt, i, j, shift);
-      updateDOSystem(optData, data, threadData, i, j, index, 2);
+  if(optData->nThreads > 1){
+    /* the points are independent of each other, each thread evaluates
+     * a slice of them on its own model data and writes J[i][j] of its points only */
+#ifdef USE_PARJAC
+    GC_allow_register_threads();
+#endif
+#pragma omp parallel default(none) shared(optData, vopt) firstprivate(index, nPoints, np, nv) private(q) num_threads(optData->nThreads)
+    {
+      OptDataThread *th = &optData->th[omc_get_thread_num()];
+      enterOptDataThread(optData, th);
+#pragma omp for schedule(dynamic)
+      for(q = 0; q < nPoints; ++q){
+        resetOptDataThread(optData, th);
+        setLocalVars(optData, th->data, vopt, q/np, q%np, q*nv);
+        updateDOSystem(optData, th->data, th->threadData, q/np, q%np, index, 2);
+      }
+    }
+    resetOptDataThread(optData, optData->th);
+  }else{
+    for(q = 0; q < nPoints; ++q){
+      setLocalVars(optData, data, vopt, q/np, q%np, q*nv);
+      updateDOSystem(optData, data, threadData, q/np, q%np, index, 2);
     }
   }
-
-  for(j = 0; j < np-1; ++j, shift += nv){
-    setLocalVars(optData, data, vopt, i, j, shift);
-    updateDOSystem(optData, data, threadData, i, j, index, 2);
-  }
-  setLocalVars(optData, data, vopt, i, j, shift);
+  i = nsi - 1;
+  j = np - 1;
+  setLocalVars(optData, data, vopt, i, j, nPoints*nv);
   updateDOSystem(optData, data, threadData, i, j, index, 3);
 
   /*terminal constraint(s)*/
@@ -742,6 +989,8 @@ void optData2ModelData(OptData *optData, double *vopt, const int index){
     if(optData->s.matrix[l])
       data->simulationInfo->analyticJacobians[indexBC[l]].tmpVars = tmpVars[l];
 
+  optData->stats.timeModel += rt_ext_tp_tock(&clock);
+  ++optData->stats.nModel;
 }
 
 
@@ -753,17 +1002,15 @@ static inline void updateDOSystem(OptData * optData, DATA * data, threadData_t *
                                    const int i, const int j, const int index, const int m){
 
     /* try */
-  optData->scc = 0;
 #if !defined(OMC_EMCC)
     MMC_TRY_INTERNAL(simulationJumpBuffer)
 #endif
-    data->callback->input_function(data, optData->threadData);
-    updateDiscreteSystem(data, optData->threadData);
+    data->callback->input_function(data, threadData);
+    updateDiscreteSystem(data, threadData);
 
     if(index){
-      diffSynColoredOptimizerSystem(optData, optData->J[i][j], i, j, m);
+      diffSynColoredOptimizerSystem(optData, data, threadData, optData->J[i][j], i, j, m);
     }
-    optData->scc = 1;
 #if !defined(OMC_EMCC)
     MMC_CATCH_INTERNAL(simulationJumpBuffer)
 #endif
@@ -809,9 +1056,8 @@ void setLocalVars(OptData * optData, DATA * data, const double * const vopt,
  *  function calculates a symbolic colored jacobian matrix of the optimization system
  *  authors: Willi Braun, Vitalij Ruge
  */
-void diffSynColoredOptimizerSystem(OptData *optData, modelica_real **J, const int m, const int n, const int index){
-  DATA * data = optData->data;
-  threadData_t *threadData = optData->threadData;
+void diffSynColoredOptimizerSystem(OptData *optData, DATA *data, threadData_t *threadData,
+                                   modelica_real **J, const int m, const int n, const int index){
   int i,j,l,ii, ll;
 
   const int h_index = optData->s.indexABCD[index];
@@ -34,6 +34,7 @@
 #include "omc_config.h"
 #include "../simulation_data.h"
 #include "../simulation/solver/solver_main.h"
+#include "../util/rtclock.h"
 #include <string.h>
 #include <Ipopt/IpStdCInterface.h>
 #include <stdlib.h>
@@ -154,6 +155,31 @@ typedef struct OptDataStructure{
   int indexABCD[5];
 }OptDataStructure;
 
+/* evaluation data of one worker thread, see -jacobianThreads
+ * thread 0 uses the model data and the buffers of OptData
+ */
+typedef struct OptDataThread{
+  DATA *data;
+  threadData_t *threadData;
+  modelica_real *realVars[3];
+
+  modelica_real **tmpJ;
+  long double ***H;
+  long double **Hl;
+}OptDataThread;
+
+typedef struct OptDataStatistics{
+  double timeModel;
+  double timeG;
+  double timeJacG;
+  double timeF;
+  double timeH;
+  unsigned long nModel;
+  unsigned long nG;
+  unsigned long nJacG;
+  unsigned long nF;
+  unsigned long nH;
+}OptDataStatistics;
 
 typedef struct OptData{
   OptDataDim dim;
@@ -193,7 +219,10 @@ typedef struct OptData{
   double *oldH;
   int iter_;
   short index;
-  modelica_boolean scc;
+
+  OptDataThread *th;
+  int nThreads;
+  OptDataStatistics stats;
 
 }OptData;
 
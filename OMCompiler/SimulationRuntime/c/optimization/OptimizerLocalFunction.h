@@ -44,7 +44,12 @@ void initial_guess_optimizer(OptData *optData, SOLVER_INFO* solverInfo);
 void res2file(OptData *optData, SOLVER_INFO* solverInfo,double * v);
 void optData2ModelData(OptData *optData, double *vopt, const int index);
 
-void diffSynColoredOptimizerSystem(OptData *optData, modelica_real **J, const int i, const int j, const int index);
+void allocateOptDataThreads(OptData *optData);
+void freeOptDataThreads(OptData *optData);
+void enterOptDataThread(OptData *optData, OptDataThread *th);
+void resetOptDataThread(OptData *optData, OptDataThread *th);
+
+void diffSynColoredOptimizerSystem(OptData *optData, DATA *data, threadData_t *threadData, modelica_real **J, const int i, const int j, const int index);
 void diffSynColoredOptimizerSystemF(OptData *optData, modelica_real **J);
 void debugeJac(OptData * optData,Number* vopt);
 void debugeSteps(OptData * optData, modelica_real*vopt, modelica_real * lambda);
@@ -47,7 +47,9 @@ Bool evalfF(Index n, Number * vopt, Bool new_x, Number *objValue, void * useData
 
   long double mayer = 0.0;
   long double lagrange = 0.0;
+  rtclock_t clock;
 
+  rt_ext_tp_tick(&clock);
   if(new_x)
     optData2ModelData(optData, vopt, 1);
 
@@ -87,6 +89,8 @@ Bool evalfF(Index n, Number * vopt, Bool new_x, Number *objValue, void * useData
 
   *objValue = (Number)(lagrange + mayer);
 
+  optData->stats.timeF += rt_ext_tp_tock(&clock);
+  ++optData->stats.nF;
   return TRUE;
 }
 
@@ -106,7 +110,9 @@ Bool evalfDiffF(Index n, double * vopt, Bool new_x, Number *gradF, void * useDat
 
   const modelica_boolean la = optData->s.lagrange;
   const modelica_boolean ma = optData->s.mayer;
+  rtclock_t clock;
 
+  rt_ext_tp_tick(&clock);
   if(new_x)
     optData2ModelData(optData, vopt, 1);
 
@@ -144,5 +150,7 @@ Bool evalfDiffF(Index n, double * vopt, Bool new_x, Number *gradF, void * useDat
 
   }
 
+  optData->stats.timeF += rt_ext_tp_tock(&clock);
+  ++optData->stats.nF;
   return TRUE;
 }
@@ -87,7 +87,9 @@ Bool evalfG(Index n, double * vopt, Bool new_x, int m, Number *g, void * useData
   long double *sdt;
   double * vv[np+1];
   int i, j, k, shift;
+  rtclock_t clock;
 
+  rt_ext_tp_tick(&clock);
 
   if(new_x){
     optData2ModelData(optData, vopt, optData->index);
@@ -154,6 +156,8 @@ Bool evalfG(Index n, double * vopt, Bool new_x, int m, Number *g, void * useData
     const int nJ = optData->dim.nJ;
     printMaxError(g, m, nx, nJ, optData->time.t, np ,nsi ,optData->data, optData);
   }
+  optData->stats.timeG += rt_ext_tp_tock(&clock);
+  ++optData->stats.nG;
   return TRUE;
 }
 
@@ -206,6 +210,9 @@ Bool evalfDiffG(Index n, double * vopt, Bool new_x, Index m, Index njac, Index *
     modelica_boolean ** J = optData->s.JderCon;
     modelica_boolean ** Jf = optData->s.J[2];
     int i, j, k, l, ii, cindex;
+    rtclock_t clock;
+
+    rt_ext_tp_tick(&clock);
     ++optData->iter_;
     if(new_x){
       optData2ModelData(optData, vopt, 1);
@@ -326,6 +333,8 @@ Bool evalfDiffG(Index n, double * vopt, Bool new_x, Index m, Index njac, Index *
         debugeJac(optData, vopt);
     }
    }
+    optData->stats.timeJacG += rt_ext_tp_tock(&clock);
+    ++optData->stats.nJacG;
   }
 
   return TRUE;
@@ -34,11 +34,14 @@
 #include "../OptimizerData.h"
 #include "../OptimizerLocalFunction.h"
 #include "../../simulation/solver/model_help.h"
+#include "../../util/parallel_helper.h"
 
-static inline void num_hessian0(double * v, const double * const lambda, const double objFactor , OptData *optData, const int i, const int j);
-static inline void sumLagrange0(const int i, const int j, double * res,  const modelica_boolean upC, OptData *optData);
+static inline void num_hessian0(double * v, const double * const lambda, const double objFactor , OptData *optData, OptDataThread *th, const int i, const int j);
+static inline void sumLagrange0(const int i, const int j, double * res,  const modelica_boolean upC, OptData *optData, OptDataThread *th);
 static inline void num_hessian1(double * v, const double * const lambda, const double objFactor, OptData *optData, const int i, const int j);
 static inline void sumLagrange1(const int i, const int j, double * res,  const modelica_boolean upC, const modelica_boolean upC2, OptData *optData);
+static inline modelica_boolean hessianPoint0(double * v, const double * const lambda, const double objFactor, OptData *optData, OptDataThread *th,
+                                             const int i, const int j, const modelica_boolean upC, double * values);
 #define DF_STEP(v) (1e-5*fabsl(v) + 1e-8)
 
 /* eval hessian
@@ -98,7 +101,9 @@ Bool ipopt_h(int n, double *vopt, Bool new_x, double obj_factor, int m, double *
     modelica_boolean upC;
     modelica_boolean upC2;
     DATA * data = optData->data;
+    rtclock_t clock;
 
+    rt_ext_tp_tick(&clock);
     upC = obj_factor != 0;
     /*
     if(new_x){
@@ -113,18 +118,44 @@ Bool ipopt_h(int n, double *vopt, Bool new_x, double obj_factor, int m, double *
     upC = upC && optData->s.lagrange;
     copy_initial_values(optData, data);
 
-    for(ii = 0, k = 0, v = vopt, la = lambda; ii + 1 < nsi; ++ii){
-      for(p = 1; p < np1; ++p, v += nv, la += nJ){
-        num_hessian0(v, la, obj_factor, optData, ii, p-1);
-        /*******************/
-        for(i = 0; i < nv; ++i){
-          for(j = 0; j < i + 1; ++j){
-            if(optData->s.H0[i][j]){
-              sumLagrange0(i, j, values + (k++),upC,optData);
+    if(optData->nThreads > 1){
+      /* the points of the first nsi-1 intervals are independent, each thread writes
+       * the nH0_ hessian values of its points only */
+      const int nPoints = (nsi - 1)*np;
+      const int nH0_ = optData->dim.nH0_;
+      modelica_boolean scc = 1;
+      int q;
+#pragma omp parallel default(none) shared(optData, vopt, lambda, values, scc) firstprivate(nPoints, np, nv, nJ, nH0_, obj_factor, upC) private(q) num_threads(optData->nThreads)
+      {
+        OptDataThread *th = &optData->th[omc_get_thread_num()];
+        enterOptDataThread(optData, th);
+#pragma omp for schedule(dynamic) reduction(&&:scc)
+        for(q = 0; q < nPoints; ++q){
+          resetOptDataThread(optData, th);
+          scc = hessianPoint0(vopt + q*nv, lambda + q*nJ, obj_factor, optData, th, q/np, q%np, upC, values + q*nH0_) && scc;
+        }
+      }
+      resetOptDataThread(optData, optData->th);
+      if(!scc)
+        throwStreamPrint(optData->threadData, "evaluation of the hessian failed");
+      ii = nsi - 1;
+      k = nPoints*nH0_;
+      v = vopt + nPoints*nv;
+      la = lambda + nPoints*nJ;
+    }else{
+      for(ii = 0, k = 0, v = vopt, la = lambda; ii + 1 < nsi; ++ii){
+        for(p = 1; p < np1; ++p, v += nv, la += nJ){
+          num_hessian0(v, la, obj_factor, optData, optData->th, ii, p-1);
+          /*******************/
+          for(i = 0; i < nv; ++i){
+            for(j = 0; j < i + 1; ++j){
+              if(optData->s.H0[i][j]){
+                sumLagrange0(i, j, values + (k++),upC,optData,optData->th);
+              }
             }
           }
+          /*******************/
         }
-        /*******************/
       }
     }
     /*******************/
@@ -136,7 +167,7 @@ Bool ipopt_h(int n, double *vopt, Bool new_x, double obj_factor, int m, double *
           if(optData->s.H1[i][j] && np == p){
             sumLagrange1(i, j, values + (k++),upC, upC2,optData);
           }else if(optData->s.H0[i][j]){
-            sumLagrange0(i, j, values + (k++),upC,optData);
+            sumLagrange0(i, j, values + (k++),upC,optData,optData->th);
           }
         }
       }
@@ -148,23 +179,56 @@ Bool ipopt_h(int n, double *vopt, Bool new_x, double obj_factor, int m, double *
     }
     if(optData->dim.updateHessian > 0)
       memcpy(optData->oldH, values, nele_hess*sizeof(double));
+    optData->stats.timeH += rt_ext_tp_tock(&clock);
+    ++optData->stats.nH;
   }
 
 
   return TRUE;
 }
 
+/* hessian values of one point in the first nsi-1 intervals,
+ * returns 0 if the evaluation of the model failed
+ */
+static inline modelica_boolean hessianPoint0(double * v, const double * const lambda, const double objFactor, OptData *optData, OptDataThread *th,
+                                             const int ii, const int p, const modelica_boolean upC, double * values){
+  const int nv = optData->dim.nv;
+  threadData_t *threadData = th->threadData;
+  volatile modelica_boolean scc = 0;
+  int i, j, k;
+
+#if !defined(OMC_EMCC)
+  MMC_TRY_INTERNAL(simulationJumpBuffer)
+#endif
+  num_hessian0(v, lambda, objFactor, optData, th, ii, p);
+  for(i = 0, k = 0; i < nv; ++i){
+    for(j = 0; j < i + 1; ++j){
+      if(optData->s.H0[i][j]){
+        sumLagrange0(i, j, values + (k++), upC, optData, th);
+      }
+    }
+  }
+  scc = 1;
+#if !defined(OMC_EMCC)
+  MMC_CATCH_INTERNAL(simulationJumpBuffer)
+#endif
+  return scc;
+}
+
 /* numerical approximation
  *  hessian
  * author: Vitalij Ruge
  */
 static inline void num_hessian0(double * v, const double * const lambda,
-    const double objFactor , OptData *optData, const int i, const int j){
+    const double objFactor , OptData *optData, OptDataThread *th, const int i, const int j){
 
   const modelica_boolean la = optData->s.lagrange;
   const modelica_boolean upCost = la && objFactor != 0;
-  DATA * data = optData->data;
-  threadData_t *threadData = optData->threadData;
+  DATA * data = th->data;
+  threadData_t *threadData = th->threadData;
+  modelica_real ** tmpJ = th->tmpJ;
+  long double *** H = th->H;
+  long double ** Hl = th->Hl;
 
   const int nv = optData->dim.nv;
   const int nx = optData->dim.nx;
@@ -202,15 +266,19 @@ static inline void num_hessian0(double * v, const double * const lambda,
     /*data->callback->functionDAE(data);*/
     updateDiscreteSystem(data, threadData);
     /********************/
-    diffSynColoredOptimizerSystem(optData, optData->tmpJ, i,j,2);
+    diffSynColoredOptimizerSystem(optData, data, threadData, tmpJ, i,j,2);
     /********************/
     v[ii] = (double)v_save;
     /********************/
     for(jj = 0; jj <ii+1; ++jj){
       if(optData->s.H0[ii][jj]){
         for(l = 0; l < nJ; ++l){
-          if(optData->s.Hg[l][ii][jj] && lambda[l] != 0)
-              optData->H[l][ii][jj] = (long double)(optData->tmpJ[l][jj] - optData->J[i][j][l][jj])*lambda[l]/h;
+          if(optData->s.Hg[l][ii][jj]){
+            if(lambda[l] != 0)
+              H[l][ii][jj] = (long double)(tmpJ[l][jj] - optData->J[i][j][l][jj])*lambda[l]/h;
+            else
+              H[l][ii][jj] = 0.0;
+          }
         }
       }
     }
@@ -219,9 +287,9 @@ static inline void num_hessian0(double * v, const double * const lambda,
       h = objFactor/h;
       for(jj = 0; jj <ii+1; ++jj){
         if(optData->s.Hl[ii][jj]){
-          optData->Hl[ii][jj] = (long double)(optData->tmpJ[nJ][jj] - optData->J[i][j][nJ][jj])*h;
+          Hl[ii][jj] = (long double)(tmpJ[nJ][jj] - optData->J[i][j][nJ][jj])*h;
         }else{
-          optData->Hl[ii][jj] = 0.0;
+          Hl[ii][jj] = 0.0;
         }
       }
     }
@@ -292,7 +360,7 @@ static inline void num_hessian1(double * v, const double * const lambda,
     /*data->callback->functionDAE(data);*/
     updateDiscreteSystem(data, threadData);
     /********************/
-    diffSynColoredOptimizerSystem(optData, optData->tmpJ, i,j,indexJ);
+    diffSynColoredOptimizerSystem(optData, data, threadData, optData->tmpJ, i,j,indexJ);
     /********************/
     v[ii] = (double)v_save;
     /********************/
@@ -351,7 +419,7 @@ static inline void num_hessian1(double * v, const double * const lambda,
  * author: Vitalij Ruge
  */
 static inline void sumLagrange0(const int i, const int j, double * res,
-    const modelica_boolean upC, OptData *optData){
+    const modelica_boolean upC, OptData *optData, OptDataThread *th){
   const int nJ = optData->dim.nJ;
 
   long double sum = 0.0;
@@ -359,11 +427,11 @@ static inline void sumLagrange0(const int i, const int j, double * res,
 
   for(l = 0; l< nJ; ++l){
     if(optData->s.Hg[l][i][j])
-      sum += optData->H[l][i][j];
+      sum += th->H[l][i][j];
   }
 
   if(upC && optData->s.Hl[i][j])
-    sum += optData->Hl[i][j];
+    sum += th->Hl[i][j];
 
   *res = (double) sum;
 
@@ -38,6 +38,7 @@
 #include "simulation/options.h"
 
 static inline void optimizationWithIpopt(OptData*optData);
+static inline void printOptimizerStatistics(OptData*optData);
 static inline void freeOptimizerData(OptData*optData);
 
 int runOptimizer(DATA* data, threadData_t *threadData, SOLVER_INFO* solverInfo){
@@ -51,6 +52,7 @@ int runOptimizer(DATA* data, threadData_t *threadData, SOLVER_INFO* solverInfo){
 
   initial_guess_optimizer(optData, solverInfo);
   allocate_der_struct(&optData->s, &optData->dim ,data, optData);
+  allocateOptDataThreads(optData);
 
   optimizationWithIpopt(optData);
   res2file(optData, solverInfo, optData->ipop.vopt);
@@ -215,11 +217,30 @@ static inline void optimizationWithIpopt(OptData*optData){
     optData->index = 1;
     res = IpoptSolve(nlp, vopt, NULL, &obj, mult_g, mult_x_L, mult_x_U, (void*)optData);
   }
+  printOptimizerStatistics(optData);
   if(res != 0 && !ACTIVE_STREAM(LOG_IPOPT))
     warningStreamPrint(LOG_STDOUT, 0, "No optimal solution found!\nUse -lv=LOG_IPOPT for more information.");
   FreeIpoptProblem(nlp);
 }
 
+/*!
+ *  time spent in the callbacks of ipopt
+ **/
+static inline void printOptimizerStatistics(OptData*optData){
+  const OptDataStatistics *stats = &optData->stats;
+
+  if(!ACTIVE_STREAM(LOG_STATS))
+    return;
+
+  infoStreamPrint(LOG_STATS, 1, "### OPTIMIZER STATISTICS ###");
+  infoStreamPrint(LOG_STATS, 0, "%12i collocation points evaluated by %i thread(s)", (int) (optData->dim.nsi*optData->dim.np), optData->nThreads);
+  infoStreamPrint(LOG_STATS, 0, "%12gs [%6lu calls] model and jacobians at the collocation points", stats->timeModel, stats->nModel);
+  infoStreamPrint(LOG_STATS, 0, "%12gs [%6lu calls] constraints", stats->timeG, stats->nG);
+  infoStreamPrint(LOG_STATS, 0, "%12gs [%6lu calls] jacobian of the constraints", stats->timeJacG, stats->nJacG);
+  infoStreamPrint(LOG_STATS, 0, "%12gs [%6lu calls] objective function and gradient", stats->timeF, stats->nF);
+  infoStreamPrint(LOG_STATS, 0, "%12gs [%6lu calls] hessian of the lagrangian", stats->timeH, stats->nH);
+  messageClose(LOG_STATS);
+}
 
 static inline void freeOptimizerData(OptData*optData){
   const int nsi = optData->dim.nsi;
@@ -229,6 +250,7 @@ static inline void freeOptimizerData(OptData*optData){
 
   int i,j,k;
 
+  freeOptDataThreads(optData);
   /*************************/
   for(i=0; i < nsi; ++i)
     free(optData->time.t[i]);
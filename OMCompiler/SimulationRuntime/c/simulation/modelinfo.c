@@ -46,6 +46,8 @@
 #include <stdint.h>
 #include "../util/read_matlab4.h"
 #include "../util/omc_file.h"
+#include "../util/omc_prof_hist.h"
+#include "options.h"
 
 /* UNDEF to debug the gnuplot file */
 #define NO_PIPE
@@ -363,7 +365,7 @@ int printModelInfo(DATA *data, threadData_t *threadData, const char *outputPath,
     throwStreamPrint(NULL, "modelinfo.c: Error: can not allocate memory.");
   }
   FILE *fout = omc_fopen(fullFileName, "w");
-  FILE *plotCommands;
+  FILE *plotCommands, *plots;
   time_t t;
   int i;
 #if defined(__MINGW32__) || defined(_MSC_VER) || defined(NO_PIPE)
@@ -381,12 +383,14 @@ int printModelInfo(DATA *data, threadData_t *threadData, const char *outputPath,
 
   assertStreamPrint(threadData, 0 != fout, "Failed to open %s%s: %s\n", outputPath, filename, strerror(errno));
 
-  if(plotCommands) {
-    fputs("set terminal svg\n", plotCommands);
-    fputs("set nokey\n", plotCommands);
-    fputs("set format y \"%g\"\n", plotCommands);
+  /* with -measureTimeHistogram there is no data per step to plot */
+  plots = omc_flag[FLAG_MEASURETIMEHISTOGRAM] ? NULL : plotCommands;
+  if(plots) {
+    fputs("set terminal svg\n", plots);
+    fputs("set nokey\n", plots);
+    fputs("set format y \"%g\"\n", plots);
     /* The column containing the time spent to calculate each step */
-    printPlotCommand(plotCommands, plotFormat, "Execution time of global steps", outputPath, data->modelData->modelFilePrefix, data->modelData->modelDataXml.nFunctions+data->modelData->modelDataXml.nProfileBlocks, -1, 999, "");
+    printPlotCommand(plots, plotFormat, "Execution time of global steps", outputPath, data->modelData->modelFilePrefix, data->modelData->modelDataXml.nFunctions+data->modelData->modelDataXml.nProfileBlocks, -1, 999, "");
   }
   /* The doctype is needed for id() lookup to work properly */
   fprintf(fout, "<!DOCTYPE doc [\
@@ -474,7 +478,7 @@ int printModelInfo(DATA *data, threadData_t *threadData, const char *outputPath,
   fprintf(fout, "</variables>\n");
 
   fprintf(fout, "<functions>\n");
-  printFunctions(fout, plotCommands, plotFormat, outputPath, data->modelData->modelFilePrefix, data);
+  printFunctions(fout, plots, plotFormat, outputPath, data->modelData->modelFilePrefix, data);
   fprintf(fout, "</functions>\n");
 
   fprintf(fout, "<equations>\n");
@@ -482,7 +486,7 @@ int printModelInfo(DATA *data, threadData_t *threadData, const char *outputPath,
   fprintf(fout, "</equations>\n");
 
   fprintf(fout, "<profileblocks>\n");
-  printProfileBlocks(fout, plotCommands, plotFormat, outputPath, data);
+  printProfileBlocks(fout, plots, plotFormat, outputPath, data);
   fprintf(fout, "</profileblocks>\n");
 
   fprintf(fout, "</simulation>\n");
@@ -575,7 +579,23 @@ void escapeJSON(FILE *file, const char *data)
   }
 }
 
-static void printJSONFunctions(FILE *fout, DATA *data) {
+/* Reads the next row of the -measureTimeHistogram file and prints it as member "histogram" */
+static void printJSONHistogram(FILE *fout, OMC_PROF_HIST_READER *reader) {
+  OMC_PROF_HIST_ROW row;
+  int b, n;
+  if (!reader || omc_prof_hist_reader_next(reader, &row)) {
+    return;
+  }
+  for (n = OMC_PROF_HIST_BUCKETS; n > 0 && row.buckets[n-1] == 0; n--);
+  fprintf(fout, ",\"histogram\":{\"ncall\":%lu,\"nsteps\":%lu,\"time\":%.9f,\"maxTime\":%.9f,\"buckets\":[",
+    (unsigned long) row.ncall, (unsigned long) row.nsteps, row.time, row.maxTime);
+  for (b = 0; b < n; b++) {
+    fprintf(fout, b ? ",%lu" : "%lu", (unsigned long) row.buckets[b]);
+  }
+  fputs("]}", fout);
+}
+
+static void printJSONFunctions(FILE *fout, DATA *data, OMC_PROF_HIST_READER *reader) {
   int i;
   for(i = 0; i < data->modelData->modelDataXml.nFunctions; i++) {
     const struct FUNCTION_INFO func = modelInfoGetFunction(&data->modelData->modelDataXml, i);
@@ -583,24 +603,28 @@ static void printJSONFunctions(FILE *fout, DATA *data) {
     fputs(i == 0 ? "\n" : ",\n", fout);
     fprintf(fout, "{\"name\":\"");
     escapeJSON(fout, func.name);
-    fprintf(fout, "\",\"ncall\":%d,\"time\":%.9f,\"maxTime\":%.9f}",
+    fprintf(fout, "\",\"ncall\":%d,\"time\":%.9f,\"maxTime\":%.9f",
       (int) rt_ncall_total(i + SIM_TIMER_FIRST_FUNCTION),
       rt_total(i + SIM_TIMER_FIRST_FUNCTION),
       rt_max_accumulated(i + SIM_TIMER_FIRST_FUNCTION));
+    printJSONHistogram(fout, reader);
+    fputc('}', fout);
   }
 }
 
-static void printJSONProfileBlocks(FILE *fout, DATA *data) {
+static void printJSONProfileBlocks(FILE *fout, DATA *data, OMC_PROF_HIST_READER *reader) {
   int i;
   for(i = data->modelData->modelDataXml.nFunctions; i < data->modelData->modelDataXml.nFunctions + data->modelData->modelDataXml.nProfileBlocks; i++) {
     const struct EQUATION_INFO eq = modelInfoGetEquationIndexByProfileBlock(&data->modelData->modelDataXml, i-data->modelData->modelDataXml.nFunctions);
     rt_clear(i + SIM_TIMER_FIRST_FUNCTION);
     fputs(i == data->modelData->modelDataXml.nFunctions ? "\n" : ",\n", fout);
-    fprintf(fout, "{\"id\":%d,\"ncall\":%d,\"time\":%.9f,\"maxTime\":%.9f}",
+    fprintf(fout, "{\"id\":%d,\"ncall\":%d,\"time\":%.9f,\"maxTime\":%.9f",
       (int) eq.id,
       (int) rt_ncall_total(i + SIM_TIMER_FIRST_FUNCTION),
       rt_total(i + SIM_TIMER_FIRST_FUNCTION),
       rt_max_accumulated(i + SIM_TIMER_FIRST_FUNCTION));
+    printJSONHistogram(fout, reader);
+    fputc('}', fout);
   }
 }
 
@@ -615,10 +639,24 @@ int printModelInfoJSON(DATA *data, threadData_t *threadData, const char *outputP
   time_t t;
   long i;
   double totalTimeEqs = 0;
+  OMC_PROF_HIST_READER histReader, *reader = NULL;
   if (!fout) {
     throwStreamPrint(NULL, "Failed to open file %s%s for writing", outputPath, filename);
   }
-  convertProfileData(outputPath, data->modelData->modelFilePrefix, data->modelData->modelDataXml.nFunctions+data->modelData->modelDataXml.nProfileBlocks);
+  if (omc_flag[FLAG_MEASURETIMEHISTOGRAM]) {
+    /* The histograms are streamed row by row into the functions and profile blocks */
+    const char* histFileName;
+    if (0 > GC_asprintf(&histFileName, "%s%s_prof.hist", outputPath, data->modelData->modelFilePrefix)) {
+      throwStreamPrint(NULL, "modelinfo.c: Error: can not allocate memory.");
+    }
+    if (omc_prof_hist_reader_open(&histReader, histFileName)) {
+      warningStreamPrint(LOG_STDOUT, 0, "Failed to read the time measurements in %s", histFileName);
+    } else {
+      reader = &histReader;
+    }
+  } else {
+    convertProfileData(outputPath, data->modelData->modelFilePrefix, data->modelData->modelDataXml.nFunctions+data->modelData->modelDataXml.nProfileBlocks);
+  }
   if(time(&t) < 0)
   {
     fclose(fout);
@@ -660,11 +698,22 @@ int printModelInfoJSON(DATA *data, threadData_t *threadData, const char *outputP
   fprintf(fout, ",\n\"totalTimeProfileBlocks\":%g",totalTimeEqs); /* The overhead the profiling is huge if small equations are profiled */
   fprintf(fout, ",\n\"numStep\":%d", (int) rt_ncall_total(SIM_TIMER_STEP));
   fprintf(fout, ",\n\"maxTime\":%.9g", rt_max_accumulated(SIM_TIMER_STEP));
+  if (reader) {
+    /* bucket b counts the steps taking [2^(b-1),2^b) ns */
+    fprintf(fout, ",\n\"histogramInterval\":%lu", (unsigned long) reader->header.interval);
+    fprintf(fout, ",\n\"histogramSteps\":%lu", (unsigned long) reader->header.nSampled);
+    fprintf(fout, ",\n\"step\":{\"name\":\"step\"");
+    printJSONHistogram(fout, reader);
+    fputc('}', fout);
+  }
   fprintf(fout, ",\n\"functions\":[");
-  printJSONFunctions(fout,data);
+  printJSONFunctions(fout,data,reader);
   fprintf(fout, "\n],\n\"profileBlocks\":[");
-  printJSONProfileBlocks(fout,data);
+  printJSONProfileBlocks(fout,data,reader);
   fprintf(fout, "\n]\n");
   fprintf(fout, "}");
+  if (reader) {
+    omc_prof_hist_reader_close(reader);
+  }
   return 0;
 }
@@ -34,6 +34,7 @@
 #include <errno.h>
 #include <string.h>
 #include <stdio.h>
+#include <pthread.h>
 #include "../util/rtclock.h"
 #include "../util/omc_mmap.h"
 #include "../util/omc_numbers.h"
@@ -372,28 +373,66 @@ static void readInfoJson(const char *str,MODEL_DATA_XML *xml)
   assertChar(str,'}');
 }
 
-void modelInfoInit(MODEL_DATA_XML* xml)
+/*
+ * The parsed equation and function infos only depend on the info file and
+ * the profiling flags. They are shared read-only by all model instances of
+ * the process, e.g. by all instances of one FMU, and reference counted.
+ */
+typedef struct MODEL_INFO_SHARED
 {
-  omc_stat_t buf = {0};
-  // check for file exists, as --fmiFilter=blackBox or protected will not export the _info.json file
-  int fileStatus;
-  if (omc_flag[FLAG_INPUT_PATH])
-  {
-    const char *jsonFile;
-    GC_asprintf(&jsonFile, "%s/%s", omc_flagValue[FLAG_INPUT_PATH], xml->fileName);
-    fileStatus = omc_stat(jsonFile, &buf);
+  char *fileName;
+  int measureTimeFlag;
+  long nFunctions;
+  long nEquations;
+  long nProfileBlocks;
+  FUNCTION_INFO *functionNames;
+  EQUATION_INFO *equationInfo;
+  size_t size;                         /* bytes allocated for functionNames and equationInfo */
+  int refCount;
+  struct MODEL_INFO_SHARED *next;
+} MODEL_INFO_SHARED;
+
+static MODEL_INFO_SHARED *sharedModelInfos = NULL;
+static pthread_mutex_t sharedModelInfoMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static size_t modelInfoSize(MODEL_DATA_XML* xml)
+{
+  size_t size = xml->nFunctions*sizeof(FUNCTION_INFO) + (1+xml->nEquations)*sizeof(EQUATION_INFO);
+  long i;
+  int j;
+  for (i=0; i<xml->nFunctions; i++) {
+    size += strlen(xml->functionNames[i].name) + 1;
   }
-  else
-  {
-    fileStatus = omc_stat(xml->fileName, &buf);
+  for (i=0; i<=xml->nEquations; i++) {
+    size += xml->equationInfo[i].numVar*sizeof(const char*);
+    for (j=0; j<xml->equationInfo[i].numVar; j++) {
+      size += strlen(xml->equationInfo[i].vars[j]) + 1;
+    }
   }
+  return size;
+}
 
-  if (fileStatus != 0)
-  {
-    xml->fileName = NULL;
-    return;
+static void freeSharedModelInfo(MODEL_INFO_SHARED *shared)
+{
+  long i;
+  int j;
+  for (i=0; i<shared->nFunctions; i++) {
+    free((char*)shared->functionNames[i].name);
+  }
+  for (i=0; i<=shared->nEquations; i++) {
+    for (j=0; j<shared->equationInfo[i].numVar; j++) {
+      free((char*)shared->equationInfo[i].vars[j]);
+    }
+    free(shared->equationInfo[i].vars);
   }
+  free(shared->functionNames);
+  free(shared->equationInfo);
+  free(shared->fileName);
+  free(shared);
+}
 
+static void parseModelInfo(MODEL_DATA_XML* xml)
+{
 #if !defined(OMC_NO_FILESYSTEM)
   omc_mmap_read mmap_reader = {0};
 #endif
@@ -429,19 +468,89 @@ void modelInfoInit(MODEL_DATA_XML* xml)
   readInfoJson(xml->infoXMLData, xml);
   // fprintf(stderr, "Parsed the JSON in %fms...\n", rt_tock(0) * 1000.0);
 #if !defined(OMC_NO_FILESYSTEM)
-  omc_mmap_close_read(mmap_reader);
+  if (mmap_reader.data) {
+    omc_mmap_close_read(mmap_reader);
+    xml->infoXMLData = NULL;
+  }
 #endif
 }
 
+void modelInfoInit(MODEL_DATA_XML* xml)
+{
+  omc_stat_t buf = {0};
+  MODEL_INFO_SHARED *shared;
+  const char *jsonFile = xml->fileName;
+  // check for file exists, as --fmiFilter=blackBox or protected will not export the _info.json file
+  int fileStatus;
+  if (omc_flag[FLAG_INPUT_PATH])
+  {
+    GC_asprintf(&jsonFile, "%s/%s", omc_flagValue[FLAG_INPUT_PATH], xml->fileName);
+  }
+
+  pthread_mutex_lock(&sharedModelInfoMutex);
+  for (shared = sharedModelInfos; shared; shared = shared->next) {
+    if (shared->measureTimeFlag == measure_time_flag && 0 == strcmp(shared->fileName, jsonFile)) {
+      break;
+    }
+  }
+
+  if (!shared) {
+    fileStatus = omc_stat(jsonFile, &buf);
+    if (fileStatus != 0)
+    {
+      pthread_mutex_unlock(&sharedModelInfoMutex);
+      xml->fileName = NULL;
+      return;
+    }
+    parseModelInfo(xml);
+
+    shared = (MODEL_INFO_SHARED*) malloc(sizeof(MODEL_INFO_SHARED));
+    shared->fileName = strdup(jsonFile);
+    shared->measureTimeFlag = measure_time_flag;
+    shared->nFunctions = xml->nFunctions;
+    shared->nEquations = xml->nEquations;
+    shared->nProfileBlocks = xml->nProfileBlocks;
+    shared->functionNames = xml->functionNames;
+    shared->equationInfo = xml->equationInfo;
+    shared->size = modelInfoSize(xml);
+    shared->refCount = 0;
+    shared->next = sharedModelInfos;
+    sharedModelInfos = shared;
+  }
+
+  shared->refCount++;
+  xml->nProfileBlocks = shared->nProfileBlocks;
+  xml->functionNames = shared->functionNames;
+  xml->equationInfo = shared->equationInfo;
+  infoStreamPrint(LOG_DEBUG, 0, "model info %s: %ld kB shared by %d instance(s)", jsonFile, (long) (shared->size+1023)/1024, shared->refCount);
+  pthread_mutex_unlock(&sharedModelInfoMutex);
+}
+
 /**
  * @brief Deinitialize memory allocated by modelInfoInit
  *
+ * The shared model info is freed when the last instance using it is deinitialized.
+ *
  * @param xml   Pointer to model info xml data.
  */
 void modelInfoDeinit(MODEL_DATA_XML* xml)
 {
-  free(xml->functionNames); xml->functionNames = NULL;
-  free(xml->equationInfo); xml->equationInfo = NULL;
+  MODEL_INFO_SHARED **prev, *shared;
+
+  pthread_mutex_lock(&sharedModelInfoMutex);
+  for (prev = &sharedModelInfos; (shared = *prev); prev = &shared->next) {
+    if (shared->equationInfo == xml->equationInfo) {
+      if (0 == --shared->refCount) {
+        *prev = shared->next;
+        freeSharedModelInfo(shared);
+      }
+      break;
+    }
+  }
+  pthread_mutex_unlock(&sharedModelInfoMutex);
+
+  xml->functionNames = NULL;
+  xml->equationInfo = NULL;
 }
 
 FUNCTION_INFO modelInfoGetFunction(MODEL_DATA_XML* xml, size_t ix)
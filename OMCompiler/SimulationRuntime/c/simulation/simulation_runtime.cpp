@@ -36,6 +36,8 @@
 #include <sstream>
 #include <limits>
 #include <list>
+#include <vector>
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include <ctime>
@@ -286,6 +288,34 @@ void setGlobalLoggingTime(int argc, char**argv, SIMULATION_INFO *simulationInfo)
 }
 
 
+/* Read value of flag l. The last point of time becomes the stop time, all others
+ * are linearized during the simulation, see prefixedName_performSimulation. */
+static void setLinearizationTimes(const char *lintime, SIMULATION_INFO *simulationInfo)
+{
+  std::vector<double> times;
+  const char *str = lintime;
+  char *endptr;
+
+  do {
+    times.push_back(om_strtod(str, &endptr));
+    if (endptr == str || (*endptr && *endptr != ',')) {
+      throwStreamPrint(NULL, "Simulation flag %s expects a real number or a comma separated list of real numbers. Got: %s", FLAG_NAME[FLAG_L], lintime);
+    }
+    if (times.size() > 1 && times[times.size()-1] <= times[times.size()-2]) {
+      throwStreamPrint(NULL, "Simulation flag %s expects increasing points of time. Got: %s", FLAG_NAME[FLAG_L], lintime);
+    }
+    str = endptr + 1;
+  } while (*endptr);
+
+  simulationInfo->stopTime = times.back();
+  times.pop_back();
+  simulationInfo->nLinearizationTimes = times.size();
+  if (!times.empty()) {
+    simulationInfo->linearizationTimes = (modelica_real*) malloc(times.size() * sizeof(modelica_real));
+    std::copy(times.begin(), times.end(), simulationInfo->linearizationTimes);
+  }
+}
+
 static void readFlag(int *flag, int max, const char *value, const char *flagName, const char **names, const char **desc)
 {
   int i;
@@ -485,12 +515,18 @@ int startNonInteractiveSimulation(int argc, char**argv, DATA* data, threadData_t
     rt_clear(SIM_TIMER_INIT);
   }
 
+  data->simulationInfo->linearizationTimes = NULL;
+  data->simulationInfo->nLinearizationTimes = 0;
+  data->simulationInfo->nextLinearizationTime = 0;
   if(create_linearmodel)
   {
     if(lintime == NULL) {
       data->simulationInfo->stopTime = data->simulationInfo->startTime;
     } else {
-      data->simulationInfo->stopTime = atof(lintime);
+      setLinearizationTimes(lintime, data->simulationInfo);
+    }
+    for(int i = 0; i < data->simulationInfo->nLinearizationTimes; i++) {
+      infoStreamPrint(LOG_STDOUT, 0, "Linearization will be performed at point of time: %f", data->simulationInfo->linearizationTimes[i]);
     }
     infoStreamPrint(LOG_STDOUT, 0, "Linearization will be performed at point of time: %f", data->simulationInfo->stopTime);
   }
@@ -635,6 +671,8 @@ int startNonInteractiveSimulation(int argc, char**argv, DATA* data, threadData_t
     retVal = linearize(data, threadData);
     rt_accumulate(SIM_TIMER_JACOBIAN);
   }
+  free(data->simulationInfo->linearizationTimes);
+  data->simulationInfo->linearizationTimes = NULL;
 
   /* Use the saved state of measure_time_flag.
    * measure_time_flag is set to active when LOG_STATS is ON.
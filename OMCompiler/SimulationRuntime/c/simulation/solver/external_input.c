@@ -100,60 +100,61 @@ int externalInputallocate(DATA* data)
 
 
 void externalInputallocate2(DATA* data, char *filename){
-  int i, j, k;
-  struct csv_data *res = read_csv(filename);
+  int i, j;
+  struct csv_stream *stream = read_csv_stream_open(filename);
   char ** names;
-  int * indx;
+  const char ** columns;
+  double *t;
   const int nu = data->modelData->nInputVars;
-  const int nnu = modelica_integer_min(nu, res ? res->numvars - 1 : 0);
 
-  if (NULL == res) {
+  if (NULL == stream) {
+    fprintf(stderr, "Failed to read CSV-file %s", filename);
+    EXIT(1);
+  }
+
+  names = (char**)malloc(nu * sizeof(char*));
+  data->callback->inputNames(data, names);
+
+  /* only read the first column (time) and the inputs */
+  columns = (const char**)malloc((nu+1) * sizeof(char*));
+  columns[0] = stream->variables[0];
+  for(j = 0; j < nu; ++j){
+    columns[j+1] = names[j];
+  }
+  read_csv_stream_select(stream, columns, nu+1);
+  if (read_csv_stream_read(stream, 1) < 0) {
     fprintf(stderr, "Failed to read CSV-file %s", filename);
     EXIT(1);
   }
 
   data->modelData->nInputVars = nu;
-  data->simulationInfo->external_input.n = res->numsteps;
+  data->simulationInfo->external_input.n = stream->numsteps;
   data->simulationInfo->external_input.N = data->simulationInfo->external_input.n;
 
   data->simulationInfo->external_input.u = (modelica_real**)calloc(data->simulationInfo->external_input.n+1, sizeof(modelica_real*));
 
-  names = (char**)malloc(nu * sizeof(char*));
-
   for(i = 0; i<data->simulationInfo->external_input.n; ++i){
-    data->simulationInfo->external_input.u[i] = (modelica_real*)calloc(nnu, sizeof(modelica_real));
+    data->simulationInfo->external_input.u[i] = (modelica_real*)calloc(nu, sizeof(modelica_real));
   }
 
   data->simulationInfo->external_input.t = (modelica_real*)calloc(data->simulationInfo->external_input.n+1, sizeof(modelica_real));
 
-  data->callback->inputNames(data, names);
-
-  indx = (int*)malloc(nu*sizeof(int));
-  for(i = 0; i < nu; ++i){
-    indx[i] = -1;
-    for(j = 0; j < (res->numvars - 1); ++j){
-      if(strcmp(names[i], res->variables[j]) == 0){
-        indx[i] = j;
-        break;
-      }
-    }
-  }
-
-  for(i = 0, k= 0; i < data->simulationInfo->external_input.n; ++i)
-    data->simulationInfo->external_input.t[i] = res->data[k++];
+  t = read_csv_stream_column(stream, 0);
+  for(i = 0; i < data->simulationInfo->external_input.n; ++i)
+    data->simulationInfo->external_input.t[i] = t[i];
 
   for(j = 0; j < nu; ++j){
-    if(indx[j] != -1){
-      k = (indx[j])*data->simulationInfo->external_input.n;
+    double *u = read_csv_stream_column(stream, j+1);
+    if(u != NULL){
       for(i = 0; i < data->simulationInfo->external_input.n; ++i){
-        data->simulationInfo->external_input.u[i][j] = res->data[k++];
+        data->simulationInfo->external_input.u[i][j] = u[i];
       }
     }
   }
 
-  omc_free_csv_reader(res);
+  read_csv_stream_close(stream);
   free(names);
-  free(indx);
+  free(columns);
   data->simulationInfo->external_input.active = data->simulationInfo->external_input.n > 0;
 }
 
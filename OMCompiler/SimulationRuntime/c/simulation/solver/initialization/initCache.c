@@ -0,0 +1,359 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/*! \file initCache.c
+ *
+ * Cache of converged initial solutions for parameter sweeps.
+ *
+ * After a successful initialization the iteration variables of all non-linear
+ * systems are stored together with the parameter values in a text file. A
+ * later run with the same file uses the entry with the nearest parameters as
+ * start values of the non-linear systems (nlsxOld). Entries are only used if all
+ * integer and boolean parameters are equal.
+ */
+
+#include "initCache.h"
+
+#if !defined(OMC_MINIMAL_RUNTIME)
+
+#include "../../../util/omc_error.h"
+#include "../../../util/omc_file.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INIT_CACHE_VERSION 1
+
+static INIT_CACHE_ENTRY* addEntry(INIT_CACHE *cache, DATA *data)
+{
+  MODEL_DATA *mData = data->modelData;
+  NONLINEAR_SYSTEM_DATA *nonlinsys = data->simulationInfo->nonlinearSystemData;
+  INIT_CACHE_ENTRY *entry;
+  long i;
+
+  cache->entries = (INIT_CACHE_ENTRY*) realloc(cache->entries, (cache->nEntries+1)*sizeof(INIT_CACHE_ENTRY));
+  entry = &cache->entries[cache->nEntries++];
+
+  entry->realParameter = (modelica_real*) calloc(mData->nParametersReal+1, sizeof(modelica_real));
+  entry->integerParameter = (modelica_integer*) calloc(mData->nParametersInteger+1, sizeof(modelica_integer));
+  entry->booleanParameter = (modelica_boolean*) calloc(mData->nParametersBoolean+1, sizeof(modelica_boolean));
+  entry->nlsx = (modelica_real**) malloc((cache->nSystems+1)*sizeof(modelica_real*));
+  for(i=0; i<cache->nSystems; ++i) {
+    entry->nlsx[i] = (modelica_real*) calloc(nonlinsys[i].size+1, sizeof(modelica_real));
+  }
+  entry->coldIterations = 0;
+
+  return entry;
+}
+
+static void freeEntry(INIT_CACHE *cache, INIT_CACHE_ENTRY *entry)
+{
+  long i;
+
+  for(i=0; i<cache->nSystems; ++i) {
+    free(entry->nlsx[i]);
+  }
+  free(entry->nlsx);
+  free(entry->realParameter);
+  free(entry->integerParameter);
+  free(entry->booleanParameter);
+}
+
+static void removeEntry(INIT_CACHE *cache, int index)
+{
+  freeEntry(cache, &cache->entries[index]);
+  memmove(cache->entries+index, cache->entries+index+1, (cache->nEntries-index-1)*sizeof(INIT_CACHE_ENTRY));
+  cache->nEntries--;
+  if(cache->seed == index) {
+    cache->seed = -1;
+  } else if(cache->seed > index) {
+    cache->seed--;
+  }
+}
+
+/*! \fn static double parameterDistance(DATA *data, INIT_CACHE_ENTRY *entry)
+ *
+ *  Maximal relative difference between the real parameters of the model and the
+ *  entry, DBL_MAX if an integer or boolean parameter differs.
+ */
+static double parameterDistance(DATA *data, INIT_CACHE_ENTRY *entry)
+{
+  MODEL_DATA *mData = data->modelData;
+  SIMULATION_INFO *sInfo = data->simulationInfo;
+  double distance = 0.0, scale;
+  long i;
+
+  for(i=0; i<mData->nParametersInteger; ++i) {
+    if(entry->integerParameter[i] != sInfo->integerParameter[i]) {
+      return DBL_MAX;
+    }
+  }
+  for(i=0; i<mData->nParametersBoolean; ++i) {
+    if(entry->booleanParameter[i] != sInfo->booleanParameter[i]) {
+      return DBL_MAX;
+    }
+  }
+  for(i=0; i<mData->nParametersReal; ++i) {
+    scale = fmax(fabs(entry->realParameter[i]), fabs(sInfo->realParameter[i]));
+    if(scale > 0.0) {
+      distance = fmax(distance, fabs(entry->realParameter[i] - sInfo->realParameter[i]) / scale);
+    }
+  }
+
+  return distance;
+}
+
+/*! \fn INIT_CACHE* initCacheRead(DATA *data, const char *fileName)
+ *
+ *  Reads the cache file. Entries of other models or with a different structure
+ *  are dropped, a missing file results in an empty cache.
+ *
+ *  \param [in]  [data]
+ *  \param [in]  [fileName]
+ */
+INIT_CACHE* initCacheRead(DATA *data, const char *fileName)
+{
+  MODEL_DATA *mData = data->modelData;
+  NONLINEAR_SYSTEM_DATA *nonlinsys = data->simulationInfo->nonlinearSystemData;
+  INIT_CACHE *cache = (INIT_CACHE*) calloc(1, sizeof(INIT_CACHE));
+  INIT_CACHE_ENTRY *entry;
+  FILE *pFile;
+  char guid[4096];
+  long nRealParameter, nIntegerParameter, nBooleanParameter, nSystems, size, value, i, j;
+  int version, valid;
+
+  cache->seed = -1;
+  cache->nSystems = mData->nNonLinearSystems;
+
+  pFile = omc_fopen(fileName, "r");
+  if(!pFile) {
+    infoStreamPrint(LOG_INIT, 0, "initialization cache %s does not exist yet", fileName);
+    return cache;
+  }
+
+  valid = fscanf(pFile, "OMC_INIT_CACHE %d guid %4095s sizes %ld %ld %ld %ld", &version, guid,
+                 &nRealParameter, &nIntegerParameter, &nBooleanParameter, &nSystems) == 6
+          && version == INIT_CACHE_VERSION
+          && !strcmp(guid, mData->modelGUID)
+          && nRealParameter == mData->nParametersReal
+          && nIntegerParameter == mData->nParametersInteger
+          && nBooleanParameter == mData->nParametersBoolean
+          && nSystems == cache->nSystems;
+  for(i=0; valid && i<nSystems; ++i) {
+    valid = fscanf(pFile, "%ld", &size) == 1 && size == nonlinsys[i].size;
+  }
+  if(!valid) {
+    warningStreamPrint(LOG_STDOUT, 0, "The initialization cache %s belongs to another model and will be overwritten.", fileName);
+  }
+
+  while(valid && fscanf(pFile, " entry %ld", &value) == 1) {
+    entry = addEntry(cache, data);
+    entry->coldIterations = value;
+    for(i=0; valid && i<nRealParameter; ++i) {
+      valid = fscanf(pFile, "%lf", &entry->realParameter[i]) == 1;
+    }
+    for(i=0; valid && i<nIntegerParameter; ++i) {
+      valid = fscanf(pFile, "%ld", &value) == 1;
+      entry->integerParameter[i] = (modelica_integer) value;
+    }
+    for(i=0; valid && i<nBooleanParameter; ++i) {
+      valid = fscanf(pFile, "%ld", &value) == 1;
+      entry->booleanParameter[i] = (modelica_boolean) value;
+    }
+    for(i=0; i<nSystems; ++i) {
+      for(j=0; valid && j<nonlinsys[i].size; ++j) {
+        valid = fscanf(pFile, "%lf", &entry->nlsx[i][j]) == 1;
+      }
+    }
+    if(!valid) {
+      warningStreamPrint(LOG_STDOUT, 0, "The initialization cache %s is damaged after entry %d.", fileName, cache->nEntries-1);
+      removeEntry(cache, cache->nEntries-1);
+    }
+  }
+  fclose(pFile);
+
+  infoStreamPrint(LOG_INIT, 0, "read %d entries from initialization cache %s", cache->nEntries, fileName);
+  return cache;
+}
+
+/*! \fn int initCacheSeed(DATA *data, INIT_CACHE *cache)
+ *
+ *  Sets the start values of all non-linear systems from the entry with the
+ *  nearest parameters.
+ *
+ *  \param [ref] [data]
+ *  \param [ref] [cache]
+ *  \return 1 if start values are set, 0 if there is no matching entry
+ */
+int initCacheSeed(DATA *data, INIT_CACHE *cache)
+{
+  NONLINEAR_SYSTEM_DATA *nonlinsys = data->simulationInfo->nonlinearSystemData;
+  double distance, minDistance = DBL_MAX;
+  long i;
+  int k;
+
+  cache->seed = -1;
+  for(k=0; k<cache->nEntries; ++k) {
+    distance = parameterDistance(data, &cache->entries[k]);
+    if(distance < minDistance) {
+      minDistance = distance;
+      cache->seed = k;
+    }
+  }
+
+  if(cache->seed < 0 || minDistance > INIT_CACHE_MAX_DISTANCE) {
+    infoStreamPrint(LOG_INIT, 0, "no entry of the initialization cache is close to the current parameters");
+    cache->seed = -1;
+    return 0;
+  }
+
+  for(i=0; i<cache->nSystems; ++i) {
+    memcpy(nonlinsys[i].nlsxOld, cache->entries[cache->seed].nlsx[i], nonlinsys[i].size*sizeof(modelica_real));
+  }
+  infoStreamPrint(LOG_INIT, 0, "start values of the non-linear systems from initialization cache entry %d (relative parameter difference %g)", cache->seed, minDistance);
+
+  return 1;
+}
+
+/*! \fn long initCacheIterations(DATA *data)
+ *
+ *  Total number of iterations of all non-linear systems so far.
+ */
+long initCacheIterations(DATA *data)
+{
+  long i, iterations = 0;
+
+  for(i=0; i<data->modelData->nNonLinearSystems; ++i) {
+    iterations += (long) data->simulationInfo->nonlinearSystemData[i].numberOfIterations;
+  }
+
+  return iterations;
+}
+
+/*! \fn void initCacheStore(DATA *data, INIT_CACHE *cache, const char *fileName, long iterations)
+ *
+ *  Adds the current solution to the cache and writes the cache file. An entry
+ *  with the same parameters is replaced, the oldest entry is dropped if the
+ *  cache is full.
+ *
+ *  \param [in]  [data]
+ *  \param [ref] [cache]
+ *  \param [in]  [fileName]
+ *  \param [in]  [iterations] non-linear iterations of this initialization
+ */
+void initCacheStore(DATA *data, INIT_CACHE *cache, const char *fileName, long iterations)
+{
+  MODEL_DATA *mData = data->modelData;
+  SIMULATION_INFO *sInfo = data->simulationInfo;
+  NONLINEAR_SYSTEM_DATA *nonlinsys = sInfo->nonlinearSystemData;
+  INIT_CACHE_ENTRY *entry;
+  long coldIterations = iterations;
+  FILE *pFile;
+  long i, j;
+  int k;
+
+  if(cache->seed >= 0) {
+    coldIterations = cache->entries[cache->seed].coldIterations;
+    infoStreamPrint(LOG_STATS, 0, "initialization cache: %ld non-linear iterations instead of %ld (%ld saved)",
+                    iterations, coldIterations, coldIterations - iterations);
+  }
+
+  for(k=0; k<cache->nEntries; ++k) {
+    if(parameterDistance(data, &cache->entries[k]) == 0.0) {
+      removeEntry(cache, k);
+      break;
+    }
+  }
+  if(cache->nEntries >= INIT_CACHE_MAX_ENTRIES) {
+    removeEntry(cache, 0);
+  }
+
+  entry = addEntry(cache, data);
+  entry->coldIterations = coldIterations;
+  memcpy(entry->realParameter, sInfo->realParameter, mData->nParametersReal*sizeof(modelica_real));
+  memcpy(entry->integerParameter, sInfo->integerParameter, mData->nParametersInteger*sizeof(modelica_integer));
+  memcpy(entry->booleanParameter, sInfo->booleanParameter, mData->nParametersBoolean*sizeof(modelica_boolean));
+  for(i=0; i<cache->nSystems; ++i) {
+    nonlinsys[i].getIterationVars(data, entry->nlsx[i]);
+  }
+
+  pFile = omc_fopen(fileName, "w");
+  if(!pFile) {
+    warningStreamPrint(LOG_STDOUT, 0, "Cannot write initialization cache %s.", fileName);
+    return;
+  }
+
+  fprintf(pFile, "OMC_INIT_CACHE %d\nguid %s\nsizes %ld %ld %ld %ld\n", INIT_CACHE_VERSION, mData->modelGUID,
+          mData->nParametersReal, mData->nParametersInteger, mData->nParametersBoolean, cache->nSystems);
+  for(i=0; i<cache->nSystems; ++i) {
+    fprintf(pFile, "%ld ", (long) nonlinsys[i].size);
+  }
+  fprintf(pFile, "\n");
+
+  for(k=0; k<cache->nEntries; ++k) {
+    entry = &cache->entries[k];
+    fprintf(pFile, "entry %ld\n", entry->coldIterations);
+    for(i=0; i<mData->nParametersReal; ++i) {
+      fprintf(pFile, "%.17g ", entry->realParameter[i]);
+    }
+    fprintf(pFile, "\n");
+    for(i=0; i<mData->nParametersInteger; ++i) {
+      fprintf(pFile, "%ld ", (long) entry->integerParameter[i]);
+    }
+    fprintf(pFile, "\n");
+    for(i=0; i<mData->nParametersBoolean; ++i) {
+      fprintf(pFile, "%d ", (int) entry->booleanParameter[i]);
+    }
+    fprintf(pFile, "\n");
+    for(i=0; i<cache->nSystems; ++i) {
+      for(j=0; j<nonlinsys[i].size; ++j) {
+        fprintf(pFile, "%.17g ", entry->nlsx[i][j]);
+      }
+      fprintf(pFile, "\n");
+    }
+  }
+  fclose(pFile);
+}
+
+void initCacheFree(INIT_CACHE *cache)
+{
+  int k;
+
+  for(k=0; k<cache->nEntries; ++k) {
+    freeEntry(cache, &cache->entries[k]);
+  }
+  free(cache->entries);
+  free(cache);
+}
+
+#endif /* !OMC_MINIMAL_RUNTIME */
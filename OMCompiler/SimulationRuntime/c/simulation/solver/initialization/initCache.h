@@ -0,0 +1,76 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/*! \file initCache.h
+ *
+ * Cache of converged initial solutions, see simulation flag -initCache.
+ */
+
+#ifndef _INIT_CACHE_H_
+#define _INIT_CACHE_H_
+
+#include "../../../simulation_data.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define INIT_CACHE_MAX_ENTRIES 64
+#define INIT_CACHE_MAX_DISTANCE 0.5   /* maximal relative difference of a real parameter to reuse an entry */
+
+typedef struct INIT_CACHE_ENTRY
+{
+  modelica_real *realParameter;
+  modelica_integer *integerParameter;
+  modelica_boolean *booleanParameter;
+  modelica_real **nlsx;                /* converged iteration variables of each non-linear system */
+  long coldIterations;                 /* non-linear iterations of the initialization without cached start values */
+} INIT_CACHE_ENTRY;
+
+typedef struct INIT_CACHE
+{
+  long nSystems;                       /* number of non-linear systems of the model */
+  int nEntries;
+  INIT_CACHE_ENTRY *entries;
+  int seed;                            /* index of the entry used as start values, -1 for none */
+} INIT_CACHE;
+
+INIT_CACHE* initCacheRead(DATA *data, const char *fileName);
+int initCacheSeed(DATA *data, INIT_CACHE *cache);
+long initCacheIterations(DATA *data);
+void initCacheStore(DATA *data, INIT_CACHE *cache, const char *fileName, long iterations);
+void initCacheFree(INIT_CACHE *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
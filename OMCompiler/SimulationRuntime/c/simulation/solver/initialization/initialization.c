@@ -41,6 +41,7 @@
 #include "../model_help.h"
 #if !defined(OMC_MINIMAL_RUNTIME)
 #include "../../../util/read_matlab4.h"
+#include "initCache.h"
 #endif
 #include "../events.h"
 #include "../stateset.h"
@@ -64,6 +65,7 @@
 #define updateStaticDataOfNonlinearSystems(X,Y)
 #else
 #include "../nonlinearSystem.h"
+#include "../nonlinearValuesList.h"
 #endif
 
 #include "../delay.h"
@@ -452,6 +454,85 @@ static int symbolic_initialization(DATA *data, threadData_t *threadData)
   return retVal;
 }
 
+#if !defined(OMC_MINIMAL_RUNTIME)
+/*! \fn static int cached_symbolic_initialization(DATA *data, threadData_t *threadData, const char *cacheFile)
+ *
+ *  Symbolic initialization with the start values of the non-linear systems
+ *  from the initialization cache (-initCache). If it fails, the initialization
+ *  is repeated with the start values of the model.
+ *
+ *  \param [ref] [data]
+ *  \param [ref] [threadData]
+ *  \param [in]  [cacheFile]
+ */
+static int cached_symbolic_initialization(DATA *data, threadData_t *threadData, const char *cacheFile)
+{
+  TRACE_PUSH
+  INIT_CACHE *cache = initCacheRead(data, cacheFile);
+  const long iterations = initCacheIterations(data);
+  const int useHomotopy = data->callback->useHomotopy;
+  const int homotopyOnFirstTry = omc_flag[FLAG_HOMOTOPY_ON_FIRST_TRY];
+  volatile int retVal = -1;
+  long i;
+
+  if(initCacheSeed(data, cache)) {
+    /* try */
+#ifndef OMC_EMCC
+    MMC_TRY_INTERNAL(simulationJumpBuffer)
+#endif
+    retVal = symbolic_initialization(data, threadData);
+    if(check_nonlinear_solutions(data, 0) || check_linear_solutions(data, 0) || check_mixed_solutions(data, 0)) {
+      retVal = -1;
+    }
+    /* catch */
+#ifndef OMC_EMCC
+    MMC_CATCH_INTERNAL(simulationJumpBuffer)
+#endif
+
+    if(retVal) {
+      warningStreamPrint(LOG_STDOUT, 0, "Failed to solve the initialization problem with the start values from the initialization cache. The start values of the model are used now.");
+      cache->seed = -1;
+
+      /* reset to a cold start */
+      data->callback->useHomotopy = useHomotopy;
+      omc_flag[FLAG_HOMOTOPY_ON_FIRST_TRY] = homotopyOnFirstTry;
+      data->simulationInfo->homotopySteps = 0;
+      setAllVarsToStart(data);
+      data->callback->updateBoundVariableAttributes(data, threadData);
+#if !defined(OMC_NUM_NONLINEAR_SYSTEMS) || OMC_NUM_NONLINEAR_SYSTEMS>0
+      for(i=0; i<data->modelData->nNonLinearSystems; ++i) {
+        cleanValueList((VALUES_LIST*)data->simulationInfo->nonlinearSystemData[i].oldValueList, NULL);
+        data->simulationInfo->nonlinearSystemData[i].lastTimeSolved = 0.0;
+        data->simulationInfo->nonlinearSystemData[i].solved = 1;
+      }
+#endif
+#if !defined(OMC_NUM_LINEAR_SYSTEMS) || OMC_NUM_LINEAR_SYSTEMS>0
+      for(i=0; i<data->modelData->nLinearSystems; ++i) {
+        data->simulationInfo->linearSystemData[i].solved = 1;
+      }
+#endif
+#if !defined(OMC_NUM_MIXED_SYSTEMS) || OMC_NUM_MIXED_SYSTEMS>0
+      for(i=0; i<data->modelData->nMixedSystems; ++i) {
+        data->simulationInfo->mixedSystemData[i].solved = 1;
+      }
+#endif
+      updateStaticDataOfNonlinearSystems(data, threadData);
+      retVal = symbolic_initialization(data, threadData);
+    }
+  } else {
+    retVal = symbolic_initialization(data, threadData);
+  }
+
+  if(0 == retVal && !check_nonlinear_solutions(data, 0) && !check_linear_solutions(data, 0) && !check_mixed_solutions(data, 0)) {
+    initCacheStore(data, cache, cacheFile, initCacheIterations(data) - iterations);
+  }
+  initCacheFree(cache);
+
+  TRACE_POP
+  return retVal;
+}
+#endif
+
 /*! \fn static char *mapToDymolaVars(const char *varname)
  *
  *  \param [in]  [varname]
@@ -788,6 +869,11 @@ int initialization(DATA *data, threadData_t *threadData, const char* pInitMethod
   if(IIM_NONE == initMethod) {
     retVal = 0;
   } else if(IIM_SYMBOLIC == initMethod) {
+#if !defined(OMC_MINIMAL_RUNTIME)
+    if(omc_flag[FLAG_INIT_CACHE]) {
+      retVal = cached_symbolic_initialization(data, threadData, omc_flagValue[FLAG_INIT_CACHE]);
+    } else
+#endif
     retVal = symbolic_initialization(data, threadData);
   } else {
     throwStreamPrint(threadData, "unsupported option -iim");
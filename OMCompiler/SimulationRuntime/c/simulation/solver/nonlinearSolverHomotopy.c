@@ -57,6 +57,22 @@
 #include "nonlinearSolverHomotopy.h"
 #include "nonlinearSolverHybrd.h"
 
+#if !defined(OMC_MINIMAL_RUNTIME)
+#include "omc_config.h"
+#endif
+
+/* The homotopy path of the initialization can be followed with the sparse
+ * Jacobian of the non-linear system and KLU instead of dense matrices. */
+#if !defined(OMC_MINIMAL_RUNTIME) && defined(WITH_SUITESPARSE)
+#define HOMOTOPY_SPARSE
+#include <klu.h>
+
+#define HOM_SPARSE_MAX_RANK_ONE_UPDATES 8   /* rank-one updates of the corrector before the Jacobian is evaluated again */
+#define HOM_SPARSE_CONTRACTION 0.5          /* required residual reduction of a corrector step with updated Jacobian */
+#define HOM_SPARSE_MAX_TANGENT_AGE 4        /* lambda steps a factorization is reused for the tangent vector */
+#define HOM_SPARSE_MIN_RCOND 1e-14          /* factorizations with a smaller reciprocal condition number are singular */
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -67,6 +83,39 @@ extern int dgesv_(int *n, int *nrhs, doublereal *a, int *lda, int *ipiv, doubler
 }
 #endif
 
+#ifdef HOMOTOPY_SPARSE
+/*! \typedef DATA_HOMOTOPY_SPARSE
+ * sparse linear algebra of the homotopy path
+ *
+ * The homotopy Jacobian [dh/dx dh/dlambda] is split into the sparse block dh/dx,
+ * which is factorized with KLU, and the dense lambda column. The systems with n+1
+ * unknowns of the predictor and corrector steps are solved by block elimination.
+ */
+typedef struct DATA_HOMOTOPY_SPARSE
+{
+  int nnz;          /* non-zeros of dh/dx */
+  int* Ap;          /* column pointers of dh/dx (CSC) */
+  int* Ai;          /* row indices of dh/dx */
+  double* Ax;       /* values of dh/dx, columns scaled with xScaling */
+  double* b;        /* lambda column dh/dlambda */
+  double* v;        /* (dh/dx)^-1 * dh/dlambda of the current factorization */
+  double* c;        /* last row of the bordered corrector system */
+  double* z;        /* work vector */
+
+  /* rank-one (Broyden) updates of the corrector */
+  double* s;        /* steps since the last factorization, (HOM_SPARSE_MAX_RANK_ONE_UPDATES+1) x m */
+  double* sNormSqrd;
+  int nSteps;
+
+  int valid;        /* 1 if the factorization may be used for the next step */
+  int age;          /* lambda steps since the last evaluation of the Jacobian */
+
+  klu_symbolic* symbolic;
+  klu_numeric* numeric;
+  klu_common common;
+} DATA_HOMOTOPY_SPARSE;
+#endif
+
 /*! \typedef DATA_HOMOTOPY
  * define memory structure for nonlinear system solver
  *  \author bbachmann
@@ -155,8 +204,135 @@ typedef struct DATA_HOMOTOPY
 
   DATA_HYBRD* dataHybrid;
 
+  /* sparse homotopy path, only used for the initialization */
+  int sparse;
+#ifdef HOMOTOPY_SPARSE
+  DATA_HOMOTOPY_SPARSE* sparseData;
+#endif
+
+  /* statistics of the last homotopy run, reported in LOG_INIT_HOMOTOPY */
+  int sparseRun;    /* 1 if the sparse path was used until the end of the run */
+  rtclock_t phaseClock;
+  double timeResidual;
+  double timeJacobian;
+  double timeFactorization;
+  double timeSolve;
+  int numberOfResiduals;
+  int numberOfJacobians;
+  int numberOfFactorizations;
+  int numberOfRankOneUpdates;
+
 } DATA_HOMOTOPY;
 
+#ifdef HOMOTOPY_SPARSE
+/**
+ * @brief Free sparse data of the homotopy path.
+ *
+ * @param sparseData  Pointer to sparse data.
+ */
+static void freeHomotopySparseData(DATA_HOMOTOPY_SPARSE* sparseData)
+{
+  if (sparseData->numeric)
+    klu_free_numeric(&sparseData->numeric, &sparseData->common);
+  if (sparseData->symbolic)
+    klu_free_symbolic(&sparseData->symbolic, &sparseData->common);
+  free(sparseData->Ap);
+  free(sparseData->Ai);
+  free(sparseData->Ax);
+  free(sparseData->b);
+  free(sparseData->v);
+  free(sparseData->c);
+  free(sparseData->z);
+  free(sparseData->s);
+  free(sparseData->sNormSqrd);
+  free(sparseData);
+}
+
+/**
+ * @brief Allocate sparse data of the homotopy path.
+ *
+ * The sparse path is used for systems with homotopy support that are solved with
+ * KLU and have an analytic Jacobian with sparsity pattern [dh/dx dh/dlambda].
+ *
+ * @param size                Size of non-linear system without lambda.
+ * @param userData            NLS user data.
+ * @return DATA_HOMOTOPY_SPARSE*   Pointer to allocated data or NULL if the sparse path can't be used.
+ */
+static DATA_HOMOTOPY_SPARSE* allocateHomotopySparseData(size_t size, NLS_USERDATA* userData)
+{
+  NONLINEAR_SYSTEM_DATA* nlsData = userData->nlsData;
+  ANALYTIC_JACOBIAN* jacobian = userData->analyticJacobian;
+  SPARSE_PATTERN* pattern;
+  DATA_HOMOTOPY_SPARSE* sparseData;
+  int i;
+
+  if (nlsData->nlsLinearSolver != NLS_LS_KLU || !nlsData->homotopySupport || nlsData->jacobianIndex == -1 ||
+      jacobian == NULL || jacobian->sparsePattern == NULL || jacobian->sizeRows != size || jacobian->sizeCols != size+1) {
+    return NULL;
+  }
+  pattern = jacobian->sparsePattern;
+
+  sparseData = (DATA_HOMOTOPY_SPARSE*) malloc(sizeof(DATA_HOMOTOPY_SPARSE));
+  assertStreamPrint(NULL, 0 != sparseData, "allocateHomotopySparseData() failed!");
+
+  /* the first size columns of the pattern are dh/dx in compressed column format */
+  sparseData->nnz = pattern->leadindex[size];
+  sparseData->Ap = (int*) malloc((size+1)*sizeof(int));
+  sparseData->Ai = (int*) malloc(sparseData->nnz*sizeof(int));
+  sparseData->Ax = (double*) calloc(sparseData->nnz, sizeof(double));
+  for (i=0; i<=size; i++) {
+    sparseData->Ap[i] = pattern->leadindex[i];
+  }
+  for (i=0; i<sparseData->nnz; i++) {
+    sparseData->Ai[i] = pattern->index[i];
+  }
+
+  sparseData->b = (double*) calloc(size, sizeof(double));
+  sparseData->v = (double*) calloc(size, sizeof(double));
+  sparseData->c = (double*) calloc(size+1, sizeof(double));
+  sparseData->z = (double*) calloc(size+1, sizeof(double));
+  sparseData->s = (double*) calloc((HOM_SPARSE_MAX_RANK_ONE_UPDATES+1)*(size+1), sizeof(double));
+  sparseData->sNormSqrd = (double*) calloc(HOM_SPARSE_MAX_RANK_ONE_UPDATES+1, sizeof(double));
+  sparseData->nSteps = 0;
+  sparseData->valid = 0;
+  sparseData->age = 0;
+
+  klu_defaults(&sparseData->common);
+  sparseData->numeric = NULL;
+  sparseData->symbolic = klu_analyze(size, sparseData->Ap, sparseData->Ai, &sparseData->common);
+  if (sparseData->symbolic == NULL) {
+    warningStreamPrint(LOG_INIT_HOMOTOPY, 0, "klu_analyze failed for the homotopy Jacobian of system %d, using dense linear algebra.", (int)nlsData->equationIndex);
+    freeHomotopySparseData(sparseData);
+    return NULL;
+  }
+  infoStreamPrint(LOG_INIT_HOMOTOPY, 0, "Using sparse homotopy path for system %d with %d non-zeros.", (int)nlsData->equationIndex, sparseData->nnz);
+
+  return sparseData;
+}
+#endif
+
+/**
+ * @brief Allocate the dense matrices of the homotopy solver.
+ *
+ * They are only allocated on demand if the sparse homotopy path is used.
+ *
+ * @param homotopyData  Pointer to homotopy data.
+ */
+static void allocateHomotopyDenseData(DATA_HOMOTOPY* homotopyData)
+{
+  size_t size = homotopyData->n;
+
+  if (homotopyData->fJac != NULL) {
+    return;
+  }
+  homotopyData->fJac = (double*) calloc((size*(size+1)),sizeof(double));
+  homotopyData->fJacx0 = (double*) calloc((size*(size+1)),sizeof(double));
+  homotopyData->debug_fJac = (double*) calloc((size*(size+1)),sizeof(double));
+  homotopyData->hJac  = (double*) calloc(size*(size+1),sizeof(double));
+  homotopyData->hJac2  = (double*) calloc((size+1)*(size+2),sizeof(double));
+  homotopyData->hJacInit  = (double*) calloc(size*(size+1),sizeof(double));
+}
+
 /**
  * @brief Allocate memory for non-linear homotopy solver.
  *
@@ -199,12 +375,9 @@ DATA_HOMOTOPY* allocateHomotopyData(size_t size, NLS_USERDATA* userData)
   homotopyData->x1 = (double*) calloc((size+1),sizeof(double));
   homotopyData->finit = (double*) calloc(size,sizeof(double));
   homotopyData->fx0 = (double*) calloc(size,sizeof(double));
-  homotopyData->fJac = (double*) calloc((size*(size+1)),sizeof(double));
-  homotopyData->fJacx0 = (double*) calloc((size*(size+1)),sizeof(double));
 
   /* debug arrays */
   homotopyData->debug_dx = (double*) calloc(size,sizeof(double));
-  homotopyData->debug_fJac = (double*) calloc((size*(size+1)),sizeof(double));
 
    /* homotopy */
   homotopyData->y0 = (double*) calloc((size+1),sizeof(double));
@@ -215,9 +388,6 @@ DATA_HOMOTOPY* allocateHomotopyData(size_t size, NLS_USERDATA* userData)
   homotopyData->dy1 = (double*) calloc((size+homBacktraceStrategy),sizeof(double));
   homotopyData->dy2 = (double*) calloc((size+1),sizeof(double));
   homotopyData->hvec = (double*) calloc(size,sizeof(double));
-  homotopyData->hJac  = (double*) calloc(size*(size+1),sizeof(double));
-  homotopyData->hJac2  = (double*) calloc((size+1)*(size+2),sizeof(double));
-  homotopyData->hJacInit  = (double*) calloc(size*(size+1),sizeof(double));
   homotopyData->ones  = (double*) calloc(size+1,sizeof(double));
 
   /* linear system */
@@ -228,6 +398,23 @@ DATA_HOMOTOPY* allocateHomotopyData(size_t size, NLS_USERDATA* userData)
 
   homotopyData->dataHybrid = allocateHybrdData(size, userData);
 
+  /* dense matrices [n x (n+1)] */
+  homotopyData->fJac = NULL;
+  homotopyData->fJacx0 = NULL;
+  homotopyData->debug_fJac = NULL;
+  homotopyData->hJac = NULL;
+  homotopyData->hJac2 = NULL;
+  homotopyData->hJacInit = NULL;
+#ifdef HOMOTOPY_SPARSE
+  homotopyData->sparseData = allocateHomotopySparseData(size, userData);
+  homotopyData->sparse = homotopyData->sparseData != NULL;
+#else
+  homotopyData->sparse = 0;
+#endif
+  if (!homotopyData->sparse) {
+    allocateHomotopyDenseData(homotopyData);
+  }
+
   assertStreamPrint(NULL, homotopyData != NULL, "allocationHomotopyData() voiddata failed!");
   return homotopyData;
 }
@@ -278,6 +465,11 @@ void freeHomotopyData(DATA_HOMOTOPY* homotopyData)
   free(homotopyData->indRow);
   free(homotopyData->indCol);
 
+#ifdef HOMOTOPY_SPARSE
+  if (homotopyData->sparseData)
+    freeHomotopySparseData(homotopyData->sparseData);
+#endif
+
   /* Don't free userData here, it's done in freeHybrdData */
   freeHybrdData(homotopyData->dataHybrid);
 
@@ -1318,6 +1510,374 @@ int linearSolverWrapper(int n, double* x, double* A, int* indRow, int* indCol, i
 }
 
 
+#ifdef HOMOTOPY_SPARSE
+/*! \fn getAnalyticalJacobianHomotopySparse
+ *
+ *  Evaluates the sparse homotopy Jacobian [dh/dx dh/dlambda] with the colored
+ *  analytic Jacobian, factorizes dh/dx with KLU and calculates (dh/dx)^-1*dh/dlambda.
+ *  The values of the last call of h_function are used.
+ *
+ *  \return 0 on success, -1 if dh/dx is singular
+ */
+static int getAnalyticalJacobianHomotopySparse(DATA_HOMOTOPY* solverData)
+{
+  int i, j, l, ii;
+  DATA* data = solverData->userData->data;
+  threadData_t *threadData = solverData->userData->threadData;
+  NONLINEAR_SYSTEM_DATA* nlsData = solverData->userData->nlsData;
+  ANALYTIC_JACOBIAN* jacobian = solverData->userData->analyticJacobian;
+  DATA_HOMOTOPY_SPARSE* sparseData = solverData->sparseData;
+  int n = solverData->n;
+
+  /* performance measurement */
+  rt_ext_tp_tick(&nlsData->jacobianTimeClock);
+  rt_ext_tp_tick(&solverData->phaseClock);
+
+  sparseData->valid = 0;
+  sparseData->nSteps = 0;
+  sparseData->age = 0;
+  vecConst(n, 0.0, sparseData->b);
+
+  if (jacobian->constantEqns != NULL) {
+    jacobian->constantEqns(data, threadData, jacobian, NULL);
+  }
+
+  for(i=0; i < jacobian->sparsePattern->maxColors; i++)
+  {
+    /* activate seed variable for the corresponding color */
+    for(ii=0; ii < jacobian->sizeCols; ii++)
+      if(jacobian->sparsePattern->colorCols[ii]-1 == i)
+        jacobian->seedVars[ii] = 1;
+
+    ((nlsData->analyticalJacobianColumn))(data, threadData, jacobian, NULL);
+
+    for(j = 0; j < jacobian->sizeCols; j++)
+    {
+      if(jacobian->seedVars[j] == 1)
+      {
+        for(ii = jacobian->sparsePattern->leadindex[j]; ii < jacobian->sparsePattern->leadindex[j+1]; ii++)
+        {
+          l = jacobian->sparsePattern->index[ii];
+          if (j < n)
+            sparseData->Ax[ii] = jacobian->resultVars[l] * solverData->xScaling[j];
+          else
+            sparseData->b[l] = jacobian->resultVars[l] * solverData->xScaling[j];
+        }
+      }
+      /* de-activate seed variable for the corresponding color */
+      if(jacobian->sparsePattern->colorCols[j]-1 == i)
+        jacobian->seedVars[j] = 0;
+    }
+  }
+
+  /* calculate scaling factor of residuals */
+  for (i=0; i<n; i++)
+    solverData->resScaling[i] = fabs(sparseData->b[i]);
+  for (ii=0; ii<sparseData->nnz; ii++)
+    solverData->resScaling[sparseData->Ai[ii]] += fabs(sparseData->Ax[ii]);
+
+  /* performance measurement and statistics */
+  solverData->timeJacobian += rt_ext_tp_tock(&solverData->phaseClock);
+  solverData->numberOfJacobians++;
+  nlsData->jacobianTime += rt_ext_tp_tock(&(nlsData->jacobianTimeClock));
+  nlsData->numberOfJEval++;
+
+  /* factorize dh/dx, keep the pivoting of the last factorization as long as it is stable */
+  rt_ext_tp_tick(&solverData->phaseClock);
+  if (sparseData->numeric) {
+    if (!klu_refactor(sparseData->Ap, sparseData->Ai, sparseData->Ax, sparseData->symbolic, sparseData->numeric, &sparseData->common) ||
+        !klu_rcond(sparseData->symbolic, sparseData->numeric, &sparseData->common) ||
+        sparseData->common.rcond < HOM_SPARSE_MIN_RCOND) {
+      klu_free_numeric(&sparseData->numeric, &sparseData->common);
+    }
+  }
+  if (sparseData->numeric == NULL) {
+    sparseData->numeric = klu_factor(sparseData->Ap, sparseData->Ai, sparseData->Ax, sparseData->symbolic, &sparseData->common);
+  }
+  solverData->numberOfFactorizations++;
+  if (sparseData->numeric == NULL || sparseData->common.status != KLU_OK ||
+      !klu_rcond(sparseData->symbolic, sparseData->numeric, &sparseData->common) ||
+      sparseData->common.rcond < HOM_SPARSE_MIN_RCOND) {
+    solverData->timeFactorization += rt_ext_tp_tock(&solverData->phaseClock);
+    debugDouble(LOG_NLS_HOMOTOPY, "sparse Jacobian dh/dx is singular, rcond =", sparseData->common.rcond);
+    return -1;
+  }
+  solverData->timeFactorization += rt_ext_tp_tock(&solverData->phaseClock);
+
+  rt_ext_tp_tick(&solverData->phaseClock);
+  vecCopy(n, sparseData->b, sparseData->v);
+  klu_solve(sparseData->symbolic, sparseData->numeric, n, 1, sparseData->v, &sparseData->common);
+  solverData->timeSolve += rt_ext_tp_tock(&solverData->phaseClock);
+
+  sparseData->valid = 1;
+  return 0;
+}
+
+/*! \fn homotopySparseBorderedSolve
+ *
+ *  Solves the bordered system [dh/dx dh/dlambda; c^T] * d = -[r; 0] in scaled
+ *  variables with the factorization of dh/dx by block elimination.
+ *
+ *  \return 0 on success, -1 if the bordered system is singular
+ */
+static int homotopySparseBorderedSolve(DATA_HOMOTOPY* solverData, double* r, double* c, double* d)
+{
+  DATA_HOMOTOPY_SPARSE* sparseData = solverData->sparseData;
+  int n = solverData->n;
+  double cu, cv;
+
+  rt_ext_tp_tick(&solverData->phaseClock);
+  vecAddInv(n, r, d);
+  klu_solve(sparseData->symbolic, sparseData->numeric, n, 1, d, &sparseData->common);
+  solverData->timeSolve += rt_ext_tp_tock(&solverData->phaseClock);
+
+  cu = vecScalarProd(n, c, d);
+  cv = vecScalarProd(n, c, sparseData->v) - c[n];
+  if (fabs(cv) < DBL_EPSILON) {
+    return -1;
+  }
+  d[n] = cu/cv;
+  vecAddScal(n, d, sparseData->v, -d[n], d);
+
+  return 0;
+}
+
+/*! \fn homotopySparseTangent
+ *
+ *  Calculates the tangent vector dy0 (original scaling) of the homotopy path with
+ *  the current factorization. The largest component of the scaled tangent is 1.0
+ *  and its index is returned in pos, like in solveSystemWithTotalPivotSearch.
+ */
+static void homotopySparseTangent(DATA_HOMOTOPY* solverData, int *pos)
+{
+  DATA_HOMOTOPY_SPARSE* sparseData = solverData->sparseData;
+  int i, n = solverData->n;
+  double absMax;
+
+  vecAddInv(n, sparseData->v, solverData->dy0);
+  solverData->dy0[n] = 1.0;
+  *pos = n;
+  absMax = 1.0;
+  for (i=0; i<n; i++) {
+    if (fabs(solverData->dy0[i]) > absMax) {
+      absMax = fabs(solverData->dy0[i]);
+      *pos = i;
+    }
+  }
+  vecScalarMult(solverData->m, solverData->dy0, 1.0/solverData->dy0[*pos], solverData->dy0);
+  debugInt(LOG_NLS_V, "position of largest value = ", *pos);
+}
+
+/*! \fn homotopySparseRankOneStep
+ *
+ *  Calculates the scaled corrector step for the residual hvec with the factorization
+ *  of the last Jacobian and Broyden's rank-one updates of the previous steps
+ *  (C. T. Kelley, Iterative Methods for Linear and Nonlinear Equations, Algorithm brsol).
+ *
+ *  \return 0 on success, 1 if the Jacobian has to be evaluated again, -1 if the system is singular
+ */
+static int homotopySparseRankOneStep(DATA_HOMOTOPY* solverData, double* c, double* dy)
+{
+  DATA_HOMOTOPY_SPARSE* sparseData = solverData->sparseData;
+  int i, m = solverData->m, k = sparseData->nSteps;
+  double* z = sparseData->z;
+  double denominator;
+
+  if (k > HOM_SPARSE_MAX_RANK_ONE_UPDATES) {
+    return 1;
+  }
+  if (homotopySparseBorderedSolve(solverData, solverData->hvec, c, z)) {
+    return k > 0 ? 1 : -1;
+  }
+  if (k > 0) {
+    for (i=0; i<k-1; i++) {
+      vecAddScal(m, z, sparseData->s + (i+1)*m, vecScalarProd(m, sparseData->s + i*m, z)/sparseData->sNormSqrd[i], z);
+    }
+    denominator = 1.0 - vecScalarProd(m, sparseData->s + (k-1)*m, z)/sparseData->sNormSqrd[k-1];
+    if (fabs(denominator) < 1e-8) {
+      return 1;
+    }
+    vecScalarMult(m, z, 1.0/denominator, z);
+    solverData->numberOfRankOneUpdates++;
+  }
+  sparseData->sNormSqrd[k] = vec2NormSqrd(m, z);
+  if (sparseData->sNormSqrd[k] < DBL_MIN) {
+    return k > 0 ? 1 : -1;
+  }
+  vecCopy(m, z, sparseData->s + k*m);
+  sparseData->nSteps = k+1;
+  vecCopy(m, z, dy);
+
+  return 0;
+}
+
+/*! \fn homotopySparseCorrector
+ *
+ *  Calculates the scaled corrector step dy1 at y1 for the given backtrace strategy.
+ *  The Jacobian is only evaluated again, if there is no valid factorization, the
+ *  last step did not reduce the residual enough or the rank-one updates break down.
+ *
+ *  \return 0 on success, 1 if the Jacobian could not be calculated, -1 if the system is singular
+ */
+static int homotopySparseCorrector(DATA_HOMOTOPY* solverData, int correctorStrategy, int pos, int firstIteration, int refresh)
+{
+  threadData_t *threadData = solverData->userData->threadData;
+  DATA_HOMOTOPY_SPARSE* sparseData = solverData->sparseData;
+  int m = solverData->m;
+  int assert, info = 0;
+
+  /* last row of the bordered system */
+  if (correctorStrategy==1) {
+    vecConst(m, 0.0, sparseData->c);
+    sparseData->c[pos] = 1.0;
+  } else {
+    vecCopy(m, solverData->dy0, sparseData->c);
+  }
+
+  /* the rank-one updates belong to the bordered system of this corrector */
+  if (firstIteration)
+    sparseData->nSteps = 0;
+  refresh = refresh || !sparseData->valid;
+
+  while (1)
+  {
+    if (refresh)
+    {
+      assert = 1;
+#ifndef OMC_EMCC
+      MMC_TRY_INTERNAL(simulationJumpBuffer)
+#endif
+      info = getAnalyticalJacobianHomotopySparse(solverData);
+      assert = 0;
+#ifndef OMC_EMCC
+      MMC_CATCH_INTERNAL(simulationJumpBuffer)
+#endif
+      if (assert) {
+        sparseData->valid = 0;
+        return 1;
+      }
+      if (info) {
+        return -1;
+      }
+    }
+    info = homotopySparseRankOneStep(solverData, sparseData->c, solverData->dy1);
+    if (info == 1 && !refresh) {
+      debugString(LOG_NLS_HOMOTOPY, "Rank-one update not accurate enough, evaluate the Jacobian again.");
+      refresh = 1;
+      continue;
+    }
+    return info == 1 ? -1 : info;
+  }
+}
+#endif
+
+/*! \fn homotopyResidual
+ *
+ *  Evaluates the homotopy function and measures its time.
+ */
+static int homotopyResidual(DATA_HOMOTOPY* solverData, double* y, double* h)
+{
+  int retVal;
+
+  rt_ext_tp_tick(&solverData->phaseClock);
+  retVal = solverData->h_function(solverData, y, h);
+  solverData->timeResidual += rt_ext_tp_tock(&solverData->phaseClock);
+  solverData->numberOfResiduals++;
+
+  return retVal;
+}
+
+/*! \fn homotopyTangent
+ *
+ *  Calculates the scaled tangent vector dy0 of the homotopy path at y0.
+ *  The sparse path reuses the last factorization for a few lambda steps and
+ *  switches to dense linear algebra for the rest of the run, if dh/dx is singular.
+ *
+ *  \return 0 on success, 1 if the Jacobian could not be calculated, -1 if the system is singular
+ */
+static int homotopyTangent(DATA_HOMOTOPY* solverData, int* useSparse, int* pos, int* rank)
+{
+  threadData_t *threadData = solverData->userData->threadData;
+  int assert = 1;
+  int info = 0;
+
+#ifdef HOMOTOPY_SPARSE
+  if (*useSparse)
+  {
+    DATA_HOMOTOPY_SPARSE* sparseData = solverData->sparseData;
+#ifndef OMC_EMCC
+    MMC_TRY_INTERNAL(simulationJumpBuffer)
+#endif
+    if (sparseData->valid && sparseData->age < HOM_SPARSE_MAX_TANGENT_AGE) {
+      debugInt(LOG_NLS_HOMOTOPY, "Reuse factorization for the tangent vector, lambda steps since last Jacobian: ", sparseData->age);
+      sparseData->age++;
+    } else {
+      info = getAnalyticalJacobianHomotopySparse(solverData);
+    }
+    assert = 0;
+#ifndef OMC_EMCC
+    MMC_CATCH_INTERNAL(simulationJumpBuffer)
+#endif
+    if (assert) {
+      sparseData->valid = 0;
+      return 1;
+    }
+    if (info == 0) {
+      homotopySparseTangent(solverData, pos);
+      *rank = solverData->n;
+      return 0;
+    }
+    infoStreamPrint(LOG_INIT_HOMOTOPY, 0, "Sparse Jacobian is singular at lambda = %g, continue with dense linear algebra.", solverData->y0[solverData->n]);
+    *useSparse = 0;
+    allocateHomotopyDenseData(solverData);
+    assert = 1;
+  }
+#endif
+
+#ifndef OMC_EMCC
+  MMC_TRY_INTERNAL(simulationJumpBuffer)
+#endif
+  rt_ext_tp_tick(&solverData->phaseClock);
+  solverData->hJac_dh(solverData, solverData->y0, solverData->hJac);
+  solverData->timeJacobian += rt_ext_tp_tock(&solverData->phaseClock);
+  solverData->numberOfJacobians++;
+  debugMatrixDouble(LOG_NLS_JAC,"Jacobian hJac:",solverData->hJac, solverData->n, solverData->n+1);
+  scaleMatrixRows(solverData->n, solverData->m, solverData->hJac);
+  debugMatrixDouble(LOG_NLS_JAC,"Jacobian hJac after scaling:",solverData->hJac, solverData->n, solverData->n+1);
+  assert = 0;
+#ifndef OMC_EMCC
+  MMC_CATCH_INTERNAL(simulationJumpBuffer)
+#endif
+  if (assert) {
+    return 1;
+  }
+
+  /* stable solution algorithm for solving a generalized over-determined linear system */
+  *pos = -1;
+  rt_ext_tp_tick(&solverData->phaseClock);
+  info = solveSystemWithTotalPivotSearch(solverData->n, solverData->dy0, solverData->hJac, solverData->indRow, solverData->indCol, pos, rank, solverData->casualTearingSet);
+  solverData->timeFactorization += rt_ext_tp_tock(&solverData->phaseClock);
+  solverData->numberOfFactorizations++;
+
+  return info == -1 ? -1 : 0;
+}
+
+/*! \fn printHomotopyStatistics
+ *
+ *  Prints the per-phase statistics of the last homotopy run.
+ */
+static void printHomotopyStatistics(DATA_HOMOTOPY* solverData)
+{
+  if (!ACTIVE_STREAM(LOG_INIT_HOMOTOPY)) return;
+  infoStreamPrint(LOG_INIT_HOMOTOPY, 1, "homotopy statistics (%s linear algebra)", solverData->sparseRun ? "sparse" : "dense");
+  infoStreamPrint(LOG_INIT_HOMOTOPY, 0, "%5d residual evaluations:  %gs", solverData->numberOfResiduals, solverData->timeResidual);
+  infoStreamPrint(LOG_INIT_HOMOTOPY, 0, "%5d Jacobian evaluations:  %gs", solverData->numberOfJacobians, solverData->timeJacobian);
+  infoStreamPrint(LOG_INIT_HOMOTOPY, 0, "%5d factorizations:        %gs", solverData->numberOfFactorizations, solverData->timeFactorization);
+  infoStreamPrint(LOG_INIT_HOMOTOPY, 0, "      solves:                %gs", solverData->timeSolve);
+  infoStreamPrint(LOG_INIT_HOMOTOPY, 0, "%5d rank-one updates", solverData->numberOfRankOneUpdates);
+  messageClose(LOG_INIT_HOMOTOPY);
+}
+
 /*! \fn solve system with damped Newton-Raphson
  *
  *  \author bbachmann
@@ -1708,6 +2268,10 @@ static int homotopyAlgorithm(DATA_HOMOTOPY* solverData, double *x)
   int n = solverData->n;
   int initialStep = 1;
   int maxLambdaSteps = homMaxLambdaSteps ? homMaxLambdaSteps : solverData->maxNumberOfIterations;
+  int tangentStatus, info;
+#ifdef HOMOTOPY_SPARSE
+  double error_h_last = 0;
+#endif
 
   int assert = 1;
   DATA* data = solverData->userData->data;
@@ -1742,6 +2306,17 @@ static int homotopyAlgorithm(DATA_HOMOTOPY* solverData, double *x)
     }
 #endif
 
+  /* reset statistics, the sparse path is only used for the initialization */
+  solverData->sparseRun = solverData->sparse && solverData->initHomotopy;
+  solverData->timeResidual = solverData->timeJacobian = solverData->timeFactorization = solverData->timeSolve = 0;
+  solverData->numberOfResiduals = solverData->numberOfJacobians = solverData->numberOfFactorizations = solverData->numberOfRankOneUpdates = 0;
+#ifdef HOMOTOPY_SPARSE
+  if (solverData->sparseRun)
+    solverData->sparseData->valid = 0;
+#endif
+  if (!solverData->sparseRun)
+    allocateHomotopyDenseData(solverData);
+
   /* Initialize vector dy2 using chosen startDirection */
   /* set start vector, lambda = 0.0 */
   vecCopy(solverData->n, x, solverData->y0);
@@ -1754,7 +2329,7 @@ static int homotopyAlgorithm(DATA_HOMOTOPY* solverData, double *x)
 #ifndef OMC_EMCC
     MMC_TRY_INTERNAL(simulationJumpBuffer)
 #endif
-    solverData->h_function(solverData, solverData->y0, solverData->hvec);
+    homotopyResidual(solverData, solverData->y0, solverData->hvec);
     assert = 0;
 #ifndef OMC_EMCC
     MMC_CATCH_INTERNAL(simulationJumpBuffer)
@@ -1807,27 +2382,14 @@ static int homotopyAlgorithm(DATA_HOMOTOPY* solverData, double *x)
     /* If a step succeeded, calculate the homotopy function and corresponding jacobian */
     if (iter==0)
     {
-    /* Handle asserts of function calls, mainly necessary for fluid stuff */
-      assert = 1;
-#ifndef OMC_EMCC
-    MMC_TRY_INTERNAL(simulationJumpBuffer)
-#endif
-      solverData->hJac_dh(solverData, solverData->y0, solverData->hJac);
-      debugMatrixDouble(LOG_NLS_JAC,"Jacobian hJac:",solverData->hJac, solverData->n, solverData->n+1);
-      scaleMatrixRows(solverData->n, solverData->m, solverData->hJac);
-      debugMatrixDouble(LOG_NLS_JAC,"Jacobian hJac after scaling:",solverData->hJac, solverData->n, solverData->n+1);
-      assert = 0;
-      pos = -1; /* stable solution algorithm for solving a generalized over-determined linear system */
-#ifndef OMC_EMCC
-    MMC_CATCH_INTERNAL(simulationJumpBuffer)
-#endif
-
-      if (assert || (solveSystemWithTotalPivotSearch(solverData->n, solverData->dy0, solverData->hJac, solverData->indRow, solverData->indCol, &pos, &rank, solverData->casualTearingSet) == -1))
+      /* Handle asserts of function calls, mainly necessary for fluid stuff */
+      tangentStatus = homotopyTangent(solverData, &solverData->sparseRun, &pos, &rank);
+      if (tangentStatus)
       {
         /* report solver abortion */
         solverData->info=-1;
         /* debug information */
-        if (assert) {
+        if (tangentStatus == 1) {
           if (solverData->initHomotopy)
             warningStreamPrint(LOG_ASSERT, 0, "Homotopy algorithm did not converge.\nIt was not possible to calculate the jacobian.\nYou can use -lv=LOG_INIT_HOMOTOPY,LOG_NLS_HOMOTOPY to get more information.");
           else {
@@ -1882,7 +2444,7 @@ static int homotopyAlgorithm(DATA_HOMOTOPY* solverData, double *x)
       MMC_TRY_INTERNAL(simulationJumpBuffer)
 #endif
       debugVectorDouble(LOG_NLS_HOMOTOPY,"y1 (predictor step):",solverData->y1, m);
-      solverData->h_function(solverData, solverData->y1, solverData->hvec);
+      homotopyResidual(solverData, solverData->y1, solverData->hvec);
       debugVectorDouble(LOG_NLS_HOMOTOPY,"hvec (predictor step):",solverData->hvec, n);
       assert = 0;
 #ifndef OMC_EMCC
@@ -1949,58 +2511,96 @@ static int homotopyAlgorithm(DATA_HOMOTOPY* solverData, double *x)
         stepAccept = 1;
         break;
       }
-      assert = 1;
-#ifndef OMC_EMCC
-    MMC_TRY_INTERNAL(simulationJumpBuffer)
-#endif
-      /* calculate homotopy jacobian */
-      solverData->hJac_dh(solverData, solverData->y1, solverData->hJac);
-      debugMatrixDouble(LOG_NLS_JAC,"Jacobian hJac:",solverData->hJac, solverData->n, solverData->n+1);
-
-      if (correctorStrategy==2)
-      {
-        /* calculate the newton matrix hJac2 for the orthogonal backtrace strategy */
-        orthogonalBacktraceMatrix(solverData, solverData->hJac, solverData->hvec, solverData->dy0, solverData->hJac2, solverData->n, solverData->m);
-        debugMatrixDouble(LOG_NLS_JAC,"Enhanced Jacobian hJac2 (orthogonal backtrace strategy):",solverData->hJac2, solverData->n+1, solverData->m+1);
-      }
-
-      assert = 0;
-#ifndef OMC_EMCC
-    MMC_CATCH_INTERNAL(simulationJumpBuffer)
-#endif
-      if (assert)
+#ifdef HOMOTOPY_SPARSE
+      if (solverData->sparseRun)
       {
-        debugString(LOG_NLS_HOMOTOPY, "step NOT accepted, because hJac_dh could not be calculated!");
-        stepAccept = 0;
-        break;
-      }
-      matVecMultAbs(solverData->n, solverData->m, solverData->hJac, solverData->ones, solverData->resScaling);
-      debugVectorDouble(LOG_NLS_HOMOTOPY, "residuum scaling of function h:", solverData->resScaling, solverData->n);
-
-      if (correctorStrategy==1) // fix one coordinate
-      {
-        /* copy vector h to column "pos" of the jacobian */
-        debugVectorDouble(LOG_NLS_HOMOTOPY, "copy vector hvec to column 'pos' of the jacobian:", solverData->hvec, solverData->n);
-        vecCopy(solverData->n, solverData->hvec, solverData->hJac + pos*solverData->n);
-        scaleMatrixRows(solverData->n, solverData->m, solverData->hJac);
-        if (solveSystemWithTotalPivotSearch(solverData->n, solverData->dy1, solverData->hJac, solverData->indRow, solverData->indCol, &pos, &rank, solverData->casualTearingSet) == -1)
+        /* Jacobian is only evaluated, if the last step did not reduce the residual enough */
+        error_h = vec2Norm(solverData->n, solverData->hvec);
+        info = homotopySparseCorrector(solverData, correctorStrategy, pos, j==0, j>0 && error_h > HOM_SPARSE_CONTRACTION*error_h_last);
+        error_h_last = error_h;
+        if (info == 1)
+        {
+          debugString(LOG_NLS_HOMOTOPY, "step NOT accepted, because hJac_dh could not be calculated!");
+          assert = 1;
+          stepAccept = 0;
+          break;
+        }
+        if (info == -1)
         {
-          debugString(LOG_NLS_HOMOTOPY, "step NOT accepted, because solveSystemWithTotalPivotSearch failed!");
+          debugString(LOG_NLS_HOMOTOPY, "step NOT accepted, because the sparse bordered system is singular!");
           stepAccept = 0;
           break;
         }
-        solverData->dy1[pos] = 0.0;
+        if (correctorStrategy==1)
+          solverData->dy1[pos] = 0.0;
       }
-      else // go back in orthogonal direction to tangent vector
+      else
+#endif
       {
-        scaleMatrixRows(solverData->n+1, solverData->m+1, solverData->hJac2);
-        pos = solverData->n+1;
-        if (solveSystemWithTotalPivotSearch(solverData->n+1, solverData->dy1, solverData->hJac2, solverData->indRow, solverData->indCol, &pos, &rank, solverData->casualTearingSet) == -1)
+        assert = 1;
+#ifndef OMC_EMCC
+        MMC_TRY_INTERNAL(simulationJumpBuffer)
+#endif
+        /* calculate homotopy jacobian */
+        rt_ext_tp_tick(&solverData->phaseClock);
+        solverData->hJac_dh(solverData, solverData->y1, solverData->hJac);
+        solverData->timeJacobian += rt_ext_tp_tock(&solverData->phaseClock);
+        solverData->numberOfJacobians++;
+        debugMatrixDouble(LOG_NLS_JAC,"Jacobian hJac:",solverData->hJac, solverData->n, solverData->n+1);
+
+        if (correctorStrategy==2)
+        {
+          /* calculate the newton matrix hJac2 for the orthogonal backtrace strategy */
+          orthogonalBacktraceMatrix(solverData, solverData->hJac, solverData->hvec, solverData->dy0, solverData->hJac2, solverData->n, solverData->m);
+          debugMatrixDouble(LOG_NLS_JAC,"Enhanced Jacobian hJac2 (orthogonal backtrace strategy):",solverData->hJac2, solverData->n+1, solverData->m+1);
+        }
+
+        assert = 0;
+#ifndef OMC_EMCC
+        MMC_CATCH_INTERNAL(simulationJumpBuffer)
+#endif
+        if (assert)
         {
-          debugString(LOG_NLS_HOMOTOPY, "step NOT accepted, because solveSystemWithTotalPivotSearch failed!");
+          debugString(LOG_NLS_HOMOTOPY, "step NOT accepted, because hJac_dh could not be calculated!");
           stepAccept = 0;
           break;
         }
+        matVecMultAbs(solverData->n, solverData->m, solverData->hJac, solverData->ones, solverData->resScaling);
+        debugVectorDouble(LOG_NLS_HOMOTOPY, "residuum scaling of function h:", solverData->resScaling, solverData->n);
+
+        if (correctorStrategy==1) // fix one coordinate
+        {
+          /* copy vector h to column "pos" of the jacobian */
+          debugVectorDouble(LOG_NLS_HOMOTOPY, "copy vector hvec to column 'pos' of the jacobian:", solverData->hvec, solverData->n);
+          vecCopy(solverData->n, solverData->hvec, solverData->hJac + pos*solverData->n);
+          scaleMatrixRows(solverData->n, solverData->m, solverData->hJac);
+          rt_ext_tp_tick(&solverData->phaseClock);
+          info = solveSystemWithTotalPivotSearch(solverData->n, solverData->dy1, solverData->hJac, solverData->indRow, solverData->indCol, &pos, &rank, solverData->casualTearingSet);
+          solverData->timeFactorization += rt_ext_tp_tock(&solverData->phaseClock);
+          solverData->numberOfFactorizations++;
+          if (info == -1)
+          {
+            debugString(LOG_NLS_HOMOTOPY, "step NOT accepted, because solveSystemWithTotalPivotSearch failed!");
+            stepAccept = 0;
+            break;
+          }
+          solverData->dy1[pos] = 0.0;
+        }
+        else // go back in orthogonal direction to tangent vector
+        {
+          scaleMatrixRows(solverData->n+1, solverData->m+1, solverData->hJac2);
+          pos = solverData->n+1;
+          rt_ext_tp_tick(&solverData->phaseClock);
+          info = solveSystemWithTotalPivotSearch(solverData->n+1, solverData->dy1, solverData->hJac2, solverData->indRow, solverData->indCol, &pos, &rank, solverData->casualTearingSet);
+          solverData->timeFactorization += rt_ext_tp_tock(&solverData->phaseClock);
+          solverData->numberOfFactorizations++;
+          if (info == -1)
+          {
+            debugString(LOG_NLS_HOMOTOPY, "step NOT accepted, because solveSystemWithTotalPivotSearch failed!");
+            stepAccept = 0;
+            break;
+          }
+        }
       }
 
       /* Scaling back to original variables */
@@ -2015,7 +2615,7 @@ static int homotopyAlgorithm(DATA_HOMOTOPY* solverData, double *x)
     MMC_TRY_INTERNAL(simulationJumpBuffer)
 #endif
       /* calculate homotopy function */
-      solverData->h_function(solverData, solverData->y1, solverData->hvec);
+      homotopyResidual(solverData, solverData->y1, solverData->hvec);
       assert = 0;
 #ifndef OMC_EMCC
     MMC_CATCH_INTERNAL(simulationJumpBuffer)
@@ -2072,6 +2672,11 @@ static int homotopyAlgorithm(DATA_HOMOTOPY* solverData, double *x)
         /* update statistics */
         return -1;
       }
+#ifdef HOMOTOPY_SPARSE
+      /* evaluate the Jacobian in the next corrector step */
+      if (solverData->sparseRun)
+        solverData->sparseData->valid = 0;
+#endif
       debugString(LOG_NLS_HOMOTOPY, "The relation between the vector length of corrector step and predictor step is too big:");
       debugDouble(LOG_NLS_HOMOTOPY, "bend/adaptBend  =", bend/adaptBend);
       debugString(LOG_NLS_HOMOTOPY, "--- decreasing step size tau in corrector step!");
@@ -2169,6 +2774,8 @@ modelica_boolean solveHomotopy(DATA *data, threadData_t *threadData, NONLINEAR_S
   homotopyData->casualTearingSet = nlsData->strictTearingFunctionCall != NULL;
   int constraintViolated;
   homotopyData->initHomotopy = nlsData->initHomotopy;
+  if (!homotopyData->initHomotopy)
+    allocateHomotopyDenseData(homotopyData);
 
   modelica_boolean* relationsPreBackup;
   relationsPreBackup = (modelica_boolean*) malloc(data->modelData->nRelations*sizeof(modelica_boolean));
@@ -2457,6 +3064,8 @@ modelica_boolean solveHomotopy(DATA *data, threadData_t *threadData, NONLINEAR_S
     }
 
     homotopyAlgorithm(homotopyData, homotopyData->x);
+    if (homotopyData->initHomotopy)
+      printHomotopyStatistics(homotopyData);
 
     if (homotopyData->info<1)
     {
@@ -650,6 +650,10 @@ typedef struct SIMULATION_INFO
   double loggingTimeRecord[2];         /* Time interval in which logging is active. Only used if useLoggingTime=1 */
   int useLoggingTime;                  /* 0 if logging is currently disabled, 1 if enabled */
 
+  modelica_real* linearizationTimes;   /* points of time before stopTime for additional linearizations, see flag -l */
+  int nLinearizationTimes;
+  int nextLinearizationTime;           /* index of the next point of time in linearizationTimes */
+
   LINEAR_SOLVER lsMethod;              /* linear solver */
   LINEAR_SPARSE_SOLVER lssMethod;      /* linear sparse solver */
   int mixedMethod;                     /* mixed solver */
@@ -508,6 +508,18 @@ int doubleEndedListLen(DOUBLE_ENDED_LIST *list) {
 }
 
 
+/**
+ * @brief Returns size of the item data of double ended lists.
+ *
+ * @param list              Double ended list.
+ * @return unsigned int     Size of item data.
+ */
+unsigned int doubleEndedListItemSize(DOUBLE_ENDED_LIST *list) {
+  assertStreamPrint(NULL, 0 != list, "doubleEndedListItemSize: invalid list-pointer");
+  return list->itemSize;
+}
+
+
 /**
  * @brief Print a double ended list with provided print function.
  *
@@ -78,6 +78,7 @@ extern "C" {
 
   /* Section for small helper functions */
   int doubleEndedListLen(DOUBLE_ENDED_LIST *list);
+  unsigned int doubleEndedListItemSize(DOUBLE_ENDED_LIST *list);
   void doubleEndedListPrint(DOUBLE_ENDED_LIST *list, int stream, void (*printDataFunc)(void*,int,void*));
 
 #ifdef __cplusplus
@@ -0,0 +1,172 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+
+/*! \file omc_prof_hist.c
+ */
+
+#include "omc_prof_hist.h"
+#include "omc_file.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char omc_prof_hist_magic[8] = {'O','M','C','P','H','S','T','1'};
+
+int omc_prof_hist_init(OMC_PROF_HIST *hist, uint32_t nRows, uint32_t interval)
+{
+  memset(&hist->header, 0, sizeof(OMC_PROF_HIST_HEADER));
+  memcpy(hist->header.magic, omc_prof_hist_magic, sizeof(omc_prof_hist_magic));
+  hist->header.nRows = nRows;
+  hist->header.nBuckets = OMC_PROF_HIST_BUCKETS;
+  hist->header.interval = interval > 0 ? interval : 1;
+  hist->countdown = 0;
+  hist->rows = (OMC_PROF_HIST_ROW*) calloc(nRows > 0 ? nRows : 1, sizeof(OMC_PROF_HIST_ROW));
+  return hist->rows == NULL;
+}
+
+void omc_prof_hist_free(OMC_PROF_HIST *hist)
+{
+  free(hist->rows);
+  hist->rows = NULL;
+}
+
+int omc_prof_hist_step(OMC_PROF_HIST *hist)
+{
+  hist->header.nSteps++;
+  if (hist->countdown) {
+    hist->countdown--;
+    return 0;
+  }
+  hist->countdown = hist->header.interval - 1;
+  hist->header.nSampled++;
+  return 1;
+}
+
+int omc_prof_hist_bucket(double time)
+{
+  int e;
+  double ns = time * 1e9;
+  if (!(ns >= 1.0)) {
+    return 0;
+  }
+  /* ns = m*2^e with 0.5 <= m < 1, i.e., 2^(e-1) <= ns < 2^e */
+  frexp(ns, &e);
+  return e < OMC_PROF_HIST_BUCKETS ? e : OMC_PROF_HIST_BUCKETS - 1;
+}
+
+double omc_prof_hist_bucket_limit(int bucket)
+{
+  return bucket < OMC_PROF_HIST_BUCKETS - 1 ? ldexp(1e-9, bucket) : HUGE_VAL;
+}
+
+void omc_prof_hist_add(OMC_PROF_HIST *hist, uint32_t row, double time, uint32_t ncall)
+{
+  OMC_PROF_HIST_ROW *r = hist->rows + row;
+  if (ncall == 0) {
+    return;
+  }
+  r->ncall += ncall;
+  r->nsteps++;
+  r->time += time;
+  if (time > r->maxTime) {
+    r->maxTime = time;
+  }
+  r->buckets[omc_prof_hist_bucket(time)]++;
+}
+
+void omc_prof_hist_merge(OMC_PROF_HIST *dst, const OMC_PROF_HIST *src)
+{
+  uint32_t i;
+  int b;
+  for (i = 0; i < dst->header.nRows; i++) {
+    OMC_PROF_HIST_ROW *d = dst->rows + i;
+    const OMC_PROF_HIST_ROW *s = src->rows + i;
+    d->ncall += s->ncall;
+    d->nsteps += s->nsteps;
+    d->time += s->time;
+    if (s->maxTime > d->maxTime) {
+      d->maxTime = s->maxTime;
+    }
+    for (b = 0; b < OMC_PROF_HIST_BUCKETS; b++) {
+      d->buckets[b] += s->buckets[b];
+    }
+  }
+}
+
+int omc_prof_hist_write(const OMC_PROF_HIST *hist, const char *filename)
+{
+  int fail;
+  FILE *file = omc_fopen(filename, "wb");
+  if (!file) {
+    return 1;
+  }
+  fail = 1 != fwrite(&hist->header, sizeof(OMC_PROF_HIST_HEADER), 1, file);
+  fail = fail || hist->header.nRows != fwrite(hist->rows, sizeof(OMC_PROF_HIST_ROW), hist->header.nRows, file);
+  return fclose(file) || fail;
+}
+
+int omc_prof_hist_reader_open(OMC_PROF_HIST_READER *reader, const char *filename)
+{
+  reader->row = 0;
+  reader->file = omc_fopen(filename, "rb");
+  if (!reader->file) {
+    return 1;
+  }
+  if (1 != fread(&reader->header, sizeof(OMC_PROF_HIST_HEADER), 1, reader->file) ||
+      memcmp(reader->header.magic, omc_prof_hist_magic, sizeof(omc_prof_hist_magic)) ||
+      reader->header.nBuckets != OMC_PROF_HIST_BUCKETS) {
+    omc_prof_hist_reader_close(reader);
+    return 1;
+  }
+  return 0;
+}
+
+int omc_prof_hist_reader_next(OMC_PROF_HIST_READER *reader, OMC_PROF_HIST_ROW *row)
+{
+  if (!reader->file || reader->row >= reader->header.nRows) {
+    return 1;
+  }
+  if (1 != fread(row, sizeof(OMC_PROF_HIST_ROW), 1, reader->file)) {
+    omc_prof_hist_reader_close(reader);
+    return 1;
+  }
+  reader->row++;
+  return 0;
+}
+
+void omc_prof_hist_reader_close(OMC_PROF_HIST_READER *reader)
+{
+  if (reader->file) {
+    fclose(reader->file);
+    reader->file = NULL;
+  }
+}
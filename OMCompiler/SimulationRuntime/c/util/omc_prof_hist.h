@@ -0,0 +1,122 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+
+/*! \file omc_prof_hist.h
+ *
+ * Aggregated profiling data (-measureTimeHistogram).
+ *
+ * Instead of one row of timers per output step (the _prof.intdata and
+ * _prof.realdata files) the time spent per step in each profiled function or
+ * equation is collected in a histogram with power-of-two buckets, together
+ * with the number of calls, the sum and the maximum. The size of the written
+ * file only depends on the number of profiled blocks, not on the length of the
+ * simulation.
+ *
+ * An OMC_PROF_HIST has no global state; use one per thread and merge them
+ * with omc_prof_hist_merge if several threads measure.
+ *
+ * The file is read back row by row with an OMC_PROF_HIST_READER, so the
+ * reports can be generated in constant memory.
+ */
+
+#ifndef OMC_PROF_HIST_H
+#define OMC_PROF_HIST_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* bucket b holds the times in [2^(b-1), 2^b) ns, bucket 0 everything below 1 ns
+ * and the last bucket everything from 2^46 ns (about 20 hours) on */
+#define OMC_PROF_HIST_BUCKETS 48
+
+typedef struct OMC_PROF_HIST_ROW {
+  uint64_t ncall;     /* number of calls in the sampled steps */
+  uint64_t nsteps;    /* number of sampled steps with at least one call */
+  double time;        /* total time in the sampled steps */
+  double maxTime;     /* maximum time of a single step */
+  uint64_t buckets[OMC_PROF_HIST_BUCKETS];
+} OMC_PROF_HIST_ROW;
+
+typedef struct OMC_PROF_HIST_HEADER {
+  char magic[8];
+  uint32_t nRows;
+  uint32_t nBuckets;
+  uint32_t interval;  /* every interval-th step is sampled */
+  uint32_t reserved;
+  uint64_t nSteps;    /* number of steps */
+  uint64_t nSampled;  /* number of sampled steps */
+} OMC_PROF_HIST_HEADER;
+
+typedef struct OMC_PROF_HIST {
+  OMC_PROF_HIST_HEADER header;
+  OMC_PROF_HIST_ROW *rows;
+  uint32_t countdown;
+} OMC_PROF_HIST;
+
+typedef struct OMC_PROF_HIST_READER {
+  FILE *file;
+  OMC_PROF_HIST_HEADER header;
+  uint32_t row;
+} OMC_PROF_HIST_READER;
+
+/* Initializes hist for nRows timers, sampling every interval-th step. Returns non-zero on failure. */
+int omc_prof_hist_init(OMC_PROF_HIST *hist, uint32_t nRows, uint32_t interval);
+void omc_prof_hist_free(OMC_PROF_HIST *hist);
+
+/* Counts a step; returns non-zero if the step is sampled and its timers should be added. */
+int omc_prof_hist_step(OMC_PROF_HIST *hist);
+/* Adds the time and number of calls of a row in the current step. */
+void omc_prof_hist_add(OMC_PROF_HIST *hist, uint32_t row, double time, uint32_t ncall);
+/* Adds the data of src to dst; both must have the same number of rows. */
+void omc_prof_hist_merge(OMC_PROF_HIST *dst, const OMC_PROF_HIST *src);
+
+int omc_prof_hist_bucket(double time);
+/* Upper limit of the bucket in seconds */
+double omc_prof_hist_bucket_limit(int bucket);
+
+/* Writes the histograms to filename. Returns non-zero on failure. */
+int omc_prof_hist_write(const OMC_PROF_HIST *hist, const char *filename);
+
+/* Opens filename and reads the header. Returns non-zero on failure. */
+int omc_prof_hist_reader_open(OMC_PROF_HIST_READER *reader, const char *filename);
+/* Reads the next row. Returns non-zero after the last row or on failure. */
+int omc_prof_hist_reader_next(OMC_PROF_HIST_READER *reader, OMC_PROF_HIST_ROW *row);
+void omc_prof_hist_reader_close(OMC_PROF_HIST_READER *reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,490 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+
+/*! \file omc_thread_pool.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include "omc_thread_pool.h"
+#include "rtclock.h"
+#include "omc_file.h"
+#include "../gc/omc_gc.h"
+
+#if !(defined(OMC_MINIMAL_RUNTIME) || defined(OMC_FMI_RUNTIME))
+#define OMC_THREAD_POOL_GC 1
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define OMC_CPU_RELAX() __builtin_ia32_pause()
+#else
+#define OMC_CPU_RELAX()
+#endif
+
+#define OMC_LOAD(X) __atomic_load_n(&(X), __ATOMIC_ACQUIRE)
+#define OMC_STORE(X,V) __atomic_store_n(&(X), (V), __ATOMIC_RELEASE)
+
+/* number of polls of an idle worker before it parks */
+#define OMC_THREAD_POOL_SPIN 100000
+/* number of polls before a waiting thread starts to yield its core, matters
+ * if there are more threads than cores */
+#define OMC_THREAD_POOL_YIELD 1000
+
+typedef enum {
+  OMC_JOB_LEVELS,
+  OMC_JOB_LISTS
+} OMC_JOB_TYPE;
+
+typedef struct OMC_THREAD_POOL_WORKER {
+  OMC_THREAD_POOL *pool;
+  int index;
+  int sense;              /* local sense of the barrier */
+  unsigned long tasks;
+  double busy;
+  char padding[64];       /* keep the counters of the threads on different cache lines */
+} OMC_THREAD_POOL_WORKER;
+
+struct OMC_THREAD_POOL {
+  int n_threads;
+  omc_thread_pool_init init;
+  void *init_arg;
+  pthread_t *threads;
+  OMC_THREAD_POOL_WORKER *workers;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  int generation;         /* incremented for every run */
+  int finished;
+  int pending;            /* workers still busy with the current run */
+  int failed;
+  int barrier_count;
+  int barrier_sense;
+
+  /* current job */
+  OMC_JOB_TYPE type;
+  int n;
+  const int *ptrs;
+  const int *ids;
+  const char *serial;
+  omc_thread_pool_task fn;
+  void *arg;
+
+  int *done;              /* done[k] is the generation of the last run that has run task k */
+  int n_done;
+  double *task_time;      /* accumulated time of each task */
+  int n_task_time;
+
+  unsigned long runs;
+  double wall;
+};
+
+static inline void relax(int *polls)
+{
+  if (++*polls < OMC_THREAD_POOL_YIELD) {
+    OMC_CPU_RELAX();
+  } else {
+    sched_yield();
+  }
+}
+
+static void barrier(OMC_THREAD_POOL *pool, OMC_THREAD_POOL_WORKER *w)
+{
+  w->sense = !w->sense;
+  if (__atomic_add_fetch(&pool->barrier_count, 1, __ATOMIC_ACQ_REL) == pool->n_threads) {
+    pool->barrier_count = 0;
+    OMC_STORE(pool->barrier_sense, w->sense);
+  } else {
+    int polls = 0;
+    while (OMC_LOAD(pool->barrier_sense) != w->sense) {
+      relax(&polls);
+    }
+  }
+}
+
+static void runTask(OMC_THREAD_POOL *pool, OMC_THREAD_POOL_WORKER *w, int task)
+{
+  rtclock_t tick;
+  double t;
+  if (OMC_LOAD(pool->failed)) {
+    return;
+  }
+  rt_ext_tp_tick_realtime(&tick);
+  if (pool->fn(pool->arg, w->index, task)) {
+    OMC_STORE(pool->failed, 1);
+  }
+  t = rt_ext_tp_tock_realtime(&tick);
+  w->busy += t;
+  w->tasks++;
+  /* every task is run by exactly one thread per run */
+  if (task < pool->n_task_time) {
+    pool->task_time[task] += t;
+  }
+}
+
+static void runJob(OMC_THREAD_POOL *pool, OMC_THREAD_POOL_WORKER *w, int generation)
+{
+  int t = w->index, n = pool->n_threads, l, k, op, polls;
+
+  if (pool->type == OMC_JOB_LEVELS) {
+    for (l = 0; l < pool->n; l++) {
+      if (pool->serial && pool->serial[l]) {
+        if (t == 0) {
+          for (k = pool->ptrs[l]; k < pool->ptrs[l+1]; k++) {
+            runTask(pool, w, pool->ids[k]);
+          }
+        }
+      } else {
+        for (k = pool->ptrs[l] + t; k < pool->ptrs[l+1]; k += n) {
+          runTask(pool, w, pool->ids[k]);
+        }
+      }
+      if (l < pool->n - 1) {
+        barrier(pool, w);
+      }
+    }
+  } else if (t < pool->n) {
+    for (k = pool->ptrs[t]; k < pool->ptrs[t+1]; k++) {
+      op = pool->ids[k];
+      if (op >= 0) {
+        runTask(pool, w, op);
+        /* publishes the results of the task, also if it is skipped after a failure */
+        OMC_STORE(pool->done[op], generation);
+      } else {
+        polls = 0;
+        while (OMC_LOAD(pool->done[-op-1]) != generation) {
+          relax(&polls);
+        }
+      }
+    }
+  }
+}
+
+static void* workerMain(void *in)
+{
+  OMC_THREAD_POOL_WORKER *w = (OMC_THREAD_POOL_WORKER*) in;
+  OMC_THREAD_POOL *pool = w->pool;
+  int generation = 0, polls;
+#if defined(OMC_THREAD_POOL_GC)
+  struct GC_stack_base sb;
+
+  /* the tasks allocate from the garbage collected heap */
+  if (!GC_thread_is_registered()) {
+    memset(&sb, 0, sizeof(sb));
+    GC_get_stack_base(&sb);
+    GC_register_my_thread(&sb);
+  }
+#endif
+  if (pool->init) {
+    pool->init(pool->init_arg, w->index);
+  }
+
+  while (1) {
+    for (polls = 0; polls < OMC_THREAD_POOL_SPIN && OMC_LOAD(pool->generation) == generation && !OMC_LOAD(pool->finished); ) {
+      relax(&polls);
+    }
+    if (OMC_LOAD(pool->generation) == generation && !OMC_LOAD(pool->finished)) {
+      pthread_mutex_lock(&pool->mutex);
+      while (pool->generation == generation && !pool->finished) {
+        pthread_cond_wait(&pool->cond, &pool->mutex);
+      }
+      pthread_mutex_unlock(&pool->mutex);
+    }
+    if (OMC_LOAD(pool->finished)) {
+      break;
+    }
+    generation = OMC_LOAD(pool->generation);
+    runJob(pool, w, generation);
+    __atomic_sub_fetch(&pool->pending, 1, __ATOMIC_ACQ_REL);
+  }
+#if defined(OMC_THREAD_POOL_GC)
+  GC_unregister_my_thread();
+#endif
+  return NULL;
+}
+
+OMC_THREAD_POOL* omc_thread_pool_new(int n_threads, omc_thread_pool_init init, void *init_arg)
+{
+  OMC_THREAD_POOL *pool = (OMC_THREAD_POOL*) calloc(1, sizeof(OMC_THREAD_POOL));
+  int i;
+
+  if (!pool) {
+    return NULL;
+  }
+  pool->n_threads = n_threads < 1 ? 1 : n_threads;
+  pool->init = init;
+  pool->init_arg = init_arg;
+  pool->threads = (pthread_t*) calloc(pool->n_threads, sizeof(pthread_t));
+  pool->workers = (OMC_THREAD_POOL_WORKER*) calloc(pool->n_threads, sizeof(OMC_THREAD_POOL_WORKER));
+  if (!pool->threads || !pool->workers) {
+    free(pool->threads);
+    free(pool->workers);
+    free(pool);
+    return NULL;
+  }
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->cond, NULL);
+  for (i = 0; i < pool->n_threads; i++) {
+    pool->workers[i].pool = pool;
+    pool->workers[i].index = i;
+  }
+#if defined(OMC_THREAD_POOL_GC)
+  if (pool->n_threads > 1) {
+    GC_allow_register_threads();
+  }
+#endif
+  for (i = 1; i < pool->n_threads; i++) {
+    if (pthread_create(&pool->threads[i], NULL, workerMain, &pool->workers[i])) {
+      /* run with the threads we got */
+      pool->n_threads = i;
+      break;
+    }
+  }
+  return pool;
+}
+
+void omc_thread_pool_free(OMC_THREAD_POOL *pool)
+{
+  int i;
+
+  if (!pool) {
+    return;
+  }
+  pthread_mutex_lock(&pool->mutex);
+  OMC_STORE(pool->finished, 1);
+  pthread_cond_broadcast(&pool->cond);
+  pthread_mutex_unlock(&pool->mutex);
+  for (i = 1; i < pool->n_threads; i++) {
+    pthread_join(pool->threads[i], NULL);
+  }
+  pthread_mutex_destroy(&pool->mutex);
+  pthread_cond_destroy(&pool->cond);
+  free(pool->threads);
+  free(pool->workers);
+  free(pool->done);
+  free(pool->task_time);
+  free(pool);
+}
+
+int omc_thread_pool_size(OMC_THREAD_POOL *pool)
+{
+  return pool->n_threads;
+}
+
+static int run(OMC_THREAD_POOL *pool)
+{
+  rtclock_t tick;
+  int polls = 0, generation = pool->generation + 1;
+
+  rt_ext_tp_tick_realtime(&tick);
+  pool->failed = 0;
+  OMC_STORE(pool->pending, pool->n_threads - 1);
+  pthread_mutex_lock(&pool->mutex);
+  OMC_STORE(pool->generation, generation);
+  pthread_cond_broadcast(&pool->cond);
+  pthread_mutex_unlock(&pool->mutex);
+
+  runJob(pool, &pool->workers[0], generation);
+  while (OMC_LOAD(pool->pending) > 0) {
+    relax(&polls);
+  }
+
+  pool->wall += rt_ext_tp_tock_realtime(&tick);
+  pool->runs++;
+  return pool->failed;
+}
+
+static int reserveTaskTimes(OMC_THREAD_POOL *pool, int n_tasks)
+{
+  double *task_time;
+
+  if (n_tasks > pool->n_task_time) {
+    task_time = (double*) realloc(pool->task_time, n_tasks * sizeof(double));
+    if (!task_time) {
+      return 1;
+    }
+    memset(task_time + pool->n_task_time, 0, (n_tasks - pool->n_task_time) * sizeof(double));
+    pool->task_time = task_time;
+    pool->n_task_time = n_tasks;
+  }
+  return 0;
+}
+
+int omc_thread_pool_run_levels(OMC_THREAD_POOL *pool, int n_levels, const int *level_ptrs,
+                               const int *tasks, const char *serial,
+                               omc_thread_pool_task fn, void *arg)
+{
+  int k, n_tasks = 0;
+
+  if (!pool->n_task_time) {
+    for (k = 0; k < level_ptrs[n_levels]; k++) {
+      if (tasks[k] >= n_tasks) {
+        n_tasks = tasks[k] + 1;
+      }
+    }
+    if (reserveTaskTimes(pool, n_tasks)) {
+      return 1;
+    }
+  }
+  pool->type = OMC_JOB_LEVELS;
+  pool->n = n_levels;
+  pool->ptrs = level_ptrs;
+  pool->ids = tasks;
+  pool->serial = serial;
+  pool->fn = fn;
+  pool->arg = arg;
+  return run(pool);
+}
+
+int omc_thread_pool_run_lists(OMC_THREAD_POOL *pool, int n_lists, const int *thread_ptrs,
+                              const int *ops, int n_tasks,
+                              omc_thread_pool_task fn, void *arg)
+{
+  int *done;
+
+  if (n_lists > pool->n_threads) {
+    /* the schedule was made for more threads than we could create */
+    return 1;
+  }
+  if (n_tasks > pool->n_done) {
+    /* no run has stamped the new tasks yet, all threads are idle */
+    done = (int*) realloc(pool->done, n_tasks * sizeof(int));
+    if (!done || reserveTaskTimes(pool, n_tasks)) {
+      if (done) {
+        pool->done = done;
+      }
+      return 1;
+    }
+    memset(done + pool->n_done, 0, (n_tasks - pool->n_done) * sizeof(int));
+    pool->done = done;
+    pool->n_done = n_tasks;
+  }
+  pool->type = OMC_JOB_LISTS;
+  pool->n = n_lists;
+  pool->ptrs = thread_ptrs;
+  pool->ids = ops;
+  pool->serial = NULL;
+  pool->fn = fn;
+  pool->arg = arg;
+  return run(pool);
+}
+
+/* The parallel time of the last schedule if every task took its average
+ * measured time, ignoring the synchronization. */
+static double predictedParallelTime(OMC_THREAD_POOL *pool)
+{
+  double *thread_time, *finish, level_time, t = 0.0;
+  int *pos, l, k, i, op, progress, remaining;
+  const double runs = pool->runs ? (double) pool->runs : 1.0;
+
+  thread_time = (double*) calloc(pool->n_threads, sizeof(double));
+  if (!thread_time) {
+    return 0.0;
+  }
+  if (pool->type == OMC_JOB_LEVELS) {
+    for (l = 0; l < pool->n; l++) {
+      memset(thread_time, 0, pool->n_threads * sizeof(double));
+      for (k = pool->ptrs[l]; k < pool->ptrs[l+1]; k++) {
+        i = (pool->serial && pool->serial[l]) ? 0 : (k - pool->ptrs[l]) % pool->n_threads;
+        thread_time[i] += pool->task_time[pool->ids[k]] / runs;
+      }
+      level_time = 0.0;
+      for (i = 0; i < pool->n_threads; i++) {
+        level_time = thread_time[i] > level_time ? thread_time[i] : level_time;
+      }
+      t += level_time;
+    }
+  } else {
+    /* replay the task lists, a thread proceeds until it waits for a task that
+     * has not been replayed yet */
+    pos = (int*) calloc(pool->n, sizeof(int));
+    finish = (double*) malloc(pool->n_task_time * sizeof(double));
+    if (!pos || !finish) {
+      free(pos);
+      free(finish);
+      free(thread_time);
+      return 0.0;
+    }
+    for (k = 0; k < pool->n_task_time; k++) {
+      finish[k] = -1.0;
+    }
+    remaining = pool->ptrs[pool->n];
+    do {
+      progress = 0;
+      for (i = 0; i < pool->n; i++) {
+        for (; pool->ptrs[i] + pos[i] < pool->ptrs[i+1]; pos[i]++) {
+          op = pool->ids[pool->ptrs[i] + pos[i]];
+          if (op >= 0) {
+            thread_time[i] += pool->task_time[op] / runs;
+            finish[op] = thread_time[i];
+          } else if (finish[-op-1] < 0.0) {
+            break;
+          } else if (finish[-op-1] > thread_time[i]) {
+            thread_time[i] = finish[-op-1];
+          }
+          progress = 1;
+          remaining--;
+        }
+      }
+    } while (progress && remaining > 0);
+    for (i = 0; i < pool->n; i++) {
+      t = thread_time[i] > t ? thread_time[i] : t;
+    }
+    free(pos);
+    free(finish);
+  }
+  free(thread_time);
+  return t;
+}
+
+int omc_thread_pool_write_timings(OMC_THREAD_POOL *pool, const char *filename)
+{
+  FILE *fout = omc_fopen(filename, "w");
+  int i;
+  double busy = 0.0, predicted;
+
+  if (!fout) {
+    return 1;
+  }
+  fprintf(fout, "\"thread\",\"tasks\",\"busy time [s]\"\n");
+  for (i = 0; i < pool->n_threads; i++) {
+    fprintf(fout, "%d,%lu,%.9g\n", i, pool->workers[i].tasks, pool->workers[i].busy);
+    busy += pool->workers[i].busy;
+  }
+  fprintf(fout, "\"runs\",%lu\n", pool->runs);
+  fprintf(fout, "\"wall time [s]\",%.9g\n", pool->wall);
+  fprintf(fout, "\"measured speedup\",%.4g\n", pool->wall > 0.0 ? busy / pool->wall : 0.0);
+  predicted = pool->runs ? predictedParallelTime(pool) : 0.0;
+  fprintf(fout, "\"predicted speedup\",%.4g\n", predicted > 0.0 ? busy / pool->runs / predicted : 0.0);
+  return fclose(fout) != 0;
+}
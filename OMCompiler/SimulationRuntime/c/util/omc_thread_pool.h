@@ -0,0 +1,95 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+
+/*! \file omc_thread_pool.h
+ *
+ * Persistent thread pool for the parallel evaluation of HpcOm schedules
+ * (-d=hpcom --hpcomCode=pool) without OpenMP.
+ *
+ * The worker threads are created once and stay alive between the calls.
+ * Between two runs they spin for a while and then park on a condition
+ * variable, so that back-to-back evaluations of functionODE do not pay for a
+ * wake-up while a paused simulation does not burn the cores.
+ *
+ * Tasks are numbered by the caller and executed through a callback that
+ * returns non-zero on failure. After a failure the remaining tasks of the run
+ * are skipped and the run returns non-zero.
+ */
+
+#ifndef OMC_THREAD_POOL_H
+#define OMC_THREAD_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct OMC_THREAD_POOL OMC_THREAD_POOL;
+
+/* Runs task number task on pool thread thread; returns non-zero on failure. */
+typedef int (*omc_thread_pool_task)(void *arg, int thread, int task);
+/* Sets up pool thread thread, called once on the thread before its first task. */
+typedef void (*omc_thread_pool_init)(void *arg, int thread);
+
+/* Creates a pool of n_threads threads, the calling thread being thread 0.
+ * If init is not NULL, every other thread calls init(init_arg, thread) when
+ * it starts. */
+OMC_THREAD_POOL* omc_thread_pool_new(int n_threads, omc_thread_pool_init init, void *init_arg);
+void omc_thread_pool_free(OMC_THREAD_POOL *pool);
+int omc_thread_pool_size(OMC_THREAD_POOL *pool);
+
+/* Level schedule: the tasks tasks[level_ptrs[l]..level_ptrs[l+1]-1] of level l
+ * are distributed round-robin over the threads, all threads meet at a barrier
+ * before the next level. If serial is not NULL and serial[l] is set, thread 0
+ * runs all tasks of level l in the given order. */
+int omc_thread_pool_run_levels(OMC_THREAD_POOL *pool, int n_levels, const int *level_ptrs,
+                               const int *tasks, const char *serial,
+                               omc_thread_pool_task fn, void *arg);
+
+/* Thread schedule: thread t executes ops[thread_ptrs[t]..thread_ptrs[t+1]-1]
+ * in order, for t < n_lists. An op k >= 0 runs task k, an op k < 0 waits
+ * until task -k-1 has been run in this call. Task numbers must be smaller
+ * than n_tasks. */
+int omc_thread_pool_run_lists(OMC_THREAD_POOL *pool, int n_lists, const int *thread_ptrs,
+                              const int *ops, int n_tasks,
+                              omc_thread_pool_task fn, void *arg);
+
+/* Writes the number of tasks and the busy time of each thread and the wall
+ * time of all runs as csv. sum(busy)/wall is the measured speedup, the
+ * predicted speedup is the one of the schedule with the measured average
+ * task times and no synchronization overhead.
+ * Returns non-zero if the file could not be written. */
+int omc_thread_pool_write_timings(OMC_THREAD_POOL *pool, const char *filename);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
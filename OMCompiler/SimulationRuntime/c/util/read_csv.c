@@ -37,6 +37,11 @@
 #include "omc_file.h"
 #include "omc_numbers.h"
 
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#include <emmintrin.h>
+#define CSV_STREAM_SSE2 1
+#endif
+
 struct cell_row_count
 {
   int cell_count;
@@ -322,6 +327,9 @@ double* read_csv_dataset(struct csv_data *data, const char *var)
 void omc_free_csv_reader(struct csv_data *data)
 {
   int i;
+  if (!data) {
+    return;
+  }
   for (i=0; i<data->numvars; i++) {
     free(data->variables[i]);
   }
@@ -331,3 +339,372 @@ void omc_free_csv_reader(struct csv_data *data)
   data->data = 0;
   free(data);
 }
+
+/* Streaming reader with column projection */
+
+#define CSV_STREAM_BLOCK_SIZE (1<<20)
+
+/* Returns the first delimiter or line feed in [p,end) or end */
+static inline const char* csv_stream_find_sep(const char *p, const char *end, char delim)
+{
+#if defined(CSV_STREAM_SSE2)
+  const __m128i vdelim = _mm_set1_epi8(delim);
+  const __m128i vnl = _mm_set1_epi8('\n');
+  while (p + 16 <= end) {
+    __m128i v = _mm_loadu_si128((const __m128i*) p);
+    int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, vdelim), _mm_cmpeq_epi8(v, vnl)));
+    if (mask) {
+      return p + __builtin_ctz(mask);
+    }
+    p += 16;
+  }
+#endif
+  while (p < end && *p != delim && *p != '\n') {
+    p++;
+  }
+  return p;
+}
+
+static const double csv_stream_pow10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Parses the field [p,end) as a double.
+ * Decimal numbers whose mantissa fits in 53 bits and whose exponent is at most
+ * 22 are exact products of two doubles and are converted directly; everything
+ * else (long mantissas, inf, nan, ...) is passed on to om_strtod.
+ * Returns 0 on success.
+ */
+static int csv_stream_parse_double(char *p, char *end, double *res)
+{
+  const char *s = p;
+  unsigned long long mantissa = 0;
+  int ndigits = 0, exp10 = 0, negative = 0, anydigit = 0;
+  char *endptr, saved;
+
+  while (end > p && (end[-1] == '\r' || end[-1] == ' ')) {
+    end--;
+  }
+  if (p == end) {
+    *res = 0.0;
+    return 0;
+  }
+  if (*s == '-' || *s == '+') {
+    negative = *s == '-';
+    s++;
+  }
+  while (s < end && *s >= '0' && *s <= '9') {
+    if (ndigits < 19) {
+      mantissa = 10*mantissa + (*s - '0');
+      if (mantissa) ndigits++;
+    } else {
+      ndigits++;
+      exp10++;
+    }
+    anydigit = 1;
+    s++;
+  }
+  if (s < end && *s == '.') {
+    s++;
+    while (s < end && *s >= '0' && *s <= '9') {
+      if (ndigits < 19) {
+        mantissa = 10*mantissa + (*s - '0');
+        if (mantissa) ndigits++;
+        exp10--;
+      } else {
+        ndigits++;
+      }
+      anydigit = 1;
+      s++;
+    }
+  }
+  if (s < end && (*s == 'e' || *s == 'E')) {
+    int e = 0, eneg = 0;
+    s++;
+    if (s < end && (*s == '-' || *s == '+')) {
+      eneg = *s == '-';
+      s++;
+    }
+    while (s < end && *s >= '0' && *s <= '9') {
+      if (e < 100000) e = 10*e + (*s - '0');
+      s++;
+    }
+    exp10 += eneg ? -e : e;
+  }
+  if (s == end && anydigit && ndigits <= 19 && mantissa < (1ULL << 53) && exp10 >= -22 && exp10 <= 22 && s[-1] >= '0' && s[-1] <= '9') {
+    double d = (double) mantissa;
+    d = exp10 < 0 ? d / csv_stream_pow10[-exp10] : d * csv_stream_pow10[exp10];
+    *res = negative ? -d : d;
+    return 0;
+  }
+  /* slow path */
+  saved = *end;
+  *end = '\0';
+  *res = om_strtod(p, &endptr);
+  *end = saved;
+  if (endptr != end) {
+    saved = *end;
+    *end = '\0';
+    fprintf(stderr,"Found non-double data in csv result-file: %s\n", p);
+    *end = saved;
+    return 1;
+  }
+  return 0;
+}
+
+static void csv_stream_grow(struct csv_stream *stream)
+{
+  int i;
+  stream->capacity = stream->capacity ? 2*stream->capacity : 1024;
+  for (i=0; i<stream->numcols; i++) {
+    if (stream->colindex[i] >= 0 && stream->slot[stream->colindex[i]] == i) {
+      stream->cols[i] = (double*) realloc(stream->cols[i], sizeof(double)*stream->capacity);
+    }
+  }
+}
+
+/* Parses all complete rows in buf[0..len). Returns the number of consumed bytes. */
+static size_t csv_stream_parse_rows(struct csv_stream *stream, char *buf, size_t len, int finish)
+{
+  char *p = buf, *end = buf + len, *row = buf;
+  const char delim = (char) stream->delim;
+  int field = 0;
+  while (p < end || (finish && row < end)) {
+    char *sep = (char*) csv_stream_find_sep(p, end, delim);
+    int eol = sep == end || *sep == '\n';
+    if (sep == end && !finish) {
+      /* incomplete row; keep it for the next block */
+      return row - buf;
+    }
+    if (field == 0 && eol && (sep == p || (sep == p+1 && *p == '\r'))) {
+      /* empty line */
+      p = row = sep + (sep < end);
+      if (sep == end) break;
+      continue;
+    }
+    if (field < stream->numvars && stream->slot[field] >= 0) {
+      char *fieldBegin = p, *fieldEnd = sep;
+      if (*fieldBegin == '"' && fieldEnd > fieldBegin) {
+        char *quote = memchr(fieldBegin+1, '"', end-fieldBegin-1);
+        if (quote) {
+          /* quoted field; the delimiter might be inside the quotes */
+          sep = (char*) csv_stream_find_sep(quote+1, end, delim);
+          eol = sep == end || *sep == '\n';
+          fieldBegin++;
+          fieldEnd = quote;
+        }
+      }
+      if (stream->numsteps >= stream->capacity) {
+        csv_stream_grow(stream);
+      }
+      if (csv_stream_parse_double(fieldBegin, fieldEnd, &stream->cols[stream->slot[field]][stream->numsteps])) {
+        stream->error = 1;
+        return row - buf;
+      }
+    }
+    field++;
+    if (eol) {
+      if (field != stream->numvars) {
+        fprintf(stderr,"Did not find time points for all variables for row: %d\n", stream->numsteps+1);
+        stream->error = 1;
+        return row - buf;
+      }
+      stream->numsteps++;
+      field = 0;
+      row = sep + (sep < end);
+    }
+    p = sep + 1;
+    if (sep == end) break;
+  }
+  return row - buf;
+}
+
+/* Opens the file and reads its header. Use read_csv_stream_select to choose columns. */
+struct csv_stream* read_csv_stream_open(const char *filename)
+{
+  char buf[8] = {0};
+  unsigned char delim = CSV_COMMA;
+  long offset = 0;
+  struct csv_stream *stream;
+  struct csv_head head = {0};
+  struct csv_parser p;
+  char *line = NULL;
+  size_t linelen = 0, linesize = 0;
+  int c;
+  FILE *fin = omc_fopen(filename, "rb");
+  if (!fin) {
+    return NULL;
+  }
+
+  /* determine delim */
+  if (5 == omc_fread(buf, 1, 5, fin, 1) && 0 == strncmp(buf, "\"sep=", 5)) {
+    omc_fread(&delim, 1, 1, fin, 0);
+    offset = 8;
+  }
+  fseek(fin, offset, SEEK_SET);
+
+  /* the header is one line; let libcsv handle the quoting */
+  while ((c = fgetc(fin)) != EOF && c != '\n') {
+    if (linelen + 1 >= linesize) {
+      linesize = linesize ? 2*linesize : 4096;
+      line = (char*) realloc(line, linesize);
+    }
+    line[linelen++] = (char) c;
+  }
+  if (c == EOF) {
+    free(line);
+    fclose(fin);
+    return NULL;
+  }
+  csv_init(&p, CSV_STRICT | CSV_REPALL_NL | CSV_STRICT_FINI | CSV_APPEND_NULL | CSV_EMPTY_IS_NULL, delim);
+  csv_set_realloc_func(&p, realloc);
+  csv_set_free_func(&p, free);
+  csv_parse(&p, line ? line : "", linelen, add_variable, found_first_row, &head);
+  csv_fini(&p, add_variable, found_first_row, &head);
+  csv_free(&p);
+  free(line);
+  if (head.size == 0) {
+    free(head.variables);
+    fclose(fin);
+    return NULL;
+  }
+
+  stream = (struct csv_stream*) calloc(1, sizeof(struct csv_stream));
+  stream->fin = fin;
+  stream->delim = delim;
+  stream->variables = head.variables;
+  stream->numvars = head.size;
+  stream->slot = (int*) malloc(sizeof(int)*stream->numvars);
+  for (c=0; c<stream->numvars; c++) {
+    stream->slot[c] = -1;
+  }
+  return stream;
+}
+
+/* Selects the columns to keep. Must be called before the first read.
+ * Returns the number of selected columns found in the file.
+ */
+int read_csv_stream_select(struct csv_stream *stream, const char * const *columns, int ncolumns)
+{
+  int i, j, found = 0;
+  stream->numcols = ncolumns;
+  stream->colindex = (int*) malloc(sizeof(int)*(ncolumns ? ncolumns : 1));
+  stream->cols = (double**) calloc(ncolumns ? ncolumns : 1, sizeof(double*));
+  for (i=0; i<ncolumns; i++) {
+    stream->colindex[i] = -1;
+    for (j=0; j<stream->numvars; j++) {
+      if (0 == strcmp(stream->variables[j], columns[i])) {
+        stream->colindex[i] = j;
+        if (stream->slot[j] == -1) {
+          stream->slot[j] = i;
+          found++;
+        }
+        break;
+      }
+    }
+  }
+  return found;
+}
+
+/* Reads the rows that are available in the file.
+ * An incomplete last row is kept until more data arrives, unless finish is set.
+ * Returns the number of new rows or -1 on error.
+ */
+int read_csv_stream_read(struct csv_stream *stream, int finish)
+{
+  int oldsteps = stream->numsteps, i;
+  size_t len, consumed;
+  if (stream->error) {
+    return -1;
+  }
+  if (!stream->colindex) {
+    read_csv_stream_select(stream, NULL, 0);
+  }
+  do {
+    if (stream->buflen + CSV_STREAM_BLOCK_SIZE > stream->bufsize) {
+      stream->bufsize = stream->buflen + CSV_STREAM_BLOCK_SIZE;
+      stream->buf = (char*) realloc(stream->buf, stream->bufsize + 1);
+    }
+    len = fread(stream->buf + stream->buflen, 1, CSV_STREAM_BLOCK_SIZE, stream->fin);
+    stream->buflen += len;
+    consumed = csv_stream_parse_rows(stream, stream->buf, stream->buflen, finish && len == 0);
+    if (stream->error) {
+      return -1;
+    }
+    memmove(stream->buf, stream->buf + consumed, stream->buflen - consumed);
+    stream->buflen -= consumed;
+  } while (len > 0);
+  /* allow reading rows that are appended later */
+  clearerr(stream->fin);
+  /* columns that are not in the file are NULL, the other ones are never NULL */
+  for (i=0; i<stream->numcols; i++) {
+    if (stream->colindex[i] >= 0 && stream->slot[stream->colindex[i]] == i && !stream->cols[i]) {
+      stream->cols[i] = (double*) malloc(sizeof(double));
+    }
+  }
+  return stream->numsteps - oldsteps;
+}
+
+/* Returns the data of the i-th selected column or NULL if the column is not in the file */
+double* read_csv_stream_column(struct csv_stream *stream, int column)
+{
+  if (column < 0 || column >= stream->numcols || stream->colindex[column] < 0) {
+    return NULL;
+  }
+  /* the same column might have been selected several times */
+  return stream->cols[stream->slot[stream->colindex[column]]];
+}
+
+void read_csv_stream_close(struct csv_stream *stream)
+{
+  int i;
+  if (stream->fin) {
+    fclose(stream->fin);
+  }
+  for (i=0; i<stream->numvars; i++) {
+    free(stream->variables[i]);
+  }
+  free(stream->variables);
+  for (i=0; i<stream->numcols; i++) {
+    free(stream->cols[i]);
+  }
+  free(stream->cols);
+  free(stream->colindex);
+  free(stream->slot);
+  free(stream->buf);
+  free(stream);
+}
+
+/* Like read_csv, but only reads the given columns.
+ * Columns that are not in the file are left out, i.e. read_csv_dataset returns NULL for them.
+ */
+struct csv_data* read_csv_columns(const char *filename, const char * const *columns, int ncolumns)
+{
+  struct csv_data *res;
+  int i, n = 0;
+  struct csv_stream *stream = read_csv_stream_open(filename);
+  if (!stream) {
+    return NULL;
+  }
+  read_csv_stream_select(stream, columns, ncolumns);
+  if (read_csv_stream_read(stream, 1) < 0) {
+    read_csv_stream_close(stream);
+    return NULL;
+  }
+  res = (struct csv_data*) malloc(sizeof(struct csv_data));
+  res->variables = (char**) malloc(sizeof(char*)*(ncolumns ? ncolumns : 1));
+  res->data = (double*) malloc(sizeof(double)*((size_t)ncolumns*stream->numsteps + 1));
+  res->numsteps = stream->numsteps;
+  for (i=0; i<ncolumns; i++) {
+    double *col = read_csv_stream_column(stream, i);
+    if (col) {
+      res->variables[n] = strdup(columns[i]);
+      memcpy(res->data + (size_t)n*res->numsteps, col, sizeof(double)*res->numsteps);
+      n++;
+    }
+  }
+  res->numvars = n;
+  read_csv_stream_close(stream);
+  return res;
+}
@@ -31,6 +31,8 @@
 #ifndef OMC_READ_CSV_H
 #define OMC_READ_CSV_H
 
+#include <stdio.h>
+
 struct csv_data {
   char **variables;
   double *data;
@@ -38,6 +40,28 @@ struct csv_data {
   int numsteps;
 };
 
+/* Incremental reader that only keeps the selected columns (projection).
+ * The header is parsed by read_csv_stream_open. Rows are read in large
+ * blocks by read_csv_stream_read, which can be called again to pick up rows
+ * appended to a file that is still being written.
+ */
+struct csv_stream {
+  FILE *fin;
+  unsigned char delim;
+  char **variables;   /* all column names of the file */
+  int numvars;
+  int numcols;        /* number of selected columns */
+  int *colindex;      /* file column of each selected column; -1 if not in the file */
+  int *slot;          /* selected column of each file column; -1 if not selected */
+  double **cols;      /* data of the selected columns, cols[i][0..numsteps-1] */
+  int numsteps;
+  int capacity;
+  char *buf;          /* bytes read from the file but not yet parsed, i.e. an incomplete row */
+  size_t buflen;
+  size_t bufsize;
+  int error;
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -50,6 +74,13 @@ struct csv_data* read_csv(const char *filename);
 double* read_csv_dataset(struct csv_data *data, const char *var);
 void omc_free_csv_reader(struct csv_data *data);
 
+struct csv_stream* read_csv_stream_open(const char *filename);
+int read_csv_stream_select(struct csv_stream *stream, const char * const *columns, int ncolumns);
+int read_csv_stream_read(struct csv_stream *stream, int finish);
+double* read_csv_stream_column(struct csv_stream *stream, int column);
+void read_csv_stream_close(struct csv_stream *stream);
+struct csv_data* read_csv_columns(const char *filename, const char * const *columns, int ncolumns);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -635,8 +635,12 @@ static inline double rt_ext_tp_tock_common(clockid_t clk_id, rtclock_t* tick_tp)
   return d - min_time;
 }
 
+/* unlike rt_ext_tp_tock this does not update min_time, so it can be used
+ * from several threads like the Windows and OSX versions */
 double rt_ext_tp_tock_realtime(rtclock_t* tick_tp) {
-  return rt_ext_tp_tock_common(CLOCK_MONOTONIC, tick_tp);
+  struct timespec tock_tp = {0,0};
+  clock_gettime(CLOCK_MONOTONIC, &tock_tp);
+  return (tock_tp.tv_sec - tick_tp->time.tv_sec) + (tock_tp.tv_nsec - tick_tp->time.tv_nsec)*1e-9;
 }
 
 double rt_ext_tp_tock(rtclock_t* tick_tp) {
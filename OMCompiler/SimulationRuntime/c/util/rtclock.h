@@ -139,6 +139,8 @@ void rt_measure_overhead(int ix);
 void rt_ext_tp_tick(rtclock_t* tick_tp);
 void rt_ext_tp_tick_realtime(rtclock_t* tick_tp);
 double rt_ext_tp_tock(rtclock_t* tick_tp);
+/* tock for rt_ext_tp_tick_realtime; keeps no global state and is thread-safe */
+double rt_ext_tp_tock_realtime(rtclock_t* tick_tp);
 /* sleep nsec nanoseconds since the call to tick_tp. Returns the number of nanoseconds we are late for the deadline. */
 int64_t rt_ext_tp_sync_nanosec(rtclock_t* tick_tp, uint64_t nsec);
 
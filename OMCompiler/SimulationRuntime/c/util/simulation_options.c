@@ -81,6 +81,7 @@ const char *FLAG_NAME[FLAG_MAX+1] = {
   /* FLAG_ILS */                          "ils",
   /* FLAG_IMPRK_ORDER */                  "impRKOrder",
   /* FLAG_IMPRK_LS */                     "impRKLS",
+  /* FLAG_INIT_CACHE */                   "initCache",
   /* FLAG_INITIAL_STEP_SIZE */            "initialStepSize",
   /* FLAG_INPUT_CSV */                    "csvInput",
   /* FLAG_INPUT_FILE */                   "exInputFile",
@@ -95,6 +96,7 @@ const char *FLAG_NAME[FLAG_MAX+1] = {
   /* FLAG_JACOBIAN_THREADS */             "jacobianThreads",
   /* FLAG_L */                            "l",
   /* FLAG_L_DATA_RECOVERY */              "l_datarec",
+  /* FLAG_L_SPARSE */                     "l_sparse",
   /* FLAG_LOG_FORMAT */                   "logFormat",
   /* FLAG_LS */                           "ls",
   /* FLAG_LS_IPOPT */                     "ls_ipopt",
@@ -107,6 +109,7 @@ const char *FLAG_NAME[FLAG_MAX+1] = {
   /* FLAG_MAX_EVENT_ITERATIONS */         "mei",
   /* FLAG_MAX_ORDER */                    "maxIntegrationOrder",
   /* FLAG_MAX_STEP_SIZE */                "maxStepSize",
+  /* FLAG_MEASURETIMEHISTOGRAM */         "measureTimeHistogram",
   /* FLAG_MEASURETIMEPLOTFORMAT */        "measureTimePlotFormat",
   /* FLAG_NEWTON_FTOL */                  "newtonFTol",
   /* FLAG_NEWTON_MAX_STEP_FACTOR */       "newtonMaxStepFactor",
@@ -137,6 +140,7 @@ const char *FLAG_NAME[FLAG_MAX+1] = {
   /* FLAG_R */                            "r",
   /* FLAG_DATA_RECONCILE  */              "reconcile",
   /* FLAG_DATA_RECONCILE_BOUNDARY */      "reconcileBoundaryConditions",
+  /* FLAG_DATA_RECONCILE_SPARSE */        "reconcileSparse",
   /* FLAG_RT */                           "rt",
   /* FLAG_S */                            "s",
   /* FLAG_SINGLE_PRECISION */             "single",
@@ -201,6 +205,7 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
   /* FLAG_ILS */                          "[int (default 3)] number of lambda steps for homotopy methods",
   /* FLAG_IMPRK_ORDER */                  "[int (default 5)] value specifies the integration order of the implicit Runge-Kutta method. Valid values: 1-6",
   /* FLAG_IMPRK_LS */                     "selects the linear solver of the integration methods: impeuler, trapezoid and imprungekuta",
+  /* FLAG_INIT_CACHE */                   "value specifies a file to cache converged initial solutions, used as start values for similar parameters",
   /* FLAG_INITIAL_STEP_SIZE */            "value specifies an initial step size for supported solver",
   /* FLAG_INPUT_CSV */                    "value specifies an csv-file with inputs for the simulation/optimization of the model",
   /* FLAG_INPUT_FILE */                   "value specifies an external file with inputs for the simulation/optimization of the model",
@@ -212,9 +217,10 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
   /* FLAG_IPOPT_MAX_ITER */               "value specifies the max number of iteration for ipopt",
   /* FLAG_IPOPT_WARM_START */             "value specifies lvl for a warm start in ipopt: 1,2,3,...",
   /* FLAG_JACOBIAN */                     "select the calculation method of the Jacobian used only by ida and dassl solver.",
-  /* FLAG_JACOBIAN_THREADS */             "[int default: 1] value specifies the number of threads for jacobian evaluation in dassl or ida.",
-  /* FLAG_L */                            "value specifies a time where the linearization of the model should be performed",
+  /* FLAG_JACOBIAN_THREADS */             "[int default: 1] value specifies the number of threads for jacobian evaluation in dassl, ida, the sparse linearization or the dynamic optimization.",
+  /* FLAG_L */                            "value specifies a time or a comma separated list of times where the linearization of the model should be performed",
   /* FLAG_L_DATA_RECOVERY */              "emit data recovery matrices with model linearization",
+  /* FLAG_L_SPARSE */                     "write the linearization matrices in sparse MatrixMarket format",
   /* FLAG_LOG_FORMAT */                   "value specifies the log format of the executable. -logFormat=text (default), -logFormat=xml or -logFormat=xmltcp",
   /* FLAG_LS */                           "value specifies the linear solver method (default: lapack, totalpivot (fallback))",
   /* FLAG_LS_IPOPT */                     "value specifies the linear solver method for ipopt",
@@ -227,6 +233,7 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
   /* FLAG_MAX_EVENT_ITERATIONS */         "[int (default 20)] value specifies the maximum number of event iterations",
   /* FLAG_MAX_ORDER */                    "value specifies maximum integration order for supported solver",
   /* FLAG_MAX_STEP_SIZE */                "value specifies maximum absolute step size for supported solver",
+  /* FLAG_MEASURETIMEHISTOGRAM */         "[int] aggregates the time measurements of every n-th step into histograms instead of writing them per step",
   /* FLAG_MEASURETIMEPLOTFORMAT */        "value specifies the output format of the measure time functionality",
   /* FLAG_NEWTON_FTOL */                  "[double (default 1e-12)] tolerance respecting residuals for updating solution vector in Newton solver",
   /* FLAG_NEWTON_MAX_STEP_FACTOR */       "[double (default 1e12)] maximum newton step factor mxnewtstep = maxStepFactor * norm2(xScaling). Used currently only by KINSOL.",
@@ -257,6 +264,7 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
   /* FLAG_R */                            "value specifies a new result file than the default Model_res.mat",
   /* FLAG_DATA_RECONCILE */               "Run the Data Reconciliation numerical computation algorithm for constrained equations",
   /* FLAG_DATA_RECONCILE_BOUNDARY */      "Run the Data Reconciliation numerical computation algorithm for boundary condition equations",
+  /* FLAG_DATA_RECONCILE_SPARSE */        "Run the Data Reconciliation numerical computation algorithm with sparse matrices",
   /* FLAG_RT */                           "value specifies the scaling factor for real-time synchronization (0 disables)",
   /* FLAG_S */                            "value specifies the integration method",
   /* FLAG_SINGLE */                       "output in single precision",
@@ -394,6 +402,12 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  Selects the linear solver of the integration methods impeuler, trapezoid and imprungekuta:\n\n"
   "  * iterativ - default, sparse iterativ linear solver with fallback case to dense solver\n"
   "  * dense - dense linear solver, SUNDIALS default method",
+  /* FLAG_INIT_CACHE */
+  "  Value specifies a file to cache the converged iteration variables of the non-linear systems\n"
+  "  after the initialization together with the parameter values of the run.\n"
+  "  The next run with the same file uses the entry with the nearest parameter values\n"
+  "  as start values for the non-linear systems. If the initialization does not converge\n"
+  "  with these start values it is repeated with the start values of the model.",
   /* FLAG_INITIAL_STEP_SIZE */
   "  Value specifies an initial step size, used by the methods: dassl, ida",
   /* FLAG_INPUT_CSV */
@@ -417,12 +431,21 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   /* FLAG_JACOBIAN */
   "  Select the calculation method for Jacobian used by the integration method:\n",
   /* FLAG_JACOBIAN_THREADS */
-  "  Value specifies the number of threads for jacobian evaluation in dassl or ida."
+  "  Value specifies the number of threads for jacobian evaluation in dassl, ida or the sparse linearization (-l_sparse).\n"
+  "  The dynamic optimization (-s=optimization) uses them to evaluate the model, the jacobians and the hessian\n"
+  "  at the collocation points in parallel."
   "  The value is an Integer with default value 1.",
   /* FLAG_L */
-  "  Value specifies a time where the linearization of the model should be performed.",
+  "  Value specifies a time where the linearization of the model should be performed.\n"
+  "  A comma separated list of increasing times, e.g. -l=1,2.5,10, linearizes the model\n"
+  "  at each of them in one simulation run. The files are then numbered in the order of the times.",
   /* FLAG_L_DATA_RECOVERY */
   "  Emit data recovery matrices with model linearization.",
+  /* FLAG_L_SPARSE */
+  "  Write the linearization matrices A, B, C, D in MatrixMarket coordinate format,\n"
+  "  i.e. linearized_model_A.mtx, ..., together with the operating point in linearized_model_x0.mtx\n"
+  "  and linearized_model_u0.mtx, instead of a dense model in the --linearizationDumpLanguage.\n"
+  "  Symbolic Jacobians are evaluated using the coloring of their sparsity pattern.",
   /* FLAG_LOG_FORMAT */
   "  Value specifies the log format of the executable:\n\n"
   "  * text (default)\n"
@@ -458,6 +481,13 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  Value specifies maximum integration order, used by the methods: dassl, ida.",
   /* FLAG_MAX_STEP_SIZE */
   "  Value specifies maximum absolute step size, used by the methods: dassl, ida.",
+  /* FLAG_MEASURETIMEHISTOGRAM */
+  "  Value specifies that the time measurements of the profiled functions and equations\n"
+  "  are aggregated instead of written for every step to model_prof.intdata and model_prof.realdata.\n"
+  "  The time spent per step in each function or equation is counted in a histogram with\n"
+  "  power-of-two buckets from 1 ns on, sampling every n-th step (1 for all steps).\n"
+  "  The histograms are written to model_prof.hist and added to model_prof.json.\n"
+  "  The size of the files does not grow with the number of steps. No plots are generated.",
   /* FLAG_MEASURETIMEPLOTFORMAT */
   "  Value specifies the output format of the measure time functionality:\n\n"
   "  * svg\n"
@@ -545,6 +575,11 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  Run the Data Reconciliation numerical computation algorithm for constrained equations",
   /* FLAG_DATA_RECONCILE_BOUNDARY */
   "  Run the Data Reconciliation numerical computation algorithm for boundary condition equations",
+  /* FLAG_DATA_RECONCILE_SPARSE */
+  "  Run the Data Reconciliation numerical computation algorithm for constrained equations (-reconcile)\n"
+  "  with sparse matrices. The Jacobian F is evaluated with the colored sparsity pattern,\n"
+  "  the covariance matrix Sx is stored sparse and F*Sx*Ft is factorized with KLU.\n"
+  "  Use it for large measurement sets. Timing and memory usage are added to the html report.",
   /* FLAG_RT */
   "  Value specifies the scaling factor for real-time synchronization (0 disables).\n"
   "  A value > 1 means the simulation takes a longer time to simulate.\n",
@@ -619,6 +654,7 @@ const flag_repeat_policy FLAG_REPEAT_POLICIES[FLAG_MAX] = {
   /* FLAG_ILS */                          FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_IMPRK_ORDER */                  FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_IMPRK_LS */                     FLAG_REPEAT_POLICY_FORBID,
+  /* FLAG_INIT_CACHE */                   FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_INITIAL_STEP_SIZE */            FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_INPUT_CSV */                    FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_INPUT_FILE */                   FLAG_REPEAT_POLICY_FORBID,
@@ -633,6 +669,7 @@ const flag_repeat_policy FLAG_REPEAT_POLICIES[FLAG_MAX] = {
   /* FLAG_JACOBIAN_THREADS */             FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_L */                            FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_L_DATA_RECOVERY */              FLAG_REPEAT_POLICY_FORBID,
+  /* FLAG_L_SPARSE */                     FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_LOG_FORMAT */                   FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_LS */                           FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_LS_IPOPT */                     FLAG_REPEAT_POLICY_FORBID,
@@ -645,6 +682,7 @@ const flag_repeat_policy FLAG_REPEAT_POLICIES[FLAG_MAX] = {
   /* FLAG_MAX_EVENT_ITERATIONS */         FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_MAX_ORDER */                    FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_MAX_STEP_SIZE */                FLAG_REPEAT_POLICY_FORBID,
+  /* FLAG_MEASURETIMEHISTOGRAM */         FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_MEASURETIMEPLOTFORMAT */        FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_NEWTON_FTOL */                  FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_NEWTON_MAX_STEP_FACTOR */       FLAG_REPEAT_POLICY_FORBID,
@@ -675,6 +713,7 @@ const flag_repeat_policy FLAG_REPEAT_POLICIES[FLAG_MAX] = {
   /* FLAG_R */                            FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_DATA_RECONCILE  */              FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_DATA_RECONCILE_BOUNDARY */      FLAG_REPEAT_POLICY_FORBID,
+  /* FLAG_DATA_RECONCILE_SPARSE */        FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_RT */                           FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_S */                            FLAG_REPEAT_POLICY_FORBID,
   /* FLAG_SINGLE_PRECISION */             FLAG_REPEAT_POLICY_FORBID,
@@ -738,6 +777,7 @@ const int FLAG_TYPE[FLAG_MAX] = {
   /* FLAG_ILS */                          FLAG_TYPE_OPTION,
   /* FLAG_IMPRK_LS */                     FLAG_TYPE_OPTION,
   /* FLAG_IMPRK_ORDER */                  FLAG_TYPE_OPTION,
+  /* FLAG_INIT_CACHE */                   FLAG_TYPE_OPTION,
   /* FLAG_INITIAL_STEP_SIZE */            FLAG_TYPE_OPTION,
   /* FLAG_INPUT_CSV */                    FLAG_TYPE_OPTION,
   /* FLAG_INPUT_FILE */                   FLAG_TYPE_OPTION,
@@ -752,6 +792,7 @@ const int FLAG_TYPE[FLAG_MAX] = {
   /* FLAG_JACOBIAN_THREADS */             FLAG_TYPE_OPTION,
   /* FLAG_L */                            FLAG_TYPE_OPTION,
   /* FLAG_L_DATA_RECOVERY */              FLAG_TYPE_FLAG,
+  /* FLAG_L_SPARSE */                     FLAG_TYPE_FLAG,
   /* FLAG_LOG_FORMAT */                   FLAG_TYPE_OPTION,
   /* FLAG_LS */                           FLAG_TYPE_OPTION,
   /* FLAG_LS_IPOPT */                     FLAG_TYPE_OPTION,
@@ -764,6 +805,7 @@ const int FLAG_TYPE[FLAG_MAX] = {
   /* FLAG_MAX_EVENT_ITERATIONS */         FLAG_TYPE_OPTION,
   /* FLAG_MAX_ORDER */                    FLAG_TYPE_OPTION,
   /* FLAG_MAX_STEP_SIZE */                FLAG_TYPE_OPTION,
+  /* FLAG_MEASURETIMEHISTOGRAM */         FLAG_TYPE_OPTION,
   /* FLAG_MEASURETIMEPLOTFORMAT */        FLAG_TYPE_OPTION,
   /* FLAG_NEWTON_FTOL */                  FLAG_TYPE_OPTION,
   /* FLAG_NEWTON_MAX_STEP_FACTOR */       FLAG_TYPE_OPTION,
@@ -794,6 +836,7 @@ const int FLAG_TYPE[FLAG_MAX] = {
   /* FLAG_R */                            FLAG_TYPE_OPTION,
   /* FLAG_DATA_RECONCILE */               FLAG_TYPE_FLAG,
   /* FLAG_DATA_RECONCILE_BOUNDARY */      FLAG_TYPE_FLAG,
+  /* FLAG_DATA_RECONCILE_SPARSE */        FLAG_TYPE_FLAG,
   /* FLAG_RT */                           FLAG_TYPE_OPTION,
   /* FLAG_S */                            FLAG_TYPE_OPTION,
   /* FLAG_SINGLE */                       FLAG_TYPE_FLAG,
@@ -1019,7 +1062,7 @@ const char *NLS_LS_METHOD_DESC[NLS_LS_MAX] = {
   "chooses the nls linear solver based on which nls is being used.",
   "internal total pivot implementation. Solve in some case even under-determined systems.",
   "use external LAPACK implementation.",
-  "use KLU direct sparse solver. Only with KINSOL available."
+  "use KLU direct sparse solver. Only with KINSOL or the homotopy initialization available."
 };
 
 const char *IMPRK_LS_METHOD[IMPRK_LS_MAX] = {
@@ -97,6 +97,7 @@ enum _FLAG
   FLAG_ILS,
   FLAG_IMPRK_ORDER,
   FLAG_IMPRK_LS,
+  FLAG_INIT_CACHE,
   FLAG_INITIAL_STEP_SIZE,
   FLAG_INPUT_CSV,
   FLAG_INPUT_FILE,
@@ -111,6 +112,7 @@ enum _FLAG
   FLAG_JACOBIAN_THREADS,
   FLAG_L,
   FLAG_L_DATA_RECOVERY,
+  FLAG_L_SPARSE,
   FLAG_LOG_FORMAT,
   FLAG_LS,
   FLAG_LS_IPOPT,
@@ -123,6 +125,7 @@ enum _FLAG
   FLAG_MAX_EVENT_ITERATIONS,
   FLAG_MAX_ORDER,
   FLAG_MAX_STEP_SIZE,
+  FLAG_MEASURETIMEHISTOGRAM,
   FLAG_MEASURETIMEPLOTFORMAT,
   FLAG_NEWTON_FTOL,
   FLAG_NEWTON_MAX_STEP_FACTOR,
@@ -153,6 +156,7 @@ enum _FLAG
   FLAG_R,
   FLAG_DATA_RECONCILE,
   FLAG_DATA_RECONCILE_BOUNDARY,
+  FLAG_DATA_RECONCILE_SPARSE,
   FLAG_RT,
   FLAG_S,
   FLAG_SINGLE_PRECISION,
@@ -195,6 +195,11 @@ Types for Common Functions
    typedef fmi2Status fmi2GetDirectionalDerivativeTYPE(fmi2Component, const fmi2ValueReference[], size_t,
                                                                    const fmi2ValueReference[], size_t,
                                                                    const fmi2Real[], fmi2Real[]);
+#ifdef FMU_EXPERIMENTAL
+   typedef fmi2Status fmi2GetPartialJacobianTYPE      (fmi2Component, const fmi2ValueReference[], size_t,
+                                                                   const fmi2ValueReference[], size_t,
+                                                                   fmi2Real[]);
+#endif
 
 /***************************************************
 Types for Functions for FMI2 for Model Exchange
@@ -210,6 +210,9 @@ Common Functions
 #define fmi2SerializeFMUstate        fmi2FullName(fmi2SerializeFMUstate)
 #define fmi2DeSerializeFMUstate      fmi2FullName(fmi2DeSerializeFMUstate)
 #define fmi2GetDirectionalDerivative fmi2FullName(fmi2GetDirectionalDerivative)
+#ifdef FMU_EXPERIMENTAL
+#define fmi2GetPartialJacobian       fmi2FullName(fmi2GetPartialJacobian)
+#endif
 
 
 /***************************************************
@@ -288,6 +291,9 @@ Common Functions
 
 /* Getting partial derivatives */
    FMI2_Export fmi2GetDirectionalDerivativeTYPE fmi2GetDirectionalDerivative;
+#ifdef FMU_EXPERIMENTAL
+   FMI2_Export fmi2GetPartialJacobianTYPE       fmi2GetPartialJacobian;
+#endif
 
 
 /***************************************************
@@ -74,6 +74,14 @@ typedef enum {
   model_state_fatal                   = 1<<11  /* ME and CS */
 } ModelState;
 
+/* FMU state snapshot stored as one flat byte buffer, see fmi2GetFMUstate */
+typedef struct INTERNAL_FMU_STATE {
+  size_t size;                      /* number of used bytes of data */
+  size_t capacity;                  /* number of allocated bytes of data */
+  char* data;
+  struct INTERNAL_FMU_STATE* next;  /* next unused snapshot in the pool of the instance */
+} INTERNAL_FMU_STATE;
+
 typedef struct {
   fmi2String instanceName;
   fmi2Type type;
@@ -95,25 +103,26 @@ typedef struct {
   fmi2Real stopTime;
 
   int _need_update;
+  int _outputs_valid;         /* outputs with a clean dependency slice are up to date, see fmi2SetReal */
+  fmi2Boolean* _outputs_dirty;
   int _has_jacobian;
   int _has_jacobian_intialization;
   ANALYTIC_JACOBIAN* fmiDerJac;
   ANALYTIC_JACOBIAN* fmiDerJacInitialization;
+  ANALYTIC_JACOBIAN* _jac_constant_evaluated;  /* Jacobian whose constant equations are up to date, see fmi2GetDirectionalDerivative */
+  fmi2Real* _jac_values;                       /* all non-zeros of fmiDerJac in the order of its sparsity pattern */
+  int _jac_values_valid;
+  int _jac_unit_seeds;                         /* number of consecutive single seed calls of fmi2GetDirectionalDerivative */
 
   fmi2Real* states;
   fmi2Real* states_der;
   fmi2Real* event_indicators;
   fmi2Real* event_indicators_prev;
   fmi2Real* input_real_derivative;
+
+  INTERNAL_FMU_STATE* fmuStatePool; /* freed snapshots, reused by fmi2GetFMUstate */
 } ModelInstance;
 
-typedef struct {
-  RINGBUFFER* simulationData;
-  modelica_real* realParameter;
-  modelica_integer* integerParameter;
-  modelica_boolean* booleanParameter;
-  modelica_string* stringParameter;
-} INTERNAL_FMU_STATE;
 
 
 /* reset alignment policy to the one set before reading this file */
@@ -763,15 +763,15 @@ bool VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
     MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, jsonDocument.errorString, Helper::scriptingKind, Helper::errorLevel));
     MainWindow::instance()->printStandardOutAndErrorFilesMessages();
   }
-  /* open the .mat file */
-  ModelicaMatReader matReader;
-  matReader.file = 0;
-  const char *msg[] = {""};
+  /* open the .mat file. The parsed file is shared with the plot windows through the ResultFileCache. */
+  QSharedPointer<ResultFile> pResultFile;
   if (fileName.endsWith(".mat")) {
     //Read in mat file
-    if (0 != (msg[0] = omc_new_matlab4_reader(QString(filePath + "/" + fileName).toUtf8().constData(), &matReader))) {
+    QString errorString;
+    pResultFile = ResultFileCache::open(filePath + "/" + fileName, &errorString);
+    if (!pResultFile) {
       MessagesWidget::instance()->addGUIMessage(MessageItem(MessageItem::Modelica, GUIMessages::getMessage(GUIMessages::ERROR_OPENING_FILE).arg(filePath + "/" + fileName)
-                                                            .arg(QString(msg[0])), Helper::scriptingKind, Helper::errorLevel));
+                                                            .arg(errorString), Helper::scriptingKind, Helper::errorLevel));
     }
   }
   // create hash based VariableNode
@@ -903,7 +903,7 @@ bool VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
       /* get the variable information i.e value, unit, displayunit, description */
       QString type, value, variability, unit, displayUnit, description;
       bool changeAble = false;
-      getVariableInformation(&matReader, variableToFind, &type, &value, &changeAble, &variability, &unit, &displayUnit, &description);
+      getVariableInformation(pResultFile ? pResultFile->getMatReader() : 0, variableToFind, &type, &value, &changeAble, &variability, &unit, &displayUnit, &description);
       /* set the variable type and value */
       variableData << type <<  StringHandler::unparse(QString("\"").append(value).append("\""));
       /* set the variable unit */
@@ -1005,10 +1005,6 @@ bool VariablesTreeModel::insertVariablesItems(QString fileName, QString filePath
   insertVariablesItems(pTopVariableNode, pTopVariablesTreeItem);
   // Delete VariableNode
   delete pTopVariableNode;
-  /* close the .mat file */
-  if (fileName.endsWith(".mat") && matReader.file) {
-    omc_free_matlab4_reader(&matReader);
-  }
   /* Ticket #3016.
    * If you only have one model the message "You must select a class to re-simulate" is annoying.
    * A default behavior of selecting the (single) model would be good.
@@ -1204,7 +1200,7 @@ void VariablesTreeModel::getVariableInformation(ModelicaMatReader *pMatReader, Q
     if (*changeAble) {
       *value = hash.value("start");
     } else { /* Read the final value of the variable. Only mat result files are supported. */
-      if ((pMatReader->file != NULL) && strcmp(pMatReader->fileName, "")) {
+      if (pMatReader && (pMatReader->file != NULL) && strcmp(pMatReader->fileName, "")) {
         *value = "";
         ModelicaMatVariable_t *var = omc_matlab4_find_var(pMatReader, variableToFind.toUtf8().constData());
         double res;
@@ -1505,8 +1501,6 @@ VariablesWidget::VariablesWidget(QWidget *pParent)
   mpVariablesTreeView->setColumnWidth(3, 70);
   mpVariablesTreeView->setColumnHidden(2, true); // hide Unit column
   mpLastActiveSubWindow = 0;
-  mModelicaMatReader.file = 0;
-  mpCSVData = 0;
   // create the layout
   QGridLayout *pMainLayout = new QGridLayout;
   pMainLayout->setContentsMargins(0, 0, 0, 0);
@@ -1879,19 +1873,20 @@ double VariablesWidget::readVariableValue(QString variable, double time)
   double value = 0.0;
   bool found = false;
 
-  if (mModelicaMatReader.file) {
-    ModelicaMatVariable_t* var = omc_matlab4_find_var(&mModelicaMatReader, variable.toUtf8().constData());
+  if (mpResultFile && mpResultFile->getMatReader()) {
+    ModelicaMatReader *pMatReader = mpResultFile->getMatReader();
+    ModelicaMatVariable_t* var = omc_matlab4_find_var(pMatReader, variable.toUtf8().constData());
     if (var) {
-      omc_matlab4_val(&value, &mModelicaMatReader, var, time);
+      omc_matlab4_val(&value, pMatReader, var, time);
       found = true;
     } else {
     }
-  } else if (mpCSVData) {
-    double *timeDataSet = read_csv_dataset(mpCSVData, "time");
+  } else if (mpResultFile && mpResultFile->getCSVData()) {
+    double *timeDataSet = mpResultFile->readCSVDataset("time");
     if (timeDataSet) {
-      for (int i = 0 ; i < mpCSVData->numsteps ; i++) {
+      for (int i = 0 ; i < mpResultFile->getCSVData()->numsteps ; i++) {
         if (QString::number(timeDataSet[i]).compare(QString::number(time)) == 0) {
-          double *varDataSet = read_csv_dataset(mpCSVData, variable.toUtf8().constData());
+          double *varDataSet = mpResultFile->readCSVDataset(variable);
           if (varDataSet) {
             value = varDataSet[i];
             found = true;
@@ -2428,14 +2423,8 @@ void VariablesWidget::selectInteractivePlotWindow(VariablesTreeItem *pVariablesT
  */
 void VariablesWidget::closeResultFile()
 {
-  if (mModelicaMatReader.file) {
-    omc_free_matlab4_reader(&mModelicaMatReader);
-    mModelicaMatReader.file = 0;
-  }
-  if (mpCSVData) {
-    omc_free_csv_reader(mpCSVData);
-    mpCSVData = 0;
-  }
+  // only drops the reference, the file stays parsed while plot windows use it
+  mpResultFile.clear();
   if (mPlotFileReader.isOpen()) {
     mPlotFileReader.close();
   }
@@ -2453,15 +2442,10 @@ void VariablesWidget::openResultFile()
                        .arg(mpVariablesTreeModel->getActiveVariablesTreeItem()->getFileName());
     bool errorOpeningFile = false;
     QString errorString = "";
-    if (mpVariablesTreeModel->getActiveVariablesTreeItem()->getFileName().endsWith(".mat")) {
-      const char *msg[] = {""};
-      if (0 != (msg[0] = omc_new_matlab4_reader(fileName.toUtf8().constData(), &mModelicaMatReader))) {
-        errorOpeningFile = true;
-        errorString = msg[0];
-      }
-    } else if (mpVariablesTreeModel->getActiveVariablesTreeItem()->getFileName().endsWith(".csv")) {
-      mpCSVData = read_csv(fileName.toUtf8().constData());
-      if (!mpCSVData) {
+    if (mpVariablesTreeModel->getActiveVariablesTreeItem()->getFileName().endsWith(".mat")
+        || mpVariablesTreeModel->getActiveVariablesTreeItem()->getFileName().endsWith(".csv")) {
+      mpResultFile = ResultFileCache::open(fileName, &errorString);
+      if (!mpResultFile) {
         errorOpeningFile = true;
       }
     } else if (mpVariablesTreeModel->getActiveVariablesTreeItem()->getFileName().endsWith(".plt")) {
@@ -257,8 +257,7 @@ private:
   QVector<PlotParametricCurve> mPlotParametricCurves;
   QHash<QString, QList<QString>> mSelectedInteractiveVariables;
   QMdiSubWindow *mpLastActiveSubWindow;
-  ModelicaMatReader mModelicaMatReader;
-  csv_data *mpCSVData;
+  QSharedPointer<OMPlot::ResultFile> mpResultFile;
   QFile mPlotFileReader;
   void selectInteractivePlotWindow(VariablesTreeItem *pVariablesTreeItem);
   void openResultFile();
@@ -27,7 +27,8 @@ HEADERS += OMPlot.h \
     PlotWindowContainer.h \
     PlotMainWindow.h \
     ScaleDraw.h \
-    LinearScaleEngine.h
+    LinearScaleEngine.h \
+    ResultFileCache.h
 
 win32 {
   _cxx = $$(CXX)
@@ -29,7 +29,8 @@ SOURCES += Plot.cpp \
     PlotWindowContainer.cpp \
     PlotMainWindow.cpp \
     ScaleDraw.cpp \
-    LinearScaleEngine.cpp
+    LinearScaleEngine.cpp \
+    ResultFileCache.cpp
 
 HEADERS  += OMPlot.h \
     PlotZoomer.h \
@@ -43,7 +44,8 @@ HEADERS  += OMPlot.h \
     PlotWindowContainer.h \
     PlotMainWindow.h \
     ScaleDraw.h \
-    LinearScaleEngine.h
+    LinearScaleEngine.h \
+    ResultFileCache.h
 
 win32 {
   _cxx = $$(CXX)
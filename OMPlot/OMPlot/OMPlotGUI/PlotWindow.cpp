@@ -184,6 +184,25 @@ void PlotWindow::initializeFile(QString file)
   }
 }
 
+/*!
+ * \brief PlotWindow::getResultFile
+ * Returns the parsed result file of this window.
+ * The file is shared through ResultFileCache so adding curves or windows for the same file doesn't parse it again.
+ * The file is reparsed if it has changed on disk.
+ * \return
+ */
+ResultFile* PlotWindow::getResultFile()
+{
+  if (!mpResultFile || mpResultFile->getFileName() != mFile.fileName() || !mpResultFile->isUpToDate()) {
+    QString errorString;
+    mpResultFile = ResultFileCache::open(mFile.fileName(), &errorString);
+    if (!mpResultFile) {
+      throw PlotException(errorString);
+    }
+  }
+  return mpResultFile.data();
+}
+
 void PlotWindow::getStartStopTime(double &start, double &stop){
   //PLOT PLT
   if (mFile.fileName().endsWith("plt"))
@@ -228,46 +247,30 @@ void PlotWindow::getStartStopTime(double &start, double &stop){
       }
     }
     if(mpTextStream->atEnd()) throw NoVariableException("Variable doesnt exist: time");
-    // close the file
     mFile.close();
   }
   //PLOT CSV
   else if (mFile.fileName().endsWith("csv"))
   {
     /* open the file */
-    struct csv_data *csvReader;
-    csvReader = read_csv(mFile.fileName().toStdString().c_str());
-    if (csvReader == NULL) {
-      throw NoVariableException("Variable doesnt exist: time");
-    }
+    ResultFile *pResultFile = getResultFile();
+    struct csv_data *csvReader = pResultFile->getCSVData();
     //Read in timevector
-    double *timeVals = read_csv_dataset(csvReader, "time");
+    double *timeVals = pResultFile->readCSVDataset("time");
     if (timeVals == NULL) {
-      omc_free_csv_reader(csvReader);
       throw NoVariableException("Variable doesnt exist: time");
     }
     start = timeVals[0];
     stop = timeVals[csvReader->numsteps-1];
-
-    // close the file
-    omc_free_csv_reader(csvReader);
   }
   //PLOT MAT
   else if(mFile.fileName().endsWith("mat"))
   {
-    ModelicaMatReader reader;
-    const char *msg = "";
-    //Read in mat file
-    if(0 != (msg = omc_new_matlab4_reader(mFile.fileName().toStdString().c_str(), &reader))) {
-      throw PlotException(msg);
-    }
+    ModelicaMatReader &reader = *getResultFile()->getMatReader();
 
     //Read in timevector
     start = omc_matlab4_startTime(&reader);
     stop =  omc_matlab4_stopTime(&reader);
-
-    // close the file
-    omc_free_matlab4_reader(&reader);
   } else {throw PlotException(tr("Failed to open simulation result file %1").arg(mFile.fileName()));}
 }
 
@@ -446,7 +449,6 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
     // if plottype is PLOT then check which requested variables are not found in the file
     if (getPlotType() == PlotWindow::PLOT)
       checkForErrors(mVariablesList, variablesPlotted);
-    // close the file
     mFile.close();
   }
   //PLOT CSV
@@ -454,19 +456,16 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
   {
     /* open the file */
     QStringList variablesPlotted;
-    struct csv_data *csvReader;
-    csvReader = read_csv(mFile.fileName().toStdString().c_str());
-    if (csvReader == NULL)
-      throw PlotException(tr("Failed to open simulation result file %1").arg(mFile.fileName()));
+    ResultFile *pResultFile = getResultFile();
+    struct csv_data *csvReader = pResultFile->getCSVData();
 
     //Read in timevector
-    double *timeVals = read_csv_dataset(csvReader, "time");
+    double *timeVals = pResultFile->readCSVDataset("time");
     if (timeVals == NULL)
     {
-      timeVals = read_csv_dataset(csvReader, "lambda");
+      timeVals = pResultFile->readCSVDataset("lambda");
       if (timeVals == NULL)
       {
-        omc_free_csv_reader(csvReader);
         throw NoVariableException(tr("Variable doesnt exist: %1").arg("time or lambda").toStdString().c_str());
       }
       setXLabel("lambda");
@@ -478,10 +477,9 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
       if (mVariablesList.contains(csvReader->variables[i]) or getPlotType() == PlotWindow::PLOTALL)
       {
         variablesPlotted.append(csvReader->variables[i]);
-        double *vals = read_csv_dataset(csvReader, csvReader->variables[i]);
+        double *vals = pResultFile->readCSVDataset(csvReader->variables[i]);
         if (vals == NULL)
         {
-          omc_free_csv_reader(csvReader);
           throw NoVariableException(tr("Variable doesnt exist: %1").arg(csvReader->variables[i]).toStdString().c_str());
         }
 
@@ -506,24 +504,15 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
     // if plottype is PLOT then check which requested variables are not found in the file
     if (getPlotType() == PlotWindow::PLOT)
       checkForErrors(mVariablesList, variablesPlotted);
-    // close the file
-    omc_free_csv_reader(csvReader);
   }
   //PLOT MAT
   else if(mFile.fileName().endsWith("mat"))
   {
-    ModelicaMatReader reader;
+    ModelicaMatReader &reader = *getResultFile()->getMatReader();
     ModelicaMatVariable_t *var;
-    const char *msg = "";
     QStringList variablesPlotted;
 
-    //Read in mat file
-    if(0 != (msg = omc_new_matlab4_reader(mFile.fileName().toStdString().c_str(), &reader))) {
-      throw PlotException(msg);
-    }
-
     if (reader.nvar < 1) {
-      omc_free_matlab4_reader(&reader);
       throw NoVariableException("Variable doesnt exist: time");
     }
 
@@ -532,7 +521,6 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
     //Read in timevector
     double *timeVals = omc_matlab4_read_vals(&reader,1);
     if (!timeVals) {
-      omc_free_matlab4_reader(&reader);
       throw NoVariableException(QString("Corrupt file. nvar %1").arg(reader.nvar).toStdString().c_str());
     }
     // read in all values
@@ -548,7 +536,6 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
         // read the variable values
         var = omc_matlab4_find_var(&reader, reader.allInfo[i].name);
         if (!var) {
-          omc_free_matlab4_reader(&reader);
           throw NoVariableException(QString("Variable doesn't exist : ").append(reader.allInfo[i].name).toStdString().c_str());
         }
         // clear previous curve data
@@ -558,7 +545,6 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
         if (!var->isParam) {
           double *vals = omc_matlab4_read_vals(&reader,var->index);
           if (!vals) {
-            omc_free_matlab4_reader(&reader);
             throw NoVariableException(QString("Corrupt file. nvar %1").arg(reader.nvar).toStdString().c_str());
           }
           // set plot curve data and attach it to plot
@@ -572,7 +558,6 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
         } else { // if variable is a parameter then
           double val;
           if (omc_matlab4_val(&val,&reader,var,0.0)) {
-            omc_free_matlab4_reader(&reader);
             throw NoVariableException(QString("Parameter doesn't have a value : ").append(reader.allInfo[i].name).toStdString().c_str());
           }
 
@@ -589,8 +574,6 @@ void PlotWindow::plot(PlotCurve *pPlotCurve)
     // if plottype is PLOT then check which requested variables are not found in the file
     if (getPlotType() == PlotWindow::PLOT)
       checkForErrors(mVariablesList, variablesPlotted);
-    // close the file
-    omc_free_matlab4_reader(&reader);
   }
 }
 
@@ -698,10 +681,8 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
     {
       /* open the file */
       QStringList variablesPlotted;
-      struct csv_data *csvReader;
-      csvReader = read_csv(mFile.fileName().toStdString().c_str());
-      if (csvReader == NULL)
-        throw PlotException(tr("Failed to open simulation result file %1").arg(mFile.fileName()));
+      ResultFile *pResultFile = getResultFile();
+      struct csv_data *csvReader = pResultFile->getCSVData();
 
       double *xVals = NULL, *yVals = NULL;
       // read in all values
@@ -710,18 +691,16 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
         if ((xVariable.compare(csvReader->variables[i]) == 0))
         {
           variablesPlotted.append(csvReader->variables[i]);
-          xVals = read_csv_dataset(csvReader, csvReader->variables[i]);
+          xVals = pResultFile->readCSVDataset(csvReader->variables[i]);
           if (xVals == NULL) {
-            omc_free_csv_reader(csvReader);
             throw NoVariableException(tr("Variable doesnt exist: %1").arg(csvReader->variables[i]).toStdString().c_str());
           }
         }
         if ((yVariable.compare(csvReader->variables[i]) == 0))
         {
           variablesPlotted.append(csvReader->variables[i]);
-          yVals = read_csv_dataset(csvReader, csvReader->variables[i]);
+          yVals = pResultFile->readCSVDataset(csvReader->variables[i]);
           if (yVals == NULL) {
-            omc_free_csv_reader(csvReader);
             throw NoVariableException(tr("Variable doesnt exist: %1").arg(csvReader->variables[i]).toStdString().c_str());
           }
         }
@@ -745,20 +724,13 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
       mpPlot->replot();
       // check which requested variables are not found in the file
       checkForErrors(mVariablesList, variablesPlotted);
-      // close the file
-      omc_free_csv_reader(csvReader);
     }
     //PLOT MAT
     else if(mFile.fileName().endsWith("mat"))
     {
       //Declare variables
-      ModelicaMatReader reader;
+      ModelicaMatReader &reader = *getResultFile()->getMatReader();
       ModelicaMatVariable_t *var;
-      const char *msg = "";
-
-      //Read the .mat file
-      if(0 != (msg = omc_new_matlab4_reader(mFile.fileName().toStdString().c_str(), &reader)))
-        throw PlotException(msg);
 
       if (!editCase) {
         QFileInfo fileInfo(mFile);
@@ -768,7 +740,6 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
       //Fill variable x with data
       var = omc_matlab4_find_var(&reader, xVariable.toStdString().c_str());
       if (!var) {
-        omc_free_matlab4_reader(&reader);
         throw NoVariableException(QString("Variable doesn't exist : ").append(xVariable).toStdString().c_str());
       }
       // clear previous curve data
@@ -779,7 +750,6 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
       {
         double *xVals = omc_matlab4_read_vals(&reader,var->index);
         if (!xVals) {
-          omc_free_matlab4_reader(&reader);
           throw NoVariableException(QString("Corrupt file. nvar %1").arg(reader.nvar).toStdString().c_str());
         }
         for (int i = 0 ; i < reader.nrows ; i++)
@@ -790,7 +760,6 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
       {
         double xval;
         if (omc_matlab4_val(&xval,&reader,var,0.0)) {
-          omc_free_matlab4_reader(&reader);
           throw NoVariableException(QString("Parameter doesn't have a value : ").append(xVariable).toStdString().c_str());
         }
         pPlotCurve->addXAxisValue(xval);
@@ -798,7 +767,6 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
       //Fill variable y with data
       var = omc_matlab4_find_var(&reader, yVariable.toStdString().c_str());
       if (!var) {
-        omc_free_matlab4_reader(&reader);
         throw NoVariableException(QString("Variable doesn't exist : ").append(yVariable).toStdString().c_str());
       }
       // if variable is not a parameter then
@@ -806,7 +774,6 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
       {
         double *yVals = omc_matlab4_read_vals(&reader,var->index);
         if (!yVals) {
-          omc_free_matlab4_reader(&reader);
           throw NoVariableException(QString("Corrupt file. nvar %1").arg(reader.nvar).toStdString().c_str());
         }
         for (int i = 0 ; i < reader.nrows ; i++)
@@ -817,7 +784,6 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
       {
         double yval;
         if (omc_matlab4_val(&yval,&reader,var,0.0)) {
-          omc_free_matlab4_reader(&reader);
           throw NoVariableException(QString("Parameter doesn't have a value : ").append(yVariable).toStdString().c_str());
         }
         pPlotCurve->addYAxisValue(yval);
@@ -825,7 +791,6 @@ void PlotWindow::plotParametric(PlotCurve *pPlotCurve)
       pPlotCurve->setData(pPlotCurve->getXAxisVector(), pPlotCurve->getYAxisVector(), pPlotCurve->getSize());
       pPlotCurve->attach(mpPlot);
       mpPlot->replot();
-      omc_free_matlab4_reader(&reader);
     }
   }
 }
@@ -991,21 +956,17 @@ void PlotWindow::plotArray(double time, PlotCurve *pPlotCurve)
   else if (mFile.fileName().endsWith("csv"))
   {
     /* open the file */
-    struct csv_data *csvReader;
-    csvReader = read_csv(mFile.fileName().toStdString().c_str());
-    if (csvReader == NULL)
-      throw PlotException(tr("Failed to open simulation result file %1").arg(mFile.fileName()));
+    ResultFile *pResultFile = getResultFile();
+    struct csv_data *csvReader = pResultFile->getCSVData();
     //Read in timevector
-    double *timeVals = read_csv_dataset(csvReader, "time");
+    double *timeVals = pResultFile->readCSVDataset("time");
     if (timeVals == NULL)
     {
-      omc_free_csv_reader(csvReader);
       throw NoVariableException(tr("Variable doesnt exist: %1").arg("time").toStdString().c_str());
     }
     double alpha;
     int it = setupInterp(timeVals, time, csvReader->numsteps, alpha);
     if (it < 0) {
-      omc_free_csv_reader(csvReader);
       throw PlotException("Time out of bounds.");
     }
     QStringList::Iterator itVarList;
@@ -1026,7 +987,7 @@ void PlotWindow::plotArray(double time, PlotCurve *pPlotCurve)
         } else {
           varNameQS.append("["+QString::number(i)+"]");
         }
-        if (!(arrElement = read_csv_dataset(csvReader, varNameQS.toStdString().c_str()))) break;
+        if (!(arrElement = pResultFile->readCSVDataset(varNameQS))) break;
         i++;
 
         if (it == 0)
@@ -1046,30 +1007,23 @@ void PlotWindow::plotArray(double time, PlotCurve *pPlotCurve)
       mpPlot->replot();
 
     }
-    omc_free_csv_reader(csvReader);
   }
   //PLOT MAT
   else
     if(mFile.fileName().endsWith("mat"))
     {
-      ModelicaMatReader reader;
+      ModelicaMatReader &reader = *getResultFile()->getMatReader();
       ModelicaMatVariable_t *var;
       QList<ModelicaMatVariable_t*> vars;
-      const char *msg = "";
       QStringList variablesPlotted;
 
-      //Read in mat file
-      if(0 != (msg = omc_new_matlab4_reader(mFile.fileName().toStdString().c_str(), &reader)))
-        throw PlotException(msg);
       //calculate time
       double startTime = omc_matlab4_startTime(&reader);
       double stopTime =  omc_matlab4_stopTime(&reader);
       if (reader.nvar < 1) {
-        omc_free_matlab4_reader(&reader);
         throw NoVariableException("Variable doesnt exist: time");
       }
       if (time<startTime || stopTime<time) {
-        omc_free_matlab4_reader(&reader);
         throw PlotException("Time out of bounds.");
       }
       QStringList::Iterator itVarList;
@@ -1110,8 +1064,6 @@ void PlotWindow::plotArray(double time, PlotCurve *pPlotCurve)
       // if plottype is PLOT then check which requested variables are not found in the file
       if (getPlotType() == PlotWindow::PLOT)
         checkForErrors(mVariablesList, variablesPlotted);
-      // close the file
-      omc_free_matlab4_reader(&reader);
     }
 }
 
@@ -1208,21 +1160,17 @@ void PlotWindow::plotArrayParametric(double time, PlotCurve *pPlotCurve)
     else if (mFile.fileName().endsWith("csv"))
     {
       /* open the file */
-      struct csv_data *csvReader;
-      csvReader = read_csv(mFile.fileName().toStdString().c_str());
-      if (csvReader == NULL)
-        throw PlotException(tr("Failed to open simulation result file %1").arg(mFile.fileName()));
+      ResultFile *pResultFile = getResultFile();
+      struct csv_data *csvReader = pResultFile->getCSVData();
       //Read in timevector
-      double *timeVals = read_csv_dataset(csvReader, "time");
+      double *timeVals = pResultFile->readCSVDataset("time");
       if (timeVals == NULL)
       {
-        omc_free_csv_reader(csvReader);
         throw NoVariableException(tr("Variable doesnt exist: %1").arg("time").toStdString().c_str());
       }
       double alpha;
       int it = setupInterp(timeVals, time, csvReader->numsteps, alpha);
       if (it < 0) {
-        omc_free_csv_reader(csvReader);
         throw PlotException("Time out of bounds.");
       }
       if (!editCase) {
@@ -1246,7 +1194,7 @@ void PlotWindow::plotArrayParametric(double time, PlotCurve *pPlotCurve)
           } else {
             varNameQS.append("["+QString::number(i)+"]");
           }
-          if (!(arrElement = read_csv_dataset(csvReader, varNameQS.toStdString().c_str()))) break;
+          if (!(arrElement = pResultFile->readCSVDataset(varNameQS))) break;
 
           if (it == 0)
             res.push_back(arrElement[0]);
@@ -1259,7 +1207,6 @@ void PlotWindow::plotArrayParametric(double time, PlotCurve *pPlotCurve)
         }
         else { //yVar
           if (pPlotCurve->getSize()!=res.count()) {
-            omc_free_csv_reader(csvReader);
             throw PlotException(tr("Arrays must be of the same length in array parametric plot."));
           }
           for (int i = 0; i < res.count(); i++)
@@ -1270,20 +1217,14 @@ void PlotWindow::plotArrayParametric(double time, PlotCurve *pPlotCurve)
       pPlotCurve->attach(mpPlot);
       mpPlot->setFooter(QString("t = %1 " + getTimeUnit()).arg(time*timeUnitFactor,0,'g',3));
       mpPlot->replot();
-      omc_free_csv_reader(csvReader);
     }
     //PLOT MAT
     else if(mFile.fileName().endsWith("mat"))
     {
       //Declare variables
-      ModelicaMatReader reader;
+      ModelicaMatReader &reader = *getResultFile()->getMatReader();
       ModelicaMatVariable_t *var;
       double *res;
-      const char *msg = "";
-
-      //Read the .mat file
-      if(0 != (msg = omc_new_matlab4_reader(mFile.fileName().toStdString().c_str(), &reader)))
-        throw PlotException(msg);
 
       if (!editCase) {
         QFileInfo fileInfo(mFile);
@@ -1294,11 +1235,9 @@ void PlotWindow::plotArrayParametric(double time, PlotCurve *pPlotCurve)
       double startTime = omc_matlab4_startTime(&reader);
       double stopTime =  omc_matlab4_stopTime(&reader);
       if (reader.nvar < 1) {
-        omc_free_matlab4_reader(&reader);
         throw NoVariableException("Variable doesnt exist: time");
       }
       if (time<startTime || stopTime<time) {
-        omc_free_matlab4_reader(&reader);
         throw PlotException("Time out of bounds.");
       }
       pPlotCurve->clearXAxisVector();
@@ -1331,7 +1270,6 @@ void PlotWindow::plotArrayParametric(double time, PlotCurve *pPlotCurve)
             pPlotCurve->addXAxisValue(res[i]);
         else{
           if (pPlotCurve->getSize()!=vars.count()) {
-            omc_free_matlab4_reader(&reader);
             throw PlotException("Arrays must be of the same length in array parametric plot.");
           }
           for (int i = 0; i < vars.count(); i++)
@@ -1343,7 +1281,6 @@ void PlotWindow::plotArrayParametric(double time, PlotCurve *pPlotCurve)
       pPlotCurve->attach(mpPlot);
       mpPlot->setFooter(QString("t = %1 " + getTimeUnit()).arg(time*timeUnitFactor,0,'g',3));
       mpPlot->replot();
-      omc_free_matlab4_reader(&reader);
     }
   }
 }
@@ -50,6 +50,7 @@
 #include <stdexcept>
 #include "util/read_matlab4.h"
 #include "util/read_csv.h"
+#include "ResultFileCache.h"
 #include "OMPlot.h"
 
 namespace OMPlot
@@ -75,6 +76,7 @@ private:
   QComboBox *mpSimulationSpeedComboBox;
   QTextStream *mpTextStream;
   QFile mFile;
+  QSharedPointer<ResultFile> mpResultFile;
   QStringList mVariablesList;
   PlotType mPlotType;
   QString mGridType;
@@ -115,6 +117,7 @@ public:
   void setPlotType(PlotType type);
   PlotType getPlotType();
   void initializeFile(QString file);
+  ResultFile* getResultFile();
   void getStartStopTime(double &start, double &stop);
   void setupToolbar();
   void plot(PlotCurve *pPlotCurve = 0);
@@ -0,0 +1,189 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES RECIPIENT'S ACCEPTANCE
+ * OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3, ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "ResultFileCache.h"
+
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QObject>
+
+using namespace OMPlot;
+
+QHash<QString, QWeakPointer<ResultFile> > ResultFileCache::mResultFiles;
+QMutex ResultFileCache::mMutex;
+
+ResultFile::ResultFile(const QString &fileName, Format format)
+  : mFileName(fileName), mFormat(format), mSize(0), mStartTime(0.0), mStopTime(0.0), mpCSVData(0)
+{
+  mMatReader.file = 0;
+}
+
+ResultFile::~ResultFile()
+{
+  if (mMatReader.file) {
+    omc_free_matlab4_reader(&mMatReader);
+    mMatReader.file = 0;
+  }
+  if (mpCSVData) {
+    omc_free_csv_reader(mpCSVData);
+    mpCSVData = 0;
+  }
+}
+
+/*!
+ * \brief ResultFile::isUpToDate
+ * Returns true if the file on disk is still the one that was parsed.
+ * \return
+ */
+bool ResultFile::isUpToDate() const
+{
+  QFileInfo fileInfo(mFileName);
+  return fileInfo.exists() && fileInfo.lastModified() == mLastModified && fileInfo.size() == mSize;
+}
+
+/*!
+ * \brief ResultFile::readCSVDataset
+ * Returns the column of the variable or NULL if the variable is not in the file.
+ * Uses the variable index built on open instead of the linear search of read_csv_dataset.
+ * \param variable
+ * \return
+ */
+double* ResultFile::readCSVDataset(const QString &variable) const
+{
+  if (!mpCSVData) {
+    return 0;
+  }
+  QHash<QString, int>::const_iterator it = mCSVVariableIndexes.constFind(variable);
+  if (it == mCSVVariableIndexes.constEnd()) {
+    return 0;
+  }
+  return mpCSVData->data + (size_t)it.value() * mpCSVData->numsteps;
+}
+
+/*!
+ * \brief ResultFile::open
+ * Parses the result file.
+ * \param pErrorString
+ * \return
+ */
+bool ResultFile::open(QString *pErrorString)
+{
+  QFileInfo fileInfo(mFileName);
+  mLastModified = fileInfo.lastModified();
+  mSize = fileInfo.size();
+  if (mFormat == MAT) {
+    const char *msg = omc_new_matlab4_reader(mFileName.toUtf8().constData(), &mMatReader);
+    if (msg) {
+      mMatReader.file = 0;
+      if (pErrorString) {
+        *pErrorString = QString(msg);
+      }
+      return false;
+    }
+    mStartTime = omc_matlab4_startTime(&mMatReader);
+    mStopTime = omc_matlab4_stopTime(&mMatReader);
+  } else {
+    mpCSVData = read_csv(mFileName.toUtf8().constData());
+    if (!mpCSVData) {
+      if (pErrorString) {
+        *pErrorString = QObject::tr("Failed to open simulation result file %1").arg(mFileName);
+      }
+      return false;
+    }
+    mCSVVariableIndexes.reserve(mpCSVData->numvars);
+    for (int i = mpCSVData->numvars - 1 ; i >= 0 ; i--) {
+      // iterate backwards so that the first column wins for duplicated names, same as read_csv_dataset
+      mCSVVariableIndexes.insert(QString(mpCSVData->variables[i]), i);
+    }
+    double *timeVals = readCSVDataset("time");
+    if (timeVals && mpCSVData->numsteps > 0) {
+      mStartTime = timeVals[0];
+      mStopTime = timeVals[mpCSVData->numsteps - 1];
+    }
+  }
+  return true;
+}
+
+QString ResultFileCache::key(const QString &fileName)
+{
+  QFileInfo fileInfo(fileName);
+  QString canonicalFilePath = fileInfo.canonicalFilePath();
+  return canonicalFilePath.isEmpty() ? fileInfo.absoluteFilePath() : canonicalFilePath;
+}
+
+/*!
+ * \brief ResultFileCache::open
+ * Returns the parsed result file.
+ * Reuses the already parsed file if it is still referenced and has not changed on disk since it was parsed.
+ * Returns a null pointer if the file is not a .mat or .csv file or if it can't be read.
+ * \param fileName
+ * \param pErrorString
+ * \return
+ */
+QSharedPointer<ResultFile> ResultFileCache::open(const QString &fileName, QString *pErrorString)
+{
+  ResultFile::Format format;
+  if (fileName.endsWith(".mat")) {
+    format = ResultFile::MAT;
+  } else if (fileName.endsWith(".csv")) {
+    format = ResultFile::CSV;
+  } else {
+    if (pErrorString) {
+      *pErrorString = QObject::tr("Unsupported result file format %1").arg(fileName);
+    }
+    return QSharedPointer<ResultFile>();
+  }
+
+  QMutexLocker locker(&mMutex);
+  const QString fileKey = key(fileName);
+  QSharedPointer<ResultFile> pResultFile = mResultFiles.value(fileKey).toStrongRef();
+  if (pResultFile && pResultFile->isUpToDate()) {
+    return pResultFile;
+  }
+  // the file is not cached, no longer referenced or has been rewritten, e.g., by a re-simulation.
+  pResultFile = QSharedPointer<ResultFile>(new ResultFile(fileName, format));
+  if (!pResultFile->open(pErrorString)) {
+    mResultFiles.remove(fileKey);
+    return QSharedPointer<ResultFile>();
+  }
+  mResultFiles.insert(fileKey, pResultFile.toWeakRef());
+  return pResultFile;
+}
+
+/*!
+ * \brief ResultFileCache::invalidate
+ * Drops the cache entry of the file. Existing references stay valid.
+ * \param fileName
+ */
+void ResultFileCache::invalidate(const QString &fileName)
+{
+  QMutexLocker locker(&mMutex);
+  mResultFiles.remove(key(fileName));
+}
@@ -0,0 +1,101 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES RECIPIENT'S ACCEPTANCE
+ * OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3, ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef RESULTFILECACHE_H
+#define RESULTFILECACHE_H
+
+#include <QString>
+#include <QHash>
+#include <QMutex>
+#include <QDateTime>
+#include <QSharedPointer>
+#include <QWeakPointer>
+
+#include "util/read_matlab4.h"
+#include "util/read_csv.h"
+
+namespace OMPlot
+{
+/*!
+ * \class ResultFile
+ * \brief A parsed .mat or .csv result file shared between all users of the same file.
+ * The header is parsed once when the file is opened. Decoded columns are kept for the lifetime of the object,
+ * i.e., the csv data is parsed completely on open and the mat reader keeps the columns it has already read.
+ * Instances are only created through ResultFileCache::open.
+ */
+class ResultFile
+{
+public:
+  enum Format {MAT, CSV};
+  ~ResultFile();
+  QString getFileName() const {return mFileName;}
+  Format getFormat() const {return mFormat;}
+  bool isUpToDate() const;
+  double getStartTime() const {return mStartTime;}
+  double getStopTime() const {return mStopTime;}
+  ModelicaMatReader* getMatReader() {return mFormat == MAT ? &mMatReader : 0;}
+  csv_data* getCSVData() {return mpCSVData;}
+  double* readCSVDataset(const QString &variable) const;
+private:
+  ResultFile(const QString &fileName, Format format);
+  bool open(QString *pErrorString);
+
+  QString mFileName;
+  Format mFormat;
+  QDateTime mLastModified;
+  qint64 mSize;
+  double mStartTime;
+  double mStopTime;
+  ModelicaMatReader mMatReader;
+  csv_data *mpCSVData;
+  QHash<QString, int> mCSVVariableIndexes;
+
+  friend class ResultFileCache;
+};
+
+/*!
+ * \class ResultFileCache
+ * \brief Process wide cache of opened result files.
+ * The cache only holds weak references. A result file stays parsed as long as someone, e.g., a PlotWindow or the VariablesWidget,
+ * holds the returned shared pointer. An entry is reparsed when the modification time or the size of the file on disk changes.
+ */
+class ResultFileCache
+{
+public:
+  static QSharedPointer<ResultFile> open(const QString &fileName, QString *pErrorString = 0);
+  static void invalidate(const QString &fileName);
+private:
+  static QString key(const QString &fileName);
+  static QHash<QString, QWeakPointer<ResultFile> > mResultFiles;
+  static QMutex mMutex;
+};
+}
+
+#endif // RESULTFILECACHE_H
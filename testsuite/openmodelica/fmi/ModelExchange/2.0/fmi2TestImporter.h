@@ -0,0 +1,84 @@
+/* Minimal FMI 2.0 declarations for the importers of the tests in this
+ * directory, so that they compile without the FMI headers.
+ */
+
+#ifndef FMI2_TEST_IMPORTER_H
+#define FMI2_TEST_IMPORTER_H
+
+#include <dlfcn.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef void* fmi2Component;
+typedef void* fmi2ComponentEnvironment;
+typedef unsigned int fmi2ValueReference;
+typedef double fmi2Real;
+typedef int fmi2Boolean;
+typedef const char* fmi2String;
+typedef enum { fmi2OK, fmi2Warning, fmi2Discard, fmi2Error, fmi2Fatal, fmi2Pending } fmi2Status;
+typedef enum { fmi2ModelExchange, fmi2CoSimulation } fmi2Type;
+
+typedef struct {
+  void (*logger)(fmi2ComponentEnvironment, fmi2String, fmi2Status, fmi2String, fmi2String, ...);
+  void* (*allocateMemory)(size_t, size_t);
+  void (*freeMemory)(void*);
+  void (*stepFinished)(fmi2ComponentEnvironment, fmi2Status);
+  fmi2ComponentEnvironment componentEnvironment;
+} fmi2CallbackFunctions;
+
+typedef struct {
+  fmi2Boolean newDiscreteStatesNeeded;
+  fmi2Boolean terminateSimulation;
+  fmi2Boolean nominalsOfContinuousStatesChanged;
+  fmi2Boolean valuesOfContinuousStatesChanged;
+  fmi2Boolean nextEventTimeDefined;
+  fmi2Real nextEventTime;
+} fmi2EventInfo;
+
+typedef fmi2Component (*fmi2InstantiateTYPE)(fmi2String, fmi2Type, fmi2String, fmi2String, const fmi2CallbackFunctions*, fmi2Boolean, fmi2Boolean);
+typedef void (*fmi2FreeInstanceTYPE)(fmi2Component);
+typedef fmi2Status (*fmi2SetupExperimentTYPE)(fmi2Component, fmi2Boolean, fmi2Real, fmi2Real, fmi2Boolean, fmi2Real);
+typedef fmi2Status (*fmi2ComponentTYPE)(fmi2Component);
+typedef fmi2Status (*fmi2NewDiscreteStatesTYPE)(fmi2Component, fmi2EventInfo*);
+typedef fmi2Status (*fmi2GetRealTYPE)(fmi2Component, const fmi2ValueReference[], size_t, fmi2Real[]);
+typedef fmi2Status (*fmi2SetRealTYPE)(fmi2Component, const fmi2ValueReference[], size_t, const fmi2Real[]);
+typedef fmi2Status (*fmi2SetContinuousStatesTYPE)(fmi2Component, const fmi2Real[], size_t);
+typedef fmi2Status (*fmi2GetDirectionalDerivativeTYPE)(fmi2Component, const fmi2ValueReference[], size_t, const fmi2ValueReference[], size_t, const fmi2Real[], fmi2Real[]);
+typedef fmi2Status (*fmi2GetContinuousStatesTYPE)(fmi2Component, fmi2Real[], size_t);
+typedef fmi2Status (*fmi2GetDerivativesTYPE)(fmi2Component, fmi2Real[], size_t);
+typedef fmi2Status (*fmi2SetTimeTYPE)(fmi2Component, fmi2Real);
+typedef fmi2Status (*fmi2CompletedIntegratorStepTYPE)(fmi2Component, fmi2Boolean, fmi2Boolean*, fmi2Boolean*);
+typedef fmi2Status (*fmi2GetFMUstateTYPE)(fmi2Component, void**);
+typedef fmi2Status (*fmi2SetFMUstateTYPE)(fmi2Component, void*);
+typedef fmi2Status (*fmi2FreeFMUstateTYPE)(fmi2Component, void**);
+typedef fmi2Status (*fmi2SerializedFMUstateSizeTYPE)(fmi2Component, void*, size_t*);
+typedef fmi2Status (*fmi2SerializeFMUstateTYPE)(fmi2Component, void*, char[], size_t);
+typedef fmi2Status (*fmi2DeSerializeFMUstateTYPE)(fmi2Component, const char[], size_t, void**);
+typedef fmi2Status (*fmi2GetPartialJacobianTYPE)(fmi2Component, const fmi2ValueReference[], size_t, const fmi2ValueReference[], size_t, fmi2Real[]);
+
+static void logger(fmi2ComponentEnvironment env, fmi2String instanceName, fmi2Status status, fmi2String category, fmi2String message, ...)
+{
+  va_list args;
+  if (status == fmi2OK) {
+    return;
+  }
+  va_start(args, message);
+  vfprintf(stdout, message, args);
+  va_end(args);
+  fputc('\n', stdout);
+}
+
+static void* load(void *handle, const char *name)
+{
+  void *sym = dlsym(handle, name);
+  if (!sym) {
+    printf("missing symbol %s\n", name);
+    exit(1);
+  }
+  return sym;
+}
+
+#define CHECK(call) if ((call) != fmi2OK) { printf("%s failed\n", #call); return 1; }
+
+#endif
@@ -0,0 +1,159 @@
+/* Importer for testDirectionalDerivativeCache.mos
+ *
+ * Compares the directional derivatives of an FMU evaluated column by column
+ * in a fresh model state with the ones answered from the cached colored
+ * Jacobian, with an arbitrary seed vector and with fmi2GetPartialJacobian.
+ * An event that changes a discrete variable and reinitializes a state has to
+ * invalidate the cached Jacobian.
+ *
+ * usage: testDirectionalDerivativeCache <shared object> <guid>
+ */
+
+#include <math.h>
+
+#include "fmi2TestImporter.h"
+
+#define N 4
+
+static int compare(const char *what, const fmi2Real *a, const fmi2Real *b, size_t n)
+{
+  size_t i;
+  double err = 0;
+  for (i=0; i<n; i++) {
+    err = fmax(err, fabs(a[i]-b[i]));
+  }
+  printf("%s: %s\n", what, err < 1e-12 ? "OK" : "MISMATCH");
+  return err < 1e-12 ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+  /* states x1..x4 and their derivatives, see modelDescription.xml */
+  const fmi2ValueReference states[N] = {0, 1, 2, 3};
+  const fmi2ValueReference derivatives[N] = {4, 5, 6, 7};
+  const fmi2Real x[N] = {1, 2, 0.5, 1};
+  const fmi2Real seed[N] = {0.5, -2, 0, 1};
+  const fmi2Real one = 1.0;
+  fmi2CallbackFunctions callbacks = {logger, calloc, free, NULL, NULL};
+  fmi2EventInfo eventInfo;
+  fmi2Real reference[N*N], cached[N*N], partial[N*N], combined[N], expected[N];
+  fmi2Component c;
+  void *handle;
+  int i, j, res = 0;
+
+  fmi2InstantiateTYPE instantiate;
+  fmi2FreeInstanceTYPE freeInstance;
+  fmi2SetupExperimentTYPE setupExperiment;
+  fmi2ComponentTYPE enterInitializationMode, exitInitializationMode, enterContinuousTimeMode, enterEventMode;
+  fmi2NewDiscreteStatesTYPE newDiscreteStates;
+  fmi2SetContinuousStatesTYPE setContinuousStates;
+  fmi2SetTimeTYPE setTime;
+  fmi2GetDirectionalDerivativeTYPE getDirectionalDerivative;
+  fmi2GetPartialJacobianTYPE getPartialJacobian;
+
+  if (argc != 3) {
+    printf("usage: %s <shared object> <guid>\n", argv[0]);
+    return 1;
+  }
+  handle = dlopen(argv[1], RTLD_NOW|RTLD_LOCAL);
+  if (!handle) {
+    printf("%s\n", dlerror());
+    return 1;
+  }
+  instantiate = (fmi2InstantiateTYPE) load(handle, "fmi2Instantiate");
+  freeInstance = (fmi2FreeInstanceTYPE) load(handle, "fmi2FreeInstance");
+  setupExperiment = (fmi2SetupExperimentTYPE) load(handle, "fmi2SetupExperiment");
+  enterInitializationMode = (fmi2ComponentTYPE) load(handle, "fmi2EnterInitializationMode");
+  exitInitializationMode = (fmi2ComponentTYPE) load(handle, "fmi2ExitInitializationMode");
+  enterContinuousTimeMode = (fmi2ComponentTYPE) load(handle, "fmi2EnterContinuousTimeMode");
+  newDiscreteStates = (fmi2NewDiscreteStatesTYPE) load(handle, "fmi2NewDiscreteStates");
+  enterEventMode = (fmi2ComponentTYPE) load(handle, "fmi2EnterEventMode");
+  setContinuousStates = (fmi2SetContinuousStatesTYPE) load(handle, "fmi2SetContinuousStates");
+  setTime = (fmi2SetTimeTYPE) load(handle, "fmi2SetTime");
+  getDirectionalDerivative = (fmi2GetDirectionalDerivativeTYPE) load(handle, "fmi2GetDirectionalDerivative");
+  getPartialJacobian = (fmi2GetPartialJacobianTYPE) load(handle, "fmi2GetPartialJacobian");
+
+  c = instantiate("DirDerCache", fmi2ModelExchange, argv[2], "", &callbacks, 0, 0);
+  if (!c) {
+    printf("fmi2Instantiate failed\n");
+    return 1;
+  }
+  CHECK(setupExperiment(c, 0, 0, 0, 1, 1))
+  CHECK(enterInitializationMode(c))
+  CHECK(exitInitializationMode(c))
+  eventInfo.newDiscreteStatesNeeded = 1;
+  while (eventInfo.newDiscreteStatesNeeded) {
+    CHECK(newDiscreteStates(c, &eventInfo))
+  }
+  CHECK(enterContinuousTimeMode(c))
+
+  /* reference: every column in a fresh model state, never answered from the cache */
+  for (j=0; j<N; j++) {
+    CHECK(setContinuousStates(c, x, N))
+    CHECK(getDirectionalDerivative(c, derivatives, N, &states[j], 1, &one, &reference[j*N]))
+  }
+  for (i=0; i<N; i++) {
+    for (j=0; j<N; j++) {
+      printf("%s%9.6f", j ? " " : "", reference[i + j*N] + 0.0);
+    }
+    printf("\n");
+  }
+
+  /* column by column in the same model state, filled from the colored evaluation */
+  CHECK(setContinuousStates(c, x, N))
+  for (j=0; j<N; j++) {
+    CHECK(getDirectionalDerivative(c, derivatives, N, &states[j], 1, &one, &cached[j*N]))
+  }
+  res |= compare("unit seeds", reference, cached, N*N);
+
+  /* the same unit seeds with a scaling, the cache is still valid */
+  for (j=0; j<N; j++) {
+    CHECK(getDirectionalDerivative(c, derivatives, N, &states[j], 1, &seed[0], &cached[j*N]))
+    for (i=0; i<N; i++) {
+      cached[i + j*N] /= seed[0];
+    }
+  }
+  res |= compare("scaled seeds", reference, cached, N*N);
+
+  /* an arbitrary seed vector after the cache has been filled */
+  CHECK(getDirectionalDerivative(c, derivatives, N, states, N, seed, combined))
+  for (i=0; i<N; i++) {
+    expected[i] = 0;
+    for (j=0; j<N; j++) {
+      expected[i] += reference[i + j*N] * seed[j];
+    }
+  }
+  res |= compare("seed vector", expected, combined, N);
+
+  /* a scaled seed triggering the evaluation of the cache is not replaced by the colors */
+  CHECK(setContinuousStates(c, x, N))
+  CHECK(getDirectionalDerivative(c, derivatives, N, &states[0], 1, &one, &cached[0]))
+  CHECK(getDirectionalDerivative(c, derivatives, N, &states[1], 1, &seed[1], &cached[N]))
+  for (i=0; i<N; i++) {
+    cached[N+i] /= seed[1];
+  }
+  res |= compare("mixed seeds", reference, cached, 2*N);
+
+  CHECK(setContinuousStates(c, x, N))
+  CHECK(getPartialJacobian(c, derivatives, N, states, N, partial))
+  res |= compare("fmi2GetPartialJacobian", reference, partial, N*N);
+
+  /* the event at time 0.5 sets k = 2 and reinitializes x4 = 3 */
+  CHECK(setContinuousStates(c, x, N))
+  CHECK(setTime(c, 0.6))
+  CHECK(enterEventMode(c))
+  CHECK(getDirectionalDerivative(c, derivatives, N, &states[3], 1, &one, combined))
+  printf("before event: %g\n", combined[3]);
+  eventInfo.newDiscreteStatesNeeded = 1;
+  while (eventInfo.newDiscreteStatesNeeded) {
+    CHECK(newDiscreteStates(c, &eventInfo))
+  }
+  CHECK(getDirectionalDerivative(c, derivatives, N, &states[1], 1, &one, combined))
+  printf("after event: %g", combined[3]);
+  CHECK(getDirectionalDerivative(c, derivatives, N, &states[3], 1, &one, combined))
+  printf(" %g\n", combined[3]);
+
+  freeInstance(c);
+  dlclose(handle);
+  return res;
+}
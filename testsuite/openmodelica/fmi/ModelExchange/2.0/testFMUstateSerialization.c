@@ -0,0 +1,156 @@
+/* Importer for testFMUstateSerialization.mos
+ *
+ * Takes a snapshot of an FMU with a delay buffer, serializes it, moves the
+ * FMU on and restores the deserialized snapshot. Truncated, extended and
+ * corrupted serialized states have to be rejected without changing the FMU.
+ *
+ * usage: testFMUstateSerialization <shared object> <guid>
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "fmi2TestImporter.h"
+
+#define N 2
+
+static int compare(const char *what, const fmi2Real *a, const fmi2Real *b, size_t n)
+{
+  size_t i;
+  double err = 0;
+  for (i=0; i<n; i++) {
+    err = fmax(err, fabs(a[i]-b[i]));
+  }
+  printf("%s: %s\n", what, err == 0 ? "OK" : "MISMATCH");
+  return err == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+  const fmi2Real x1[N] = {1.2, 0.3}, x2[N] = {1.1, 0.4}, x3[N] = {5, 6};
+  fmi2CallbackFunctions callbacks = {logger, calloc, free, NULL, NULL};
+  fmi2EventInfo eventInfo;
+  fmi2Real x[N], der_ref[N], der[N], der_other[N];
+  fmi2Boolean enterEventMode, terminate;
+  fmi2Component c;
+  void *handle, *state = NULL, *restored = NULL, *rejected = NULL;
+  char *buf, *corrupt;
+  size_t size;
+  int res = 0;
+
+  fmi2InstantiateTYPE instantiate;
+  fmi2FreeInstanceTYPE freeInstance;
+  fmi2SetupExperimentTYPE setupExperiment;
+  fmi2ComponentTYPE enterInitializationMode, exitInitializationMode, enterContinuousTimeMode, enterEventModeFn;
+  fmi2NewDiscreteStatesTYPE newDiscreteStates;
+  fmi2SetContinuousStatesTYPE setContinuousStates;
+  fmi2GetContinuousStatesTYPE getContinuousStates;
+  fmi2GetDerivativesTYPE getDerivatives;
+  fmi2SetTimeTYPE setTime;
+  fmi2CompletedIntegratorStepTYPE completedIntegratorStep;
+  fmi2GetFMUstateTYPE getFMUstate;
+  fmi2SetFMUstateTYPE setFMUstate;
+  fmi2FreeFMUstateTYPE freeFMUstate;
+  fmi2SerializedFMUstateSizeTYPE serializedFMUstateSize;
+  fmi2SerializeFMUstateTYPE serializeFMUstate;
+  fmi2DeSerializeFMUstateTYPE deSerializeFMUstate;
+
+  if (argc != 3) {
+    printf("usage: %s <shared object> <guid>\n", argv[0]);
+    return 1;
+  }
+  handle = dlopen(argv[1], RTLD_NOW|RTLD_LOCAL);
+  if (!handle) {
+    printf("%s\n", dlerror());
+    return 1;
+  }
+  instantiate = (fmi2InstantiateTYPE) load(handle, "fmi2Instantiate");
+  freeInstance = (fmi2FreeInstanceTYPE) load(handle, "fmi2FreeInstance");
+  setupExperiment = (fmi2SetupExperimentTYPE) load(handle, "fmi2SetupExperiment");
+  enterInitializationMode = (fmi2ComponentTYPE) load(handle, "fmi2EnterInitializationMode");
+  exitInitializationMode = (fmi2ComponentTYPE) load(handle, "fmi2ExitInitializationMode");
+  enterContinuousTimeMode = (fmi2ComponentTYPE) load(handle, "fmi2EnterContinuousTimeMode");
+  enterEventModeFn = (fmi2ComponentTYPE) load(handle, "fmi2EnterEventMode");
+  newDiscreteStates = (fmi2NewDiscreteStatesTYPE) load(handle, "fmi2NewDiscreteStates");
+  setContinuousStates = (fmi2SetContinuousStatesTYPE) load(handle, "fmi2SetContinuousStates");
+  getContinuousStates = (fmi2GetContinuousStatesTYPE) load(handle, "fmi2GetContinuousStates");
+  getDerivatives = (fmi2GetDerivativesTYPE) load(handle, "fmi2GetDerivatives");
+  setTime = (fmi2SetTimeTYPE) load(handle, "fmi2SetTime");
+  completedIntegratorStep = (fmi2CompletedIntegratorStepTYPE) load(handle, "fmi2CompletedIntegratorStep");
+  getFMUstate = (fmi2GetFMUstateTYPE) load(handle, "fmi2GetFMUstate");
+  setFMUstate = (fmi2SetFMUstateTYPE) load(handle, "fmi2SetFMUstate");
+  freeFMUstate = (fmi2FreeFMUstateTYPE) load(handle, "fmi2FreeFMUstate");
+  serializedFMUstateSize = (fmi2SerializedFMUstateSizeTYPE) load(handle, "fmi2SerializedFMUstateSize");
+  serializeFMUstate = (fmi2SerializeFMUstateTYPE) load(handle, "fmi2SerializeFMUstate");
+  deSerializeFMUstate = (fmi2DeSerializeFMUstateTYPE) load(handle, "fmi2DeSerializeFMUstate");
+
+  c = instantiate("StateRoundTrip", fmi2ModelExchange, argv[2], "", &callbacks, 0, 0);
+  if (!c) {
+    printf("fmi2Instantiate failed\n");
+    return 1;
+  }
+  CHECK(setupExperiment(c, 0, 0, 0, 1, 1))
+  CHECK(enterInitializationMode(c))
+  CHECK(exitInitializationMode(c))
+  eventInfo.newDiscreteStatesNeeded = 1;
+  while (eventInfo.newDiscreteStatesNeeded) {
+    CHECK(newDiscreteStates(c, &eventInfo))
+  }
+  CHECK(enterContinuousTimeMode(c))
+
+  /* fill the delay buffer */
+  CHECK(setTime(c, 0.05))
+  CHECK(setContinuousStates(c, x1, N))
+  CHECK(completedIntegratorStep(c, 1, &enterEventMode, &terminate))
+  CHECK(setTime(c, 0.1))
+  CHECK(setContinuousStates(c, x2, N))
+  CHECK(completedIntegratorStep(c, 1, &enterEventMode, &terminate))
+
+  /* snapshot in event mode */
+  CHECK(enterEventModeFn(c))
+  CHECK(getDerivatives(c, der_ref, N))
+  CHECK(getFMUstate(c, &state))
+  CHECK(serializedFMUstateSize(c, state, &size))
+  buf = (char*) malloc(size + sizeof(int));
+  corrupt = (char*) malloc(size + sizeof(int));
+  CHECK(serializeFMUstate(c, state, buf, size))
+  CHECK(freeFMUstate(c, &state))
+
+  /* move on */
+  eventInfo.newDiscreteStatesNeeded = 1;
+  while (eventInfo.newDiscreteStatesNeeded) {
+    CHECK(newDiscreteStates(c, &eventInfo))
+  }
+  CHECK(enterContinuousTimeMode(c))
+  CHECK(setTime(c, 0.2))
+  CHECK(setContinuousStates(c, x3, N))
+  CHECK(completedIntegratorStep(c, 1, &enterEventMode, &terminate))
+  CHECK(getDerivatives(c, der_other, N))
+  printf("derivatives changed: %s\n", der_other[0] != der_ref[0] || der_other[1] != der_ref[1] ? "yes" : "no");
+  CHECK(enterEventModeFn(c))
+
+  /* corrupted serialized states are rejected */
+  printf("truncated: %s\n", deSerializeFMUstate(c, buf, size - 1, &rejected) == fmi2OK ? "accepted" : "rejected");
+  memcpy(corrupt, buf, size);
+  memset(corrupt + size, 0, sizeof(int));
+  printf("trailing bytes: %s\n", deSerializeFMUstate(c, corrupt, size + sizeof(int), &rejected) == fmi2OK ? "accepted" : "rejected");
+  corrupt[0] ^= 0x5a;
+  printf("wrong header: %s\n", deSerializeFMUstate(c, corrupt, size, &rejected) == fmi2OK ? "accepted" : "rejected");
+  CHECK(getDerivatives(c, der, N))
+  res |= compare("state kept", der_other, der, N);
+
+  /* round trip */
+  CHECK(deSerializeFMUstate(c, buf, size, &restored))
+  CHECK(setFMUstate(c, restored))
+  CHECK(freeFMUstate(c, &restored))
+  CHECK(getContinuousStates(c, x, N))
+  res |= compare("states restored", x2, x, N);
+  CHECK(getDerivatives(c, der, N))
+  res |= compare("derivatives restored", der_ref, der, N);
+
+  free(buf);
+  free(corrupt);
+  freeInstance(c);
+  dlclose(handle);
+  return res;
+}
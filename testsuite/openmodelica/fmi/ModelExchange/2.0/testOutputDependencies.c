@@ -0,0 +1,136 @@
+/* Importer for testOutputDependencies.mos
+ *
+ * Sets one input at a time and reads the outputs depending on it and the
+ * ones that do not, in both orders, and after advancing the time. The
+ * outputs have to be correct whether fmi2GetReal skipped the evaluation or
+ * not.
+ *
+ * usage: testOutputDependencies <shared object> <guid>
+ */
+
+#include <string.h>
+
+#include "fmi2TestImporter.h"
+
+/* Looks up the value reference of a variable in modelDescription.xml */
+static fmi2ValueReference valueReference(const char *name)
+{
+  static char xml[65536];
+  char pattern[64];
+  const char *var, *ref;
+  size_t n;
+  FILE *file;
+
+  if (!xml[0]) {
+    file = fopen("modelDescription.xml", "r");
+    if (!file) {
+      printf("no modelDescription.xml\n");
+      exit(1);
+    }
+    n = fread(xml, 1, sizeof(xml) - 1, file);
+    xml[n] = '\0';
+    fclose(file);
+  }
+  snprintf(pattern, sizeof(pattern), "name=\"%s\"", name);
+  var = strstr(xml, pattern);
+  ref = var ? strstr(var, "valueReference=\"") : NULL;
+  if (!ref) {
+    printf("no value reference for %s\n", name);
+    exit(1);
+  }
+  return (fmi2ValueReference) strtoul(ref + strlen("valueReference=\""), NULL, 10);
+}
+
+int main(int argc, char **argv)
+{
+  fmi2CallbackFunctions callbacks = {logger, calloc, free, NULL, NULL};
+  fmi2EventInfo eventInfo;
+  fmi2ValueReference u1, u2, y[3];
+  fmi2Real value, out[3];
+  fmi2Component c;
+  void *handle;
+
+  fmi2InstantiateTYPE instantiate;
+  fmi2FreeInstanceTYPE freeInstance;
+  fmi2SetupExperimentTYPE setupExperiment;
+  fmi2ComponentTYPE enterInitializationMode, exitInitializationMode, enterContinuousTimeMode;
+  fmi2NewDiscreteStatesTYPE newDiscreteStates;
+  fmi2SetTimeTYPE setTime;
+  fmi2GetRealTYPE getReal;
+  fmi2SetRealTYPE setReal;
+
+  if (argc != 3) {
+    printf("usage: %s <shared object> <guid>\n", argv[0]);
+    return 1;
+  }
+  handle = dlopen(argv[1], RTLD_NOW|RTLD_LOCAL);
+  if (!handle) {
+    printf("%s\n", dlerror());
+    return 1;
+  }
+  instantiate = (fmi2InstantiateTYPE) load(handle, "fmi2Instantiate");
+  freeInstance = (fmi2FreeInstanceTYPE) load(handle, "fmi2FreeInstance");
+  setupExperiment = (fmi2SetupExperimentTYPE) load(handle, "fmi2SetupExperiment");
+  enterInitializationMode = (fmi2ComponentTYPE) load(handle, "fmi2EnterInitializationMode");
+  exitInitializationMode = (fmi2ComponentTYPE) load(handle, "fmi2ExitInitializationMode");
+  enterContinuousTimeMode = (fmi2ComponentTYPE) load(handle, "fmi2EnterContinuousTimeMode");
+  newDiscreteStates = (fmi2NewDiscreteStatesTYPE) load(handle, "fmi2NewDiscreteStates");
+  setTime = (fmi2SetTimeTYPE) load(handle, "fmi2SetTime");
+  getReal = (fmi2GetRealTYPE) load(handle, "fmi2GetReal");
+  setReal = (fmi2SetRealTYPE) load(handle, "fmi2SetReal");
+
+  u1 = valueReference("u1");
+  u2 = valueReference("u2");
+  y[0] = valueReference("y1");
+  y[1] = valueReference("y2");
+  y[2] = valueReference("y3");
+
+  c = instantiate("OutputDeps", fmi2ModelExchange, argv[2], "", &callbacks, 0, 0);
+  if (!c) {
+    printf("fmi2Instantiate failed\n");
+    return 1;
+  }
+  CHECK(setupExperiment(c, 0, 0, 0, 1, 1))
+  CHECK(enterInitializationMode(c))
+  CHECK(exitInitializationMode(c))
+  eventInfo.newDiscreteStatesNeeded = 1;
+  while (eventInfo.newDiscreteStatesNeeded) {
+    CHECK(newDiscreteStates(c, &eventInfo))
+  }
+  CHECK(enterContinuousTimeMode(c))
+  CHECK(getReal(c, y, 3, out))
+  printf("initial: y1 = %g, y2 = %g, y3 = %g\n", out[0], out[1], out[2]);
+
+  /* y2 does not depend on u1, read it before and after the dependent outputs */
+  value = 5;
+  CHECK(setReal(c, &u1, 1, &value))
+  CHECK(getReal(c, &y[1], 1, &out[1]))
+  CHECK(getReal(c, &y[0], 1, &out[0]))
+  CHECK(getReal(c, &y[2], 1, &out[2]))
+  printf("u1 = 5: y1 = %g, y2 = %g, y3 = %g\n", out[0], out[1], out[2]);
+
+  /* y1 and y3 do not depend on u2 */
+  value = 4;
+  CHECK(setReal(c, &u2, 1, &value))
+  CHECK(getReal(c, &y[0], 1, &out[0]))
+  CHECK(getReal(c, &y[2], 1, &out[2]))
+  CHECK(getReal(c, &y[1], 1, &out[1]))
+  printf("u2 = 4: y1 = %g, y2 = %g, y3 = %g\n", out[0], out[1], out[2]);
+
+  /* the time is no input, all outputs are evaluated again */
+  CHECK(setTime(c, 0.5))
+  CHECK(getReal(c, &y[0], 1, &out[0]))
+  CHECK(getReal(c, &y[2], 1, &out[2]))
+  CHECK(getReal(c, &y[1], 1, &out[1]))
+  printf("time = 0.5: y1 = %g, y2 = %g, y3 = %g\n", out[0], out[1], out[2]);
+
+  /* a clean and a dirty output in one call */
+  value = 1;
+  CHECK(setReal(c, &u2, 1, &value))
+  CHECK(getReal(c, y, 3, out))
+  printf("u2 = 1: y1 = %g, y2 = %g, y3 = %g\n", out[0], out[1], out[2]);
+
+  freeInstance(c);
+  dlclose(handle);
+  return 0;
+}